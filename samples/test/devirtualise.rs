@@ -0,0 +1,49 @@
+// Calls through trait objects, with and without a statically known concrete type
+// - The known cases are turned into direct calls by the MIR optimiser, the ambiguous ones must stay virtual
+
+trait Named { fn id(&self) -> u32; fn twice(&self) -> u32 { self.id() + self.id() } }
+trait Shape: Named { fn area(&self) -> u32; fn scale(&mut self, k: u32); }
+
+struct Sq(u32);
+struct Rect(u32, u32);
+impl Named for Sq { fn id(&self) -> u32 { 1 } }
+impl Named for Rect { fn id(&self) -> u32 { 2 } }
+impl Shape for Sq { fn area(&self) -> u32 { self.0 * self.0 } fn scale(&mut self, k: u32) { self.0 *= k; } }
+impl Shape for Rect { fn area(&self) -> u32 { self.0 * self.1 } fn scale(&mut self, k: u32) { self.0 *= k; } }
+
+#[test]
+fn known_concrete()
+{
+    let mut a = Sq(3);
+    {
+        let m: &mut Shape = &mut a;
+        m.scale(2);
+    }
+    let s: &Shape = &a;
+    assert_eq!(s.area(), 36);
+    // Supertrait and default methods
+    assert_eq!(s.id(), 1);
+    assert_eq!(s.twice(), 2);
+}
+
+#[test]
+fn ambiguous_origin()
+{
+    let a = Sq(3);
+    let b = Rect(2, 5);
+    // The object's type depends on a runtime value, so the calls must go through the vtable
+    let mut seen = Vec::new();
+    for &use_a in [true, false].iter()
+    {
+        let s: &Shape = if use_a { &a } else { &b };
+        seen.push( (s.id(), s.area()) );
+    }
+    assert_eq!(seen, [(1, 9), (2, 10)]);
+}
+
+#[test]
+fn boxed()
+{
+    let v: Vec<Box<Shape>> = vec![Box::new(Sq(2)), Box::new(Rect(3, 4))];
+    assert_eq!(v.iter().map(|s| s.area()).sum::<u32>(), 16);
+}
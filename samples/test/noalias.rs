@@ -0,0 +1,45 @@
+// Pointer arguments that can alias, the C backend must not mark these `restrict`
+// - `&T` is only `restrict` when `T` has no interior mutability (`UnsafeCell`)
+use std::cell::Cell;
+
+struct Pair(u32, u32);
+struct Wrap(Cell<u32>);
+
+#[inline(never)]
+fn read_shared(a: &Pair, b: &Pair) -> u32 { a.0 + b.1 }
+#[inline(never)]
+fn write_unique(a: &mut Pair, b: &Pair) -> u32 { a.0 = b.1 + 1; a.0 + b.1 }
+#[inline(never)]
+fn cell_alias(a: &Cell<u32>, b: &Cell<u32>) -> u32 { a.set(5); b.set(7); a.get() }
+#[inline(never)]
+fn wrap_alias(a: &Wrap, b: &Wrap) -> u32 { a.0.set(1); b.0.set(2); a.0.get() }
+#[inline(never)]
+fn raw_alias(a: *mut Pair, b: *mut Pair) -> u32 { unsafe { (*b).0 = 3; (*a).0 = 4; (*b).0 } }
+
+#[test]
+fn shared_freeze()
+{
+    // Two `&T` to the same data are fine as `restrict`, neither can write
+    let p = Pair(2, 3);
+    assert_eq!(read_shared(&p, &p), 5);
+    let mut p = Pair(2, 3);
+    let q = Pair(4, 5);
+    assert_eq!(write_unique(&mut p, &q), 11);
+}
+
+#[test]
+fn shared_interior_mutable()
+{
+    let c = Cell::new(0);
+    assert_eq!(cell_alias(&c, &c), 7);
+    let w = Wrap(Cell::new(0));
+    assert_eq!(wrap_alias(&w, &w), 2);
+}
+
+#[test]
+fn raw_pointer()
+{
+    let mut p = Pair(0, 0);
+    let a = &mut p as *mut Pair;
+    assert_eq!(raw_alias(a, a), 4);
+}
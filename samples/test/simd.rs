@@ -0,0 +1,101 @@
+#![feature(repr_simd, platform_intrinsics)]
+#![allow(non_camel_case_types)]
+
+#[repr(simd)]
+#[derive(Copy,Clone)]
+struct u32x4(u32, u32, u32, u32);
+#[repr(simd)]
+#[derive(Copy,Clone)]
+struct i32x4(i32, i32, i32, i32);
+#[repr(simd)]
+#[derive(Copy,Clone)]
+struct i8x16(i8,i8,i8,i8, i8,i8,i8,i8, i8,i8,i8,i8, i8,i8,i8,i8);
+#[repr(simd)]
+#[derive(Copy,Clone)]
+struct i32x8(i32, i32, i32, i32, i32, i32, i32, i32);
+
+extern "platform-intrinsic" {
+    fn simd_add<T>(a: T, b: T) -> T;
+    fn simd_mul<T>(a: T, b: T) -> T;
+    fn simd_eq<T, U>(a: T, b: T) -> U;
+    fn simd_lt<T, U>(a: T, b: T) -> U;
+    fn simd_extract<T, E>(a: T, i: u32) -> E;
+    fn simd_insert<T, E>(a: T, i: u32, v: E) -> T;
+    fn simd_shuffle4<T, U>(a: T, b: T, idx: [u32; 4]) -> U;
+}
+#[cfg(any(target_arch="x86", target_arch="x86_64"))]
+extern "platform-intrinsic" {
+    fn x86_mm_movemask_epi8(a: i8x16) -> i32;
+    // AVX2 - Lowered to vector operations when `avx2` isn't enabled
+    fn x86_mm256_add_epi32(a: i32x8, b: i32x8) -> i32x8;
+    fn x86_mm256_max_epi32(a: i32x8, b: i32x8) -> i32x8;
+}
+
+fn lanes(v: u32x4) -> [u32; 4] {
+    unsafe { [simd_extract(v, 0), simd_extract(v, 1), simd_extract(v, 2), simd_extract(v, 3)] }
+}
+fn mask_lanes(v: i32x4) -> [i32; 4] {
+    unsafe { [simd_extract(v, 0), simd_extract(v, 1), simd_extract(v, 2), simd_extract(v, 3)] }
+}
+
+#[test]
+fn arithmetic()
+{
+    let a = u32x4(1, 2, 3, 4);
+    let b = u32x4(10, 20, 30, 40);
+    let c: u32x4 = unsafe { simd_mul(simd_add(a, b), u32x4(2, 2, 2, 2)) };
+    assert_eq!(lanes(c), [22, 44, 66, 88]);
+    let d: u32x4 = unsafe { simd_insert(c, 1, 5u32) };
+    assert_eq!(lanes(d), [22, 5, 66, 88]);
+}
+
+#[test]
+fn comparison_masks()
+{
+    let a = u32x4(1, 20, 3, 40);
+    let b = u32x4(1, 2, 30, 40);
+    let eq: i32x4 = unsafe { simd_eq(a, b) };
+    assert_eq!(mask_lanes(eq), [-1, 0, 0, -1]);
+    let lt: i32x4 = unsafe { simd_lt(a, b) };
+    assert_eq!(mask_lanes(lt), [0, 0, -1, 0]);
+}
+
+trait ShuffleIdx { const IDX: [u32; 4]; }
+struct Interleave;
+impl ShuffleIdx for Interleave { const IDX: [u32; 4] = [0, 4, 1, 5]; }
+fn shuffle_with<T: ShuffleIdx>(a: u32x4, b: u32x4) -> u32x4 {
+    unsafe { simd_shuffle4(a, b, T::IDX) }
+}
+
+#[test]
+fn shuffle()
+{
+    let a = u32x4(1, 2, 3, 4);
+    let b = u32x4(10, 20, 30, 40);
+    let d: u32x4 = unsafe { simd_shuffle4(a, b, [3, 4, 0, 7]) };
+    assert_eq!(lanes(d), [4, 10, 1, 40]);
+    // Indexes from a constant (not an array variable)
+    assert_eq!(lanes(shuffle_with::<Interleave>(a, b)), [1, 10, 2, 20]);
+}
+
+#[cfg(any(target_arch="x86", target_arch="x86_64"))]
+#[test]
+fn x86_movemask()
+{
+    let v = i8x16(-128,0,-128,0, 0,0,0,0, 0,0,0,0, 0,0,0,-128);
+    assert_eq!(unsafe { x86_mm_movemask_epi8(v) }, 0x8005);
+}
+
+#[cfg(any(target_arch="x86", target_arch="x86_64"))]
+#[test]
+fn x86_avx2_lanewise()
+{
+    let a = i32x8(1, -2, 3, -4, 5, -6, 7, -8);
+    let b = i32x8(-1, 2, -3, 4, -5, 6, -7, 8);
+    let s: i32x8 = unsafe { x86_mm256_add_epi32(a, b) };
+    let m: i32x8 = unsafe { x86_mm256_max_epi32(a, b) };
+    let s0: i32 = unsafe { simd_extract(s, 7) };
+    let m0: i32 = unsafe { simd_extract(m, 0) };
+    let m1: i32 = unsafe { simd_extract(m, 1) };
+    assert_eq!((s0, m0, m1), (0, 1, 2));
+}
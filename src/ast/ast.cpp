@@ -8,6 +8,7 @@
 #include <iostream>
 #include "../parse/parseerror.hpp"
 #include <algorithm>
+#include <unordered_set>
 #include <serialiser_texttree.hpp>
 
 namespace AST {
@@ -321,6 +322,116 @@ void Module::add_macro_import(::std::string name, const MacroRules& mr) {
     m_macro_import_res.push_back( NamedNS<const MacroRules*>( mv$(name), &mr, false ) );
 }
 
+Module::IndexMap& Module::GlobIndex::get(IndexName loc) {
+    switch(loc)
+    {
+    case IndexName::Namespace:  return namespace_items;
+    case IndexName::Type:       return type_items;
+    case IndexName::Value:      return value_items;
+    }
+    throw "";
+}
+const Module::IndexMap& Module::GlobIndex::get(IndexName loc) const {
+    return const_cast<GlobIndex*>(this)->get(loc);
+}
+Module::IndexMap& Module::get_index(IndexName loc) {
+    switch(loc)
+    {
+    case IndexName::Namespace:  return m_namespace_items;
+    case IndexName::Type:       return m_type_items;
+    case IndexName::Value:      return m_value_items;
+    }
+    throw "";
+}
+const Module::IndexMap& Module::get_index(IndexName loc) const {
+    return const_cast<Module*>(this)->get_index(loc);
+}
+
+namespace {
+    // Search the glob imports of `mod` (in order, depth-first through local modules) for `name`
+    // - `stack` prevents infinite recursion on mutually glob-importing modules
+    Module::IndexRef find_in_globs(const Module& mod, Module::IndexName loc, const ::std::string& name, bool is_pub, ::std::vector<const Module*>& stack)
+    {
+        Module::IndexRef    rv;
+        if( ::std::find(stack.begin(), stack.end(), &mod) != stack.end() )
+            return rv;
+        stack.push_back(&mod);
+        for(const auto& gi : mod.m_glob_imports)
+        {
+            bool gi_pub = is_pub && gi.is_pub;
+            const auto& list = (gi.index ? gi.index->get(loc) : gi.module->get_index(loc));
+            auto it = list.find(name);
+            if( it != list.end() ) {
+                rv.ent = &it->second;
+                rv.is_pub = it->second.is_pub && gi_pub;
+                rv.is_import = true;
+                break;
+            }
+            if( gi.module ) {
+                rv = find_in_globs(*gi.module, loc, name, gi_pub, stack);
+                if( rv )
+                    break;
+            }
+        }
+        stack.pop_back();
+        return rv;
+    }
+    void visit_glob_items(const Module& mod, Module::IndexName loc, bool is_pub, ::std::vector<const Module*>& stack, ::std::unordered_set< ::std::string>& seen,
+            ::std::function<void(const ::std::string&, const Module::IndexRef&)>& cb)
+    {
+        if( ::std::find(stack.begin(), stack.end(), &mod) != stack.end() )
+            return ;
+        stack.push_back(&mod);
+        for(const auto& gi : mod.m_glob_imports)
+        {
+            bool gi_pub = is_pub && gi.is_pub;
+            const auto& list = (gi.index ? gi.index->get(loc) : gi.module->get_index(loc));
+            for(const auto& e : list)
+            {
+                if( seen.insert(e.first).second )
+                {
+                    Module::IndexRef    r;
+                    r.ent = &e.second;
+                    r.is_pub = e.second.is_pub && gi_pub;
+                    r.is_import = true;
+                    cb(e.first, r);
+                }
+            }
+            if( gi.module ) {
+                visit_glob_items(*gi.module, loc, gi_pub, stack, seen, cb);
+            }
+        }
+        stack.pop_back();
+    }
+}
+Module::IndexRef Module::find_index_ent(IndexName loc, const ::std::string& name) const
+{
+    const auto& list = this->get_index(loc);
+    auto it = list.find(name);
+    if( it != list.end() )
+    {
+        IndexRef    rv;
+        rv.ent = &it->second;
+        rv.is_pub = it->second.is_pub;
+        rv.is_import = it->second.is_import;
+        return rv;
+    }
+    if( m_glob_imports.empty() )
+        return IndexRef();
+    ::std::vector<const Module*>    stack;
+    return find_in_globs(*this, loc, name, true, stack);
+}
+void Module::iterate_glob_items(IndexName loc, ::std::function<void(const ::std::string&, const IndexRef&)> cb) const
+{
+    if( m_glob_imports.empty() )
+        return ;
+    ::std::unordered_set< ::std::string>    seen;
+    for(const auto& e : this->get_index(loc))
+        seen.insert(e.first);
+    ::std::vector<const Module*>    stack;
+    visit_glob_items(*this, loc, true, stack, seen, cb);
+}
+
 Item Item::clone() const
 {
     TU_MATCHA( (*this), (e),
@@ -522,17 +522,52 @@ public:
     FileInfo    m_file_info;
 
     bool    m_insert_prelude = true;    // Set to false by `#[no_prelude]` handler
-    char    m_index_populated = 0;  // 0 = no, 1 = partial, 2 = complete
     struct IndexEnt {
         bool is_pub;    // Used as part of glob import checking
         bool is_import; // Set if this item has a path that isn't `mod->path() + name`
         ::AST::Path path;
     };
+    typedef ::std::unordered_map< ::std::string, IndexEnt > IndexMap;
+    enum class IndexName {
+        Namespace,
+        Type,
+        Value,
+    };
 
     // TODO: Document difference between namespace and Type
-    ::std::unordered_map< ::std::string, IndexEnt >    m_namespace_items;
-    ::std::unordered_map< ::std::string, IndexEnt >    m_type_items;
-    ::std::unordered_map< ::std::string, IndexEnt >    m_value_items;
+    IndexMap    m_namespace_items;
+    IndexMap    m_type_items;
+    IndexMap    m_value_items;
+
+    /// Index of the items made visible by a glob import of an enum or an extern crate's module.
+    /// Shared between all modules that glob-import the same source.
+    struct GlobIndex {
+        IndexMap    namespace_items;
+        IndexMap    type_items;
+        IndexMap    value_items;
+
+        IndexMap& get(IndexName loc);
+        const IndexMap& get(IndexName loc) const;
+    };
+    struct GlobImport {
+        bool    is_pub;
+        /// Shared index (enums and HIR modules)
+        ::std::shared_ptr<GlobIndex>    index;
+        /// Local module (its own index is consulted, including any globs it has)
+        const Module*   module;
+    };
+    /// Glob imports, in definition order (consulted after the above maps, earlier globs shadow later ones)
+    ::std::vector<GlobImport>   m_glob_imports;
+
+    /// Result of an index lookup
+    struct IndexRef {
+        const IndexEnt* ent = nullptr;
+        bool is_pub = false;
+        bool is_import = false; // Always set if found via a glob
+
+        operator bool() const { return ent != nullptr; }
+        const IndexEnt* operator->() const { return ent; }
+    };
 
 public:
     Module() {}
@@ -572,6 +607,13 @@ public:
     const NamedList<MacroRulesPtr>&    macros()  const { return m_macros; }
     const ::std::vector<NamedNS<const MacroRules*> >  macro_imports_res() const { return m_macro_import_res; }
 
+          IndexMap& get_index(IndexName loc);
+    const IndexMap& get_index(IndexName loc) const;
+    /// Look up a name in this module's index, falling back to glob imports
+    IndexRef find_index_ent(IndexName loc, const ::std::string& name) const;
+    /// Enumerate the names visible only via glob imports (skipping those shadowed by an item or earlier glob)
+    void iterate_glob_items(IndexName loc, ::std::function<void(const ::std::string&, const IndexRef&)> cb) const;
+
 private:
     void resolve_macro_import(const Crate& crate, const ::std::string& modname, const ::std::string& macro_name);
 };
@@ -24,11 +24,13 @@ class RustPrinter:
     ::std::ostream& m_os;
     int m_indent_level;
     bool m_expr_root;   //!< used to allow 'if' and 'match' to behave differently as standalone exprs
+    const ::std::string& m_item_filter; //!< Only dump items with a path containing this string (if non-empty)
 public:
-    RustPrinter(::std::ostream& os):
+    RustPrinter(::std::ostream& os, const ::std::string& item_filter):
         m_os(os),
         m_indent_level(0),
-        m_expr_root(false)
+        m_expr_root(false),
+        m_item_filter(item_filter)
     {}
 
     void handle_module(const AST::Module& mod);
@@ -570,12 +572,17 @@ private:
     void inc_indent();
     RepeatLitStr indent();
     void dec_indent();
+
+    bool filter_item(const AST::Module& mod, const ::std::string& name) const {
+        if( m_item_filter == "" )
+            return true;
+        return FMT(mod.path() << "::" << name).find(m_item_filter) != ::std::string::npos;
+    }
 };
 
-void Dump_Rust(const char *filename, const AST::Crate& crate)
+void Dump_Rust(::std::ostream& os, const AST::Crate& crate, const ::std::string& item_filter)
 {
-    ::std::ofstream os(filename);
-    RustPrinter printer(os);
+    RustPrinter printer(os, item_filter);
     printer.handle_module(crate.root_module());
 }
 
@@ -652,6 +659,7 @@ void RustPrinter::handle_module(const AST::Module& mod)
     {
         if( !item.data.is_Type() )    continue ;
         const auto& e = item.data.as_Type();
+        if( !filter_item(mod, item.name) )  continue ;
 
         if(need_nl) {
             m_os << "\n";
@@ -670,6 +678,7 @@ void RustPrinter::handle_module(const AST::Module& mod)
     {
         if( !item.data.is_Struct() )    continue ;
         const auto& e = item.data.as_Struct();
+        if( !filter_item(mod, item.name) )  continue ;
 
         m_os << "\n";
         print_attrs(item.data.attrs);
@@ -681,6 +690,7 @@ void RustPrinter::handle_module(const AST::Module& mod)
     {
         if( !item.data.is_Enum() )    continue ;
         const auto& e = item.data.as_Enum();
+        if( !filter_item(mod, item.name) )  continue ;
 
         m_os << "\n";
         print_attrs(item.data.attrs);
@@ -692,6 +702,7 @@ void RustPrinter::handle_module(const AST::Module& mod)
     {
         if( !item.data.is_Trait() )    continue ;
         const auto& e = item.data.as_Trait();
+        if( !filter_item(mod, item.name) )  continue ;
 
         m_os << "\n";
         print_attrs(item.data.attrs);
@@ -703,6 +714,7 @@ void RustPrinter::handle_module(const AST::Module& mod)
     {
         if( !item.data.is_Static() )    continue ;
         const auto& e = item.data.as_Static();
+        if( !filter_item(mod, item.name) )  continue ;
 
         if(need_nl) {
             m_os << "\n";
@@ -725,6 +737,7 @@ void RustPrinter::handle_module(const AST::Module& mod)
     {
         if( !item.data.is_Function() )    continue ;
         const auto& e = item.data.as_Function();
+        if( !filter_item(mod, item.name) )  continue ;
 
         m_os << "\n";
         print_attrs(item.data.attrs);
@@ -735,6 +748,7 @@ void RustPrinter::handle_module(const AST::Module& mod)
     {
         if( !item.data.is_Impl() )    continue ;
         const auto& i = item.data.as_Impl();
+        if( m_item_filter != "" && FMT(i.def()).find(m_item_filter) == ::std::string::npos )  continue ;
 
         m_os << "\n";
         m_os << indent() << "impl";
@@ -16,6 +16,7 @@
 #include "types.hpp"
 #include "pattern.hpp"
 #include "attrs.hpp"
+#include <node_pool.hpp>
 
 namespace AST {
 
@@ -28,6 +29,7 @@ class ExprNode
     MetaItems   m_attrs;
     Span    m_span;
 public:
+    NODE_POOL_ALLOCATED()
     virtual ~ExprNode() = 0;
 
     virtual void visit(NodeVisitor& nv) = 0;
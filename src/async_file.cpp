@@ -0,0 +1,123 @@
+/*
+ * MRustC - Rust Compiler
+ * - By John Hodge (Mutabah/thePowersGang)
+ *
+ * async_file.cpp
+ * - Buffered output file written by a background thread (used for debug dumps)
+ */
+#include <async_file.hpp>
+#include <fstream>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+class AsyncOutputFile::Buffer:
+    public ::std::streambuf
+{
+    static const size_t CHUNK_SIZE = 256*1024;
+    /// Maximum number of chunks waiting to be written, the producer blocks once this is reached (bounds memory use
+    /// when rendering outpaces the disk)
+    static const size_t MAX_QUEUED = 16;
+
+    ::std::ofstream m_file;
+
+    /// Chunk currently being filled by the producer
+    ::std::vector<char> m_cur;
+
+    ::std::mutex    m_lock;
+    ::std::condition_variable   m_cv;
+    /// Signalled by the worker when it takes a chunk off the queue
+    ::std::condition_variable   m_cv_space;
+    ::std::deque< ::std::vector<char> > m_queue;
+    bool    m_done = false;
+
+    ::std::thread   m_worker;
+public:
+    Buffer(const ::std::string& path):
+        m_file(path, ::std::ios::binary)
+    {
+        reset_buffer();
+        m_worker = ::std::thread([this](){ this->worker(); });
+    }
+    ~Buffer()
+    {
+        push_chunk();
+        {
+            ::std::lock_guard< ::std::mutex>    lh { m_lock };
+            m_done = true;
+        }
+        m_cv.notify_one();
+        m_worker.join();
+    }
+
+protected:
+    int_type overflow(int_type ch) override
+    {
+        push_chunk();
+        if( ch != traits_type::eof() ) {
+            *pptr() = traits_type::to_char_type(ch);
+            pbump(1);
+        }
+        return traits_type::not_eof(ch);
+    }
+    int sync() override
+    {
+        push_chunk();
+        return 0;
+    }
+
+private:
+    void reset_buffer()
+    {
+        m_cur.resize(CHUNK_SIZE);
+        setp(m_cur.data(), m_cur.data() + m_cur.size());
+    }
+    // Hand the current chunk to the writer thread
+    void push_chunk()
+    {
+        size_t len = pptr() - pbase();
+        if( len == 0 )
+            return ;
+        m_cur.resize(len);
+        {
+            ::std::unique_lock< ::std::mutex>   lh { m_lock };
+            m_cv_space.wait(lh, [&](){ return m_queue.size() < MAX_QUEUED; });
+            m_queue.push_back( ::std::move(m_cur) );
+        }
+        m_cv.notify_one();
+        m_cur = ::std::vector<char>();
+        reset_buffer();
+    }
+
+    void worker()
+    {
+        ::std::unique_lock< ::std::mutex>   lh { m_lock };
+        for(;;)
+        {
+            m_cv.wait(lh, [&](){ return m_done || !m_queue.empty(); });
+            if( m_queue.empty() )
+                break;
+            auto chunk = ::std::move(m_queue.front());
+            m_queue.pop_front();
+
+            lh.unlock();
+            m_cv_space.notify_one();
+            m_file.write(chunk.data(), chunk.size());
+            lh.lock();
+        }
+    }
+};
+
+AsyncOutputFile::AsyncOutputFile(const ::std::string& path):
+    ::std::ostream(nullptr),
+    m_buf( new Buffer(path) )
+{
+    this->rdbuf(m_buf.get());
+}
+AsyncOutputFile::~AsyncOutputFile()
+{
+    // Flushes and joins the writer thread
+    m_buf.reset();
+}
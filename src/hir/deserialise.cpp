@@ -534,6 +534,8 @@ namespace {
             ::HIR::Function rv {
                 false,
                 deserialise_linkage(),
+                static_cast< ::HIR::Function::InlineHint>( m_in.read_tag() ),
+                m_in.read_bool(),
                 static_cast< ::HIR::Function::Receiver>( m_in.read_tag() ),
                 m_in.read_string(),
                 m_in.read_bool(),
@@ -571,12 +573,19 @@ namespace {
         {
             TRACE_FUNCTION;
 
+            auto linkage = deserialise_linkage();
+            auto is_mut = m_in.read_bool();
+            auto ty = deserialise_type();
+            ::HIR::Literal  value_res;
+            if( m_in.read_bool() ) {
+                value_res = deserialise_literal();
+            }
             return ::HIR::Static {
-                deserialise_linkage(),
-                m_in.read_bool(),
-                deserialise_type(),
+                mv$(linkage),
+                is_mut,
+                mv$(ty),
                 ::HIR::ExprPtr {},
-                {}
+                mv$(value_res)
                 };
         }
 
@@ -1165,6 +1174,7 @@ namespace {
 
         rv.m_ext_libs = deserialise_vec< ::HIR::ExternLibrary>();
         rv.m_link_paths = deserialise_vec< ::std::string>();
+        rv.m_is_mir_only = m_in.read_bool();
 
         return rv;
     }
@@ -19,11 +19,13 @@ namespace {
     {
         ::std::ostream& m_os;
         unsigned int    m_indent_level;
+        const ::std::string&    m_item_filter;
 
     public:
-        TreeVisitor(::std::ostream& os):
+        TreeVisitor(::std::ostream& os, const ::std::string& item_filter):
             m_os(os),
-            m_indent_level(0)
+            m_indent_level(0),
+            m_item_filter(item_filter)
         {
         }
 
@@ -47,6 +49,8 @@ namespace {
 
         void visit_type_impl(::HIR::TypeImpl& impl) override
         {
+            ::HIR::ItemPath    ip { impl.m_type };
+            if( !filter_item(ip) && !filter_any(ip, impl.m_methods) && !filter_any(ip, impl.m_constants) )   return ;
             m_os << indent() << "impl" << impl.m_params.fmt_args() << " " << impl.m_type << "\n";
             if( ! impl.m_params.m_bounds.empty() )
             {
@@ -60,6 +64,8 @@ namespace {
         }
         virtual void visit_trait_impl(const ::HIR::SimplePath& trait_path, ::HIR::TraitImpl& impl) override
         {
+            ::HIR::ItemPath    ip { impl.m_type, trait_path, impl.m_trait_args };
+            if( !filter_item(ip) && !filter_any(ip, impl.m_methods) && !filter_any(ip, impl.m_constants) && !filter_any(ip, impl.m_statics) )   return ;
             m_os << indent() << "impl" << impl.m_params.fmt_args() << " " << trait_path << impl.m_trait_args << " for " << impl.m_type << "\n";
             if( ! impl.m_params.m_bounds.empty() )
             {
@@ -73,6 +79,7 @@ namespace {
         }
         void visit_marker_impl(const ::HIR::SimplePath& trait_path, ::HIR::MarkerImpl& impl) override
         {
+            if( !filter_item(::HIR::ItemPath(impl.m_type, trait_path, impl.m_trait_args)) )   return ;
             m_os << indent() << "impl" << impl.m_params.fmt_args() << " " << (impl.is_positive ? "" : "!") << trait_path << impl.m_trait_args << " for " << impl.m_type << "\n";
             if( ! impl.m_params.m_bounds.empty() )
             {
@@ -84,6 +91,7 @@ namespace {
         // - Type Items
         void visit_type_alias(::HIR::ItemPath p, ::HIR::TypeAlias& item) override
         {
+            if( !filter_item(p) )   return ;
             m_os << indent() << "type " << p.get_name() << item.m_params.fmt_args() << " = " << item.m_type << item.m_params.fmt_bounds() << "\n";
         }
         void visit_trait(::HIR::ItemPath p, ::HIR::Trait& item) override
@@ -101,6 +109,7 @@ namespace {
         }
         void visit_struct(::HIR::ItemPath p, ::HIR::Struct& item) override
         {
+            if( !filter_item(p) )   return ;
             m_os << indent() << "struct " << p.get_name() << item.m_params.fmt_args();
             TU_MATCHA( (item.m_data), (flds),
             (Unit,
@@ -151,6 +160,7 @@ namespace {
         }
         void visit_enum(::HIR::ItemPath p, ::HIR::Enum& item) override
         {
+            if( !filter_item(p) )   return ;
             m_os << indent() << "enum " << p.get_name() << item.m_params.fmt_args() << "\n";
             if( ! item.m_params.m_bounds.empty() )
             {
@@ -199,6 +209,7 @@ namespace {
         // - Value Items
         void visit_function(::HIR::ItemPath p, ::HIR::Function& item) override
         {
+            if( !filter_item(p) )   return ;
             m_os << indent();
             if( item.m_const )
                 m_os << "const ";
@@ -244,6 +255,7 @@ namespace {
         }
         void visit_static(::HIR::ItemPath p, ::HIR::Static& item) override
         {
+            if( !filter_item(p) )   return ;
             if( item.m_linkage.name != "" )
                 m_os << indent() << "#[link_name=\"" << item.m_linkage.name << "\"]\n";
             if( item.m_value )
@@ -261,6 +273,7 @@ namespace {
         }
         void visit_constant(::HIR::ItemPath p, ::HIR::Constant& item) override
         {
+            if( !filter_item(p) )   return ;
             m_os << indent() << "const " << p.get_name() << ": " << item.m_type << " = " << item.m_value_res;
             if( item.m_value )
             {
@@ -698,6 +711,19 @@ namespace {
         }
 
     private:
+        bool filter_item(const ::HIR::ItemPath& p) const {
+            if( m_item_filter == "" )
+                return true;
+            return FMT(p).find(m_item_filter) != ::std::string::npos;
+        }
+        /// Check if any item in an impl's item list passes the filter (impl blocks are skipped if none do)
+        template<typename List>
+        bool filter_any(const ::HIR::ItemPath& p, const List& list) const {
+            for(const auto& ent : list)
+                if( filter_item(p + ent.first) )
+                    return true;
+            return false;
+        }
         RepeatLitStr indent() const {
             return RepeatLitStr { "    ", static_cast<int>(m_indent_level) };
         }
@@ -710,9 +736,9 @@ namespace {
     };
 }
 
-void HIR_Dump(::std::ostream& sink, const ::HIR::Crate& crate)
+void HIR_Dump(::std::ostream& sink, const ::HIR::Crate& crate, const ::std::string& item_filter)
 {
-    TreeVisitor tv { sink };
+    TreeVisitor tv { sink, item_filter };
 
     tv.visit_crate( const_cast< ::HIR::Crate&>(crate) );
 }
@@ -7,6 +7,7 @@
 #include <hir/type.hpp>
 #include <span.hpp>
 #include <hir/visitor.hpp>
+#include <node_pool.hpp>
 
 namespace HIR {
 
@@ -47,6 +48,7 @@ public:
 
     const Span& span() const { return m_span; }
 
+    NODE_POOL_ALLOCATED()
     virtual void visit(ExprVisitor& v) = 0;
     ExprNode(Span sp):
         m_span( mv$(sp) )
@@ -16,6 +16,13 @@
 {
     return node.into_unique();
 }
+void HIR::ExprPtr::release_tree()
+{
+    assert(m_mir);
+    node.reset(nullptr);
+    m_bindings = ::std::vector< ::HIR::TypeRef>();
+    m_tree_released = true;
+}
 
 
 ::HIR::ExprPtrInner::ExprPtrInner(::std::unique_ptr< ::HIR::ExprNode> v):
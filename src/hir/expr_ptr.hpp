@@ -7,6 +7,7 @@
  */
 #pragma once
 #include <memory>
+#include <cassert>
 #include <vector>
 
 #include <mir/mir_ptr.hpp>
@@ -56,6 +57,8 @@ public:
 class ExprPtr
 {
     ::HIR::ExprPtrInner node;
+    /// Set once the expression tree has been released (leaving only MIR), see `release_tree`
+    bool    m_tree_released = false;
 
 public:
     ::std::vector< ::HIR::TypeRef>  m_bindings;
@@ -67,14 +70,22 @@ public:
     ExprPtr(::std::unique_ptr< ::HIR::ExprNode> _);
 
     ::std::unique_ptr< ::HIR::ExprNode> into_unique();
+    /// True if the expression tree is present (see `has_body` for a check that survives `release_tree`)
     operator bool () const { return node; }
+    /// True if this crate defines the body (even if the expression tree has since been released)
+    bool has_body() const { return node || m_tree_released; }
+    bool is_released() const { return m_tree_released; }
     ::HIR::ExprNode* get() const { return node.get(); }
     void reset(::HIR::ExprNode* p) { node.reset(p); }
 
-          ::HIR::ExprNode& operator*()       { return *node; }
-    const ::HIR::ExprNode& operator*() const { return *node; }
-          ::HIR::ExprNode* operator->()       { return &*node; }
-    const ::HIR::ExprNode* operator->() const { return &*node; }
+    /// Free the expression tree and binding types once MIR has been generated
+    /// - `m_mir` and `m_erased_types` are kept (used by codegen and serialisation)
+    void release_tree();
+
+          ::HIR::ExprNode& operator*()       { assert(node); return *node; }
+    const ::HIR::ExprNode& operator*() const { assert(node); return *node; }
+          ::HIR::ExprNode* operator->()       { assert(node); return &*node; }
+    const ::HIR::ExprNode* operator->() const { assert(node); return &*node; }
 };
 
 }   // namespace HIR
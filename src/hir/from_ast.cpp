@@ -829,11 +829,42 @@ namespace {
     }
 }
 
-::HIR::Struct LowerHIR_Struct(::HIR::ItemPath path, const ::AST::Struct& ent)
+::HIR::Struct LowerHIR_Struct(const Span& sp, ::HIR::ItemPath path, const ::AST::Struct& ent, const ::AST::MetaItems& attrs)
 {
     TRACE_FUNCTION_F(path);
     ::HIR::Struct::Data data;
 
+    auto repr = ::HIR::Struct::Repr::Rust;
+    if( const auto* attr_repr = attrs.get("repr") )
+    {
+        ASSERT_BUG(sp, attr_repr->has_sub_items(), "#[repr] attribute malformed, " << *attr_repr);
+        for(const auto& a : attr_repr->items())
+        {
+            if( !a.has_noarg() ) {
+                // TODO: `#[repr(align(N))]`
+                WARNING(sp, W0000, "Unsupported #[repr(" << a.name() << "(...))] on " << path << ", ignored");
+                continue ;
+            }
+            const auto& repr_str = a.name();
+            if( repr_str == "C" ) {
+                // NOTE: `packed` implies the C field order
+                if( repr == ::HIR::Struct::Repr::Rust )
+                    repr = ::HIR::Struct::Repr::C;
+            }
+            else if( repr_str == "packed" ) {
+                repr = ::HIR::Struct::Repr::Packed;
+            }
+            else if( repr_str == "simd" ) {
+                if( !ent.m_data.is_Tuple() )
+                    ERROR(sp, E0000, "#[repr(simd)] is only valid on tuple structs - " << path);
+                repr = ::HIR::Struct::Repr::Simd;
+            }
+            else {
+                WARNING(sp, W0000, "Unknown #[repr(" << repr_str << ")] on " << path << ", ignored");
+            }
+        }
+    }
+
     TU_MATCH(::AST::StructData, (ent.m_data), (e),
     (Unit,
         data = ::HIR::Struct::Data::make_Unit({});
@@ -856,8 +887,7 @@ namespace {
 
     return ::HIR::Struct {
         LowerHIR_GenericParams(ent.params(), nullptr),
-        // TODO: Get repr from attributes
-        ::HIR::Struct::Repr::Rust,
+        repr,
         mv$(data)
         };
 }
@@ -904,21 +934,21 @@ namespace {
         mv$(variants)
         };
 }
-::HIR::Union LowerHIR_Union(::HIR::ItemPath path, const ::AST::Union& f, const ::AST::MetaItems& attrs)
+::HIR::Union LowerHIR_Union(const Span& sp, ::HIR::ItemPath path, const ::AST::Union& f, const ::AST::MetaItems& attrs)
 {
     auto repr = ::HIR::Union::Repr::Rust;
 
     if( const auto* attr_repr = attrs.get("repr") )
     {
-        ASSERT_BUG(Span(), attr_repr->has_sub_items(), "#[repr] attribute malformed, " << *attr_repr);
-        ASSERT_BUG(Span(), attr_repr->items().size() == 1, "#[repr] attribute malformed, " << *attr_repr);
-        ASSERT_BUG(Span(), attr_repr->items()[0].has_noarg(), "#[repr] attribute malformed, " << *attr_repr);
+        ASSERT_BUG(sp, attr_repr->has_sub_items(), "#[repr] attribute malformed, " << *attr_repr);
+        ASSERT_BUG(sp, attr_repr->items().size() == 1, "#[repr] attribute malformed, " << *attr_repr);
+        ASSERT_BUG(sp, attr_repr->items()[0].has_noarg(), "#[repr] attribute malformed, " << *attr_repr);
         const auto& repr_str = attr_repr->items()[0].name();
         if( repr_str == "C" ) {
             repr = ::HIR::Union::Repr::C;
         }
         else {
-            // TODO: Error?
+            WARNING(sp, W0000, "Unknown #[repr(" << repr_str << ")] on " << path << ", ignored");
         }
     }
 
@@ -1091,10 +1121,23 @@ namespace {
     }
 
     bool force_emit = false;
+    auto inline_hint = ::HIR::Function::InlineHint::Default;
     if( const auto* a = attrs.get("inline") )
     {
-        (void)a;
         force_emit = true;
+        inline_hint = ::HIR::Function::InlineHint::Hint;
+        if( a->has_sub_items() )
+        {
+            if( a->items().size() != 1 )
+                ERROR(sp, E0000, "#[inline] takes at most one argument");
+            const auto& mode = a->items()[0].name();
+            if( mode == "always" )
+                inline_hint = ::HIR::Function::InlineHint::Always;
+            else if( mode == "never" )
+                inline_hint = ::HIR::Function::InlineHint::Never;
+            else
+                ERROR(sp, E0000, "Unknown #[inline] mode - " << mode);
+        }
     }
 
     ::HIR::Linkage  linkage;
@@ -1132,6 +1175,8 @@ namespace {
     return ::HIR::Function {
         force_emit,
         mv$(linkage),
+        inline_hint,
+        attrs.get("cold") != nullptr,
         receiver,
         f.abi(), f.is_unsafe(), f.is_const(),
         LowerHIR_GenericParams(f.params(), nullptr),    // TODO: If this is a method, then it can add the Self: Sized bound
@@ -1156,14 +1201,20 @@ void _add_mod_val_item(::HIR::Module& mod, ::std::string name, bool is_pub,  ::H
     mod.m_traits = mv$(traits);
 
     // Populate trait list
-    for(const auto& item : ast_mod.m_type_items)
-    {
-        if( item.second.path.binding().is_Trait() ) {
-            auto sp = LowerHIR_SimplePath(Span(), item.second.path);
+    auto add_trait = [&](const ::AST::Path& path) {
+        if( path.binding().is_Trait() ) {
+            auto sp = LowerHIR_SimplePath(Span(), path);
             if( ::std::find(mod.m_traits.begin(), mod.m_traits.end(), sp) == mod.m_traits.end() )
                 mod.m_traits.push_back( mv$(sp) );
         }
+        };
+    for(const auto& item : ast_mod.m_type_items)
+    {
+        add_trait(item.second.path);
     }
+    ast_mod.iterate_glob_items(::AST::Module::IndexName::Type, [&](const ::std::string& , const ::AST::Module::IndexRef& ie) {
+        add_trait(ie->path);
+        });
 
     for( unsigned int i = 0; i < ast_mod.anon_mods().size(); i ++ )
     {
@@ -1247,13 +1298,13 @@ void _add_mod_val_item(::HIR::Module& mod, ::std::string name, bool is_pub,  ::H
             }
             else {
             }
-            _add_mod_ns_item( mod,  item.name, item.is_pub, LowerHIR_Struct(item_path, e) );
+            _add_mod_ns_item( mod,  item.name, item.is_pub, LowerHIR_Struct(sp, item_path, e, item.data.attrs) );
             ),
         (Enum,
             _add_mod_ns_item( mod,  item.name, item.is_pub, LowerHIR_Enum(item_path, e) );
             ),
         (Union,
-            _add_mod_ns_item( mod,  item.name, item.is_pub, LowerHIR_Union(item_path, e, item.data.attrs) );
+            _add_mod_ns_item( mod,  item.name, item.is_pub, LowerHIR_Union(sp, item_path, e, item.data.attrs) );
             ),
         (Trait,
             _add_mod_ns_item( mod,  item.name, item.is_pub, LowerHIR_Trait(item_path.get_simple_path(), e) );
@@ -1289,45 +1340,60 @@ void _add_mod_val_item(::HIR::Module& mod, ::std::string name, bool is_pub,  ::H
     }
 
     Span    mod_span;
+    auto add_ns_import = [&](const ::std::string& name, const ::AST::Path& path, bool is_pub) {
+        const auto& sp = mod_span;
+        auto hir_path = LowerHIR_SimplePath( sp, path );
+        ::HIR::TypeItem ti;
+        TU_MATCH_DEF( ::AST::PathBinding, (path.binding()), (pb),
+        (
+            DEBUG("Import NS " << name << " = " << hir_path);
+            ti = ::HIR::TypeItem::make_Import({ mv$(hir_path), false, 0 });
+            ),
+        (EnumVar,
+            DEBUG("Import NS " << name << " = " << hir_path << " (Enum Variant)");
+            ti = ::HIR::TypeItem::make_Import({ mv$(hir_path), true, pb.idx });
+            )
+        )
+        _add_mod_ns_item(mod, name, is_pub, mv$(ti));
+        };
+    auto add_val_import = [&](const ::std::string& name, const ::AST::Path& path, bool is_pub) {
+        const auto& sp = mod_span;
+        auto hir_path = LowerHIR_SimplePath( sp, path );
+        ::HIR::ValueItem    vi;
+
+        TU_MATCH_DEF( ::AST::PathBinding, (path.binding()), (pb),
+        (
+            DEBUG("Import VAL " << name << " = " << hir_path);
+            vi = ::HIR::ValueItem::make_Import({ mv$(hir_path), false, 0 });
+            ),
+        (EnumVar,
+            DEBUG("Import VAL " << name << " = " << hir_path << " (Enum Variant)");
+            vi = ::HIR::ValueItem::make_Import({ mv$(hir_path), true, pb.idx });
+            )
+        )
+        _add_mod_val_item(mod, name, is_pub, mv$(vi));
+        };
     for( const auto& ie : ast_mod.m_namespace_items )
     {
-        const auto& sp = mod_span;
         if( ie.second.is_import ) {
-            auto hir_path = LowerHIR_SimplePath( sp, ie.second.path );
-            ::HIR::TypeItem ti;
-            TU_MATCH_DEF( ::AST::PathBinding, (ie.second.path.binding()), (pb),
-            (
-                DEBUG("Import NS " << ie.first << " = " << hir_path);
-                ti = ::HIR::TypeItem::make_Import({ mv$(hir_path), false, 0 });
-                ),
-            (EnumVar,
-                DEBUG("Import NS " << ie.first << " = " << hir_path << " (Enum Variant)");
-                ti = ::HIR::TypeItem::make_Import({ mv$(hir_path), true, pb.idx });
-                )
-            )
-            _add_mod_ns_item(mod, ie.first, ie.second.is_pub, mv$(ti));
+            add_ns_import(ie.first, ie.second.path, ie.second.is_pub);
         }
     }
     for( const auto& ie : ast_mod.m_value_items )
     {
-        const auto& sp = mod_span;
         if( ie.second.is_import ) {
-            auto hir_path = LowerHIR_SimplePath( sp, ie.second.path );
-            ::HIR::ValueItem    vi;
-
-            TU_MATCH_DEF( ::AST::PathBinding, (ie.second.path.binding()), (pb),
-            (
-                DEBUG("Import VAL " << ie.first << " = " << hir_path);
-                vi = ::HIR::ValueItem::make_Import({ mv$(hir_path), false, 0 });
-                ),
-            (EnumVar,
-                DEBUG("Import VAL " << ie.first << " = " << hir_path << " (Enum Variant)");
-                vi = ::HIR::ValueItem::make_Import({ mv$(hir_path), true, pb.idx });
-                )
-            )
-            _add_mod_val_item(mod, ie.first, ie.second.is_pub, mv$(vi));
+            add_val_import(ie.first, ie.second.path, ie.second.is_pub);
         }
     }
+    // Glob imports are only visible outside the module (and thus needed in the HIR) if re-exported
+    ast_mod.iterate_glob_items(::AST::Module::IndexName::Namespace, [&](const ::std::string& name, const ::AST::Module::IndexRef& ie) {
+        if( ie.is_pub )
+            add_ns_import(name, ie->path, true);
+        });
+    ast_mod.iterate_glob_items(::AST::Module::IndexName::Value, [&](const ::std::string& name, const ::AST::Module::IndexRef& ie) {
+        if( ie.is_pub )
+            add_val_import(name, ie->path, true);
+        });
 
     return mod;
 }
@@ -1543,7 +1609,7 @@ public:
 ///
 /// - Removes all possibility for unexpanded macros
 /// - Performs desugaring of for/if-let/while-let/...
-::HIR::CratePtr LowerHIR_FromAST(::AST::Crate crate)
+::HIR::CratePtr LowerHIR_FromAST(::AST::Crate&& crate)
 {
     ::HIR::Crate    rv;
 
@@ -1218,7 +1218,7 @@ const ::HIR::Function& ::HIR::Crate::get_function_by_path(const Span& sp, const
     }
 }
 
-bool ::HIR::Crate::find_trait_impls(const ::HIR::SimplePath& trait, const ::HIR::TypeRef& type, t_cb_resolve_type ty_res, ::std::function<bool(const ::HIR::TraitImpl&)> callback) const
+bool ::HIR::Crate::find_trait_impls(const ::HIR::SimplePath& trait, const ::HIR::TypeRef& type, t_cb_resolve_type ty_res, FunctionRef<bool(const ::HIR::TraitImpl&)> callback) const
 {
     auto its = this->m_trait_impls.equal_range( trait );
     for( auto it = its.first; it != its.second; ++ it )
@@ -1238,7 +1238,7 @@ bool ::HIR::Crate::find_trait_impls(const ::HIR::SimplePath& trait, const ::HIR:
     }
     return false;
 }
-bool ::HIR::Crate::find_auto_trait_impls(const ::HIR::SimplePath& trait, const ::HIR::TypeRef& type, t_cb_resolve_type ty_res, ::std::function<bool(const ::HIR::MarkerImpl&)> callback) const
+bool ::HIR::Crate::find_auto_trait_impls(const ::HIR::SimplePath& trait, const ::HIR::TypeRef& type, t_cb_resolve_type ty_res, FunctionRef<bool(const ::HIR::MarkerImpl&)> callback) const
 {
     auto its = this->m_marker_impls.equal_range( trait );
     for( auto it = its.first; it != its.second; ++ it )
@@ -1258,7 +1258,7 @@ bool ::HIR::Crate::find_auto_trait_impls(const ::HIR::SimplePath& trait, const :
     }
     return false;
 }
-bool ::HIR::Crate::find_type_impls(const ::HIR::TypeRef& type, t_cb_resolve_type ty_res, ::std::function<bool(const ::HIR::TypeImpl&)> callback) const
+bool ::HIR::Crate::find_type_impls(const ::HIR::TypeRef& type, t_cb_resolve_type ty_res, FunctionRef<bool(const ::HIR::TypeImpl&)> callback) const
 {
     // TODO: Restrict which crate is searched based on the type.
     for( const auto& impl : this->m_type_impls )
@@ -13,6 +13,9 @@
 #include <unordered_map>
 #include <vector>
 #include <memory>
+#include <mutex>
+#include <map>
+#include <typeindex>
 
 #include <tagged_union.hpp>
 
@@ -123,11 +126,20 @@ public:
         //PointerConst,
         Box,
     };
+    /// `#[inline]` attribute state, used by the MIR inliner
+    enum class InlineHint {
+        Default,    // No attribute
+        Hint,   // `#[inline]`
+        Always, // `#[inline(always)]`
+        Never,  // `#[inline(never)]`
+    };
 
     typedef ::std::vector< ::std::pair< ::HIR::Pattern, ::HIR::TypeRef> >   args_t;
 
     bool    m_save_code;    // Filled by enumerate, defaults to false
     Linkage m_linkage;
+    InlineHint  m_inline;
+    bool    m_cold; // `#[cold]` - Calls are unlikely to happen
 
     Receiver    m_receiver;
     ::std::string   m_abi;
@@ -250,6 +262,7 @@ public:
         Rust,
         C,
         Packed,
+        Simd,   // `#[repr(simd)]` - Tuple struct of identical primitives, emitted as a vector type
         //Union,
     };
     TAGGED_UNION(Data, Unit,
@@ -446,6 +459,36 @@ class ExternLibrary
 public:
     ::std::string   name;
 };
+
+/// Base for memoised query results that only depend on a crate's items (see `Crate::get_cache`)
+class CrateCache
+{
+public:
+    virtual ~CrateCache() {}
+};
+/// Locked access to one of a crate's caches (the lock is released when this is dropped)
+template<typename T>
+class CrateCacheRef
+{
+    ::std::unique_lock< ::std::mutex>   m_lock;
+    T&  m_cache;
+public:
+    CrateCacheRef(::std::unique_lock< ::std::mutex> lock, T& cache):
+        m_lock(mv$(lock)),
+        m_cache(cache)
+    {}
+    T* operator->() const { return &m_cache; }
+    T& operator*() const { return m_cache; }
+};
+/// Storage for the caches of a crate
+struct CrateCaches
+{
+    ::std::mutex    lock;
+    /// Number of impls when the caches were last used (they're dropped if this changes)
+    size_t  impl_count = 0;
+    ::std::map< ::std::type_index, ::std::unique_ptr<CrateCache> >  caches;
+};
+
 class Crate
 {
 public:
@@ -469,6 +512,13 @@ public:
     ::std::vector<ExternLibrary>    m_ext_libs;
     ::std::vector<::std::string>    m_link_paths;
 
+    /// Library was built without an object file (all functions have MIR, and statics have their values)
+    /// - Code is generated by the crates that use it, see `Trans_SetMirOnly`
+    bool    m_is_mir_only = false;
+
+    /// Caches of derived data, see `get_cache`
+    ::std::unique_ptr<CrateCaches>  m_caches { new CrateCaches() };
+
     /// Method called to populate runtime state after deserialisation
     /// See hir/crate_post_load.cpp
     void post_load_update(const ::std::string& loaded_name);
@@ -504,9 +554,25 @@ public:
         }
     }
 
-    bool find_trait_impls(const ::HIR::SimplePath& path, const ::HIR::TypeRef& type, t_cb_resolve_type ty_res, ::std::function<bool(const ::HIR::TraitImpl&)> callback) const;
-    bool find_auto_trait_impls(const ::HIR::SimplePath& path, const ::HIR::TypeRef& type, t_cb_resolve_type ty_res, ::std::function<bool(const ::HIR::MarkerImpl&)> callback) const;
-    bool find_type_impls(const ::HIR::TypeRef& type, t_cb_resolve_type ty_res, ::std::function<bool(const ::HIR::TypeImpl&)> callback) const;
+    /// Get the crate's cache of type `T` (a `CrateCache`, created on first use)
+    /// - All caches are dropped if impls have been added since the last call (closure and vtable expansion add impls)
+    template<typename T>
+    CrateCacheRef<T> get_cache() const {
+        ::std::unique_lock< ::std::mutex>   lh { m_caches->lock };
+        size_t  count = m_trait_impls.size() + m_marker_impls.size() + m_type_impls.size();
+        if( count != m_caches->impl_count ) {
+            m_caches->caches.clear();
+            m_caches->impl_count = count;
+        }
+        auto& slot = m_caches->caches[typeid(T)];
+        if( !slot )
+            slot.reset( new T() );
+        return CrateCacheRef<T>( mv$(lh), static_cast<T&>(*slot) );
+    }
+
+    bool find_trait_impls(const ::HIR::SimplePath& path, const ::HIR::TypeRef& type, t_cb_resolve_type ty_res, FunctionRef<bool(const ::HIR::TraitImpl&)> callback) const;
+    bool find_auto_trait_impls(const ::HIR::SimplePath& path, const ::HIR::TypeRef& type, t_cb_resolve_type ty_res, FunctionRef<bool(const ::HIR::MarkerImpl&)> callback) const;
+    bool find_type_impls(const ::HIR::TypeRef& type, t_cb_resolve_type ty_res, FunctionRef<bool(const ::HIR::TypeImpl&)> callback) const;
 };
 
 }   // namespace HIR
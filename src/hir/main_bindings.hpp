@@ -15,7 +15,7 @@ namespace AST {
     class Crate;
 }
 
-extern void HIR_Dump(::std::ostream& sink, const ::HIR::Crate& crate);
-extern ::HIR::CratePtr  LowerHIR_FromAST(::AST::Crate crate);
+extern void HIR_Dump(::std::ostream& sink, const ::HIR::Crate& crate, const ::std::string& item_filter="");
+extern ::HIR::CratePtr  LowerHIR_FromAST(::AST::Crate&& crate);
 extern void HIR_Serialise(const ::std::string& filename, const ::HIR::Crate& crate);
 extern ::HIR::CratePtr HIR_Deserialise(const ::std::string& filename, const ::std::string& loaded_name);
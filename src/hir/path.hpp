@@ -13,6 +13,7 @@
 #include <tagged_union.hpp>
 #include <hir/type_ptr.hpp>
 #include <span.hpp>
+#include <function_ref.hpp>
 
 namespace HIR {
 
@@ -24,8 +25,8 @@ enum Compare {
     Unequal,
 };
 
-typedef ::std::function<const ::HIR::TypeRef&(const ::HIR::TypeRef&)> t_cb_resolve_type;
-typedef ::std::function< ::HIR::Compare(unsigned int, const ::std::string&, const ::HIR::TypeRef&) > t_cb_match_generics;
+typedef FunctionRef<const ::HIR::TypeRef&(const ::HIR::TypeRef&)> t_cb_resolve_type;
+typedef FunctionRef< ::HIR::Compare(unsigned int, const ::std::string&, const ::HIR::TypeRef&) > t_cb_match_generics;
 
 static inline ::std::ostream& operator<<(::std::ostream& os, const Compare& x) {
     switch(x)
@@ -16,6 +16,8 @@ namespace {
     class HirSerialiser
     {
         ::HIR::serialise::Writer&   m_out;
+        /// Save the values of statics (MIR-only libraries, so users can emit them)
+        bool    m_save_static_values = false;
     public:
         HirSerialiser(::HIR::serialise::Writer& out):
             m_out( out )
@@ -239,6 +241,7 @@ namespace {
 
         void serialise_crate(const ::HIR::Crate& crate)
         {
+            m_save_static_values = crate.m_is_mir_only;
             m_out.write_string(crate.m_crate_name);
             serialise_module(crate.m_root_module);
 
@@ -268,6 +271,7 @@ namespace {
             }
             serialise_vec(crate.m_ext_libs);
             serialise_vec(crate.m_link_paths);
+            m_out.write_bool(crate.m_is_mir_only);
         }
         void serialise(const ::HIR::ExternLibrary& lib)
         {
@@ -806,6 +810,8 @@ namespace {
             TRACE_FUNCTION_F("_function:");
 
             serialise(fcn.m_linkage);
+            m_out.write_tag( static_cast<int>(fcn.m_inline) );
+            m_out.write_bool(fcn.m_cold);
 
             m_out.write_tag( static_cast<int>(fcn.m_receiver) );
             m_out.write_string(fcn.m_abi);
@@ -840,7 +846,12 @@ namespace {
             m_out.write_bool(item.m_is_mut);
             serialise(item.m_type);
 
-            // NOTE: Value not stored (What if the static is generic? It can't be.)
+            // NOTE: Value only stored for MIR-only libraries, otherwise the static is defined in the library's object
+            bool save_value = m_save_static_values && !item.m_value_res.is_Invalid();
+            m_out.write_bool(save_value);
+            if( save_value ) {
+                serialise(item.m_value_res);
+            }
         }
 
         // - Type items
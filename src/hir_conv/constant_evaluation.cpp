@@ -13,6 +13,7 @@
 #include <mir/mir.hpp>
 #include <hir_typeck/common.hpp>    // Monomorph
 #include <mir/helpers.hpp>
+#include <trans/target.hpp> // Target_GetSizeOf
 
 namespace {
     typedef ::std::vector< ::std::pair< ::std::string, ::HIR::Static> > t_new_values;
@@ -1426,25 +1427,45 @@ namespace {
                 return retval;
                 ),
             (Call,
-                if( !e.fcn.is_Path() )
-                    BUG(sp, "Unexpected terminator - " << block.terminator);
-                const auto& fcnp = e.fcn.as_Path();
-
                 auto& dst = get_lval(e.ret_val);
-                auto& fcn = get_function(sp, crate, fcnp);
-
-                ::std::vector< ::HIR::Literal>  call_args;
-                call_args.reserve( e.args.size() );
-                for(const auto& a : e.args)
-                    call_args.push_back( read_param(a) );
-                // TODO: Set m_const during parse and check here
-
-                // Call by invoking evaluate_constant on the function
+                if( const auto* te = e.fcn.opt_Intrinsic() )
                 {
-                    TRACE_FUNCTION_F("Call const fn " << fcnp << " args={ " << call_args << " }");
-                    dst = evaluate_constant(sp, crate, newval_state,  fcn.m_code, fcn.m_return.clone(), mv$(call_args));
+                    // Layout queries (answered by the same layout engine as codegen)
+                    const auto& ty = te->params.m_types.at(0);
+                    size_t  val = 0;
+                    if( te->name == "size_of" ) {
+                        if( !Target_GetSizeOf(sp, resolve, ty, val) || val == SIZE_MAX )
+                            ERROR(sp, E0000, "Size of " << ty << " isn't known in constant evaluation");
+                    }
+                    else if( te->name == "min_align_of" ) {
+                        if( !Target_GetAlignOf(sp, resolve, ty, val) || val == 0 )
+                            ERROR(sp, E0000, "Alignment of " << ty << " isn't known in constant evaluation");
+                    }
+                    else {
+                        MIR_TODO(state, "Call intrinsic \"" << te->name << "\" - " << block.terminator);
+                    }
+                    dst = ::HIR::Literal::make_Integer(val);
                 }
+                else
+                {
+                    if( !e.fcn.is_Path() )
+                        BUG(sp, "Unexpected terminator - " << block.terminator);
+                    const auto& fcnp = e.fcn.as_Path();
+
+                    auto& fcn = get_function(sp, crate, fcnp);
+
+                    ::std::vector< ::HIR::Literal>  call_args;
+                    call_args.reserve( e.args.size() );
+                    for(const auto& a : e.args)
+                        call_args.push_back( read_param(a) );
+                    // TODO: Set m_const during parse and check here
 
+                    // Call by invoking evaluate_constant on the function
+                    {
+                        TRACE_FUNCTION_F("Call const fn " << fcnp << " args={ " << call_args << " }");
+                        dst = evaluate_constant(sp, crate, newval_state,  fcn.m_code, fcn.m_return.clone(), mv$(call_args));
+                    }
+                }
                 cur_block = e.ret_block;
                 )
             )
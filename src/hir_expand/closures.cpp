@@ -194,9 +194,9 @@ namespace {
         public ::HIR::ExprVisitorDef
     {
         const ::HIR::Crate& m_crate;
-        t_cb_generic    m_monomorph_cb;
+        ::std::function<const ::HIR::TypeRef&(const ::HIR::TypeRef&)>  m_monomorph_cb;
     public:
-        ExprVisitor_Fixup(const ::HIR::Crate& crate, t_cb_generic monomorph_cb):
+        ExprVisitor_Fixup(const ::HIR::Crate& crate, ::std::function<const ::HIR::TypeRef&(const ::HIR::TypeRef&)> monomorph_cb):
             m_crate(crate),
             m_monomorph_cb( mv$(monomorph_cb) )
         {
@@ -295,7 +295,7 @@ namespace {
                 mv$(params), mv$(trait_params), mv$(closure_type),
                 make_map1(
                     ::std::string("call_once"), ::HIR::TraitImpl::ImplEnt< ::HIR::Function> { false, ::HIR::Function {
-                        false, ::HIR::Linkage {},
+                        false, ::HIR::Linkage {}, ::HIR::Function::InlineHint::Default, false,
                         ::HIR::Function::Receiver::Value,
                         ABI_RUST, false, false,
                         {},
@@ -333,7 +333,7 @@ namespace {
                 mv$(params), mv$(trait_params), mv$(closure_type),
                 make_map1(
                     ::std::string("call_mut"), ::HIR::TraitImpl::ImplEnt< ::HIR::Function> { false, ::HIR::Function {
-                        false, ::HIR::Linkage {},
+                        false, ::HIR::Linkage {}, ::HIR::Function::InlineHint::Default, false,
                         ::HIR::Function::Receiver::BorrowUnique,
                         ABI_RUST, false, false,
                         {},
@@ -369,7 +369,7 @@ namespace {
                 mv$(params), mv$(trait_params), mv$(closure_type),
                 make_map1(
                     ::std::string("call"), ::HIR::TraitImpl::ImplEnt< ::HIR::Function> { false, ::HIR::Function {
-                        false, ::HIR::Linkage {},
+                        false, ::HIR::Linkage {}, ::HIR::Function::InlineHint::Default, false,
                         ::HIR::Function::Receiver::BorrowShared,
                         ABI_RUST, false, false,
                         {},
@@ -11,7 +11,7 @@
 #include <algorithm>
 #include "main_bindings.hpp"
 
-const ::HIR::Function& HIR_Expand_ErasedType_GetFunction(const Span& sp, const StaticTraitResolve& resolve, const ::HIR::Path& origin_path, t_cb_generic& monomorph_cb, ::HIR::PathParams& impl_params)
+const ::HIR::Function& HIR_Expand_ErasedType_GetFunction(const Span& sp, const StaticTraitResolve& resolve, const ::HIR::Path& origin_path, ::std::function<const ::HIR::TypeRef&(const ::HIR::TypeRef&)>& monomorph_cb, ::HIR::PathParams& impl_params)
 {
     const ::HIR::Function*  fcn_ptr = nullptr;
     switch(origin_path.m_data.tag())
@@ -109,7 +109,7 @@ namespace {
                 const auto& e = ty.m_data.as_ErasedType();
 
                 ::HIR::PathParams   impl_params;    // cache.
-                t_cb_generic    monomorph_cb;
+                ::std::function<const ::HIR::TypeRef&(const ::HIR::TypeRef&)>    monomorph_cb;
                 const auto& fcn = HIR_Expand_ErasedType_GetFunction(sp, m_resolve, e.m_origin, monomorph_cb, impl_params);
                 const auto& erased_types = fcn.m_code.m_erased_types;
 
@@ -188,7 +188,7 @@ namespace {
                 TRACE_FUNCTION_FR(ty, ty);
 
                 ::HIR::PathParams   impl_params;
-                t_cb_generic    monomorph_cb;
+                ::std::function<const ::HIR::TypeRef&(const ::HIR::TypeRef&)>    monomorph_cb;
                 const auto& fcn = HIR_Expand_ErasedType_GetFunction(sp, m_resolve, e.m_origin, monomorph_cb, impl_params);
                 const auto& erased_types = fcn.m_code.m_erased_types;
 
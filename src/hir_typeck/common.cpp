@@ -301,9 +301,9 @@ bool monomorphise_type_needed(const ::HIR::TypeRef& tpl)
 
 namespace {
     template<typename T>
-    t_cb_clone_ty monomorphise_type_with__closure(const Span& sp, const T& outer_tpl, t_cb_generic& callback, bool allow_infer)
+    auto monomorphise_type_with__closure(const Span& sp, const T& outer_tpl, t_cb_generic& callback, bool allow_infer)
     {
-        return [&sp,&outer_tpl,callback,allow_infer](const auto& tpl, auto& rv) {
+        return [&sp,&outer_tpl,callback,allow_infer](const ::HIR::TypeRef& tpl, ::HIR::TypeRef& rv) {
             if( tpl.m_data.is_Infer() && !allow_infer )
                BUG(sp, "_ type found in " << outer_tpl);
 
@@ -373,7 +373,7 @@ namespace {
         }, false);
 }
 
-t_cb_generic MonomorphState::get_cb(const Span& sp) const
+::std::function<const ::HIR::TypeRef&(const ::HIR::TypeRef&)> MonomorphState::get_cb(const Span& sp) const
 {
     return monomorphise_type_get_cb(sp, this->self_ty, this->pp_impl, this->pp_method);
 }
@@ -12,7 +12,8 @@
 #include <hir/type.hpp>
 
 // TODO/NOTE - This is identical to ::HIR::t_cb_resolve_type
-typedef ::std::function<const ::HIR::TypeRef&(const ::HIR::TypeRef&)>   t_cb_generic;
+// NOTE: Non-owning (see FunctionRef), use `::std::function` to store a callback
+typedef FunctionRef<const ::HIR::TypeRef&(const ::HIR::TypeRef&)>   t_cb_generic;
 
 extern bool monomorphise_type_needed(const ::HIR::TypeRef& tpl);
 extern bool monomorphise_pathparams_needed(const ::HIR::PathParams& tpl);
@@ -29,12 +30,12 @@ extern ::HIR::Path monomorphise_path_with(const Span& sp, const ::HIR::Path& tpl
 extern ::HIR::TypeRef monomorphise_type_with(const Span& sp, const ::HIR::TypeRef& tpl, t_cb_generic callback, bool allow_infer=true);
 extern ::HIR::TypeRef monomorphise_type(const Span& sp, const ::HIR::GenericParams& params_def, const ::HIR::PathParams& params,  const ::HIR::TypeRef& tpl);
 
-typedef ::std::function<bool(const ::HIR::TypeRef&)> t_cb_visit_ty;
+typedef FunctionRef<bool(const ::HIR::TypeRef&)> t_cb_visit_ty;
 /// Calls the provided callback on every type seen when recursing the type.
 /// If the callback returns `true`, no further types are visited and the function returns `true`.
 extern bool visit_ty_with(const ::HIR::TypeRef& ty, t_cb_visit_ty callback);
 
-typedef ::std::function<bool(const ::HIR::TypeRef&, ::HIR::TypeRef&)>   t_cb_clone_ty;
+typedef FunctionRef<bool(const ::HIR::TypeRef&, ::HIR::TypeRef&)>   t_cb_clone_ty;
 /// Clones a type, calling the provided callback on every type (optionally providing a replacement)
 extern ::HIR::TypeRef clone_ty_with(const Span& sp, const ::HIR::TypeRef& tpl, t_cb_clone_ty callback);
 
@@ -75,7 +76,7 @@ struct MonomorphState
         return rv;
     }
 
-    t_cb_generic    get_cb(const Span& sp) const;
+    ::std::function<const ::HIR::TypeRef&(const ::HIR::TypeRef&)> get_cb(const Span& sp) const;
 
     ::HIR::TypeRef  monomorph(const Span& sp, const ::HIR::TypeRef& ty, bool allow_infer=true) const {
         return monomorphise_type_with(sp, ty, this->get_cb(sp), allow_infer);
@@ -86,7 +87,7 @@ struct MonomorphState
 };
 extern ::std::ostream& operator<<(::std::ostream& os, const MonomorphState& ms);
 
-static inline t_cb_generic monomorphise_type_get_cb(const Span& sp, const ::HIR::TypeRef* self_ty, const ::HIR::PathParams* params_i, const ::HIR::PathParams* params_m, const ::HIR::PathParams* params_p=nullptr)
+static inline ::std::function<const ::HIR::TypeRef&(const ::HIR::TypeRef&)> monomorphise_type_get_cb(const Span& sp, const ::HIR::TypeRef* self_ty, const ::HIR::PathParams* params_i, const ::HIR::PathParams* params_m, const ::HIR::PathParams* params_p=nullptr)
 {
     return [=](const ::HIR::TypeRef& gt)->const ::HIR::TypeRef& {
         const auto& ge = gt.m_data.as_Generic();
@@ -18,7 +18,7 @@ void HMTypeInferrence::dump() const
             //DEBUG("#" << i << " = " << v.alias);
         }
         else {
-            DEBUG("#" << i << " = " << *v.type << FMT_CB(os,
+            DEBUG("#" << i << " = " << v.type << FMT_CB(os,
                 bool open = false;
                 unsigned int i2 = 0;
                 for(const auto& v2 : m_ivars) {
@@ -69,13 +69,13 @@ void HMTypeInferrence::check_for_loops()
             TU_MATCH( ::HIR::TypeRef::Data, (ty.m_data), (e),
             (Infer,
                 for(auto idx : m_indexes)
-                    ASSERT_BUG(Span(), e.index != idx, "Recursion in ivar #" << m_indexes.front() << " " << *ivars.m_ivars[m_indexes.front()].type
-                        << " - loop with " << idx << " " << *ivars.m_ivars[idx].type);
+                    ASSERT_BUG(Span(), e.index != idx, "Recursion in ivar #" << m_indexes.front() << " " << ivars.m_ivars[m_indexes.front()].type
+                        << " - loop with " << idx << " " << ivars.m_ivars[idx].type);
                 const auto& ivd = ivars.get_pointed_ivar(e.index);
                 assert( !ivd.is_alias() );
-                if( !ivd.type->m_data.is_Infer() ) {
+                if( !ivd.type.m_data.is_Infer() ) {
                     m_indexes.push_back( e.index );
-                    this->check_ty(ivars, *ivd.type);
+                    this->check_ty(ivars, ivd.type);
                     m_indexes.pop_back( );
                 }
                 ),
@@ -133,10 +133,10 @@ void HMTypeInferrence::check_for_loops()
     unsigned int i = 0;
     for(const auto& v : m_ivars)
     {
-        if( !v.is_alias() && !v.type->m_data.is_Infer() )
+        if( !v.is_alias() && !v.type.m_data.is_Infer() )
         {
-            DEBUG("- " << i << " " << *v.type);
-            (LoopChecker { {i} }).check_ty(*this, *v.type);
+            DEBUG("- " << i << " " << v.type);
+            (LoopChecker { {i} }).check_ty(*this, v.type);
         }
         i ++;
     }
@@ -149,27 +149,14 @@ void HMTypeInferrence::compact_ivars()
     for(auto& v : m_ivars)
     {
         if( !v.is_alias() ) {
-            //auto nt = this->expand_associated_types(Span(), v.type->clone());
-            auto nt = v.type->clone();
+            //auto nt = this->expand_associated_types(Span(), v.type.clone());
+            auto nt = v.type.clone();
 
-            DEBUG("- " << i << " " << *v.type << " -> " << nt);
-            *v.type = mv$(nt);
+            DEBUG("- " << i << " " << v.type << " -> " << nt);
+            v.type = mv$(nt);
         }
         else {
-
-            auto index = v.alias;
-            unsigned int count = 0;
-            assert(index < m_ivars.size());
-            while( m_ivars.at(index).is_alias() ) {
-                index = m_ivars.at(index).alias;
-
-                if( count >= m_ivars.size() ) {
-                    this->dump();
-                    BUG(Span(), "Loop detected in ivar list when starting at " << v.alias << ", current is " << index);
-                }
-                count ++;
-            }
-            v.alias = index;
+            v.alias = this->get_root_index(v.alias);
         }
         i ++;
     }
@@ -181,25 +168,25 @@ bool HMTypeInferrence::apply_defaults()
     for(auto& v : m_ivars)
     {
         if( !v.is_alias() ) {
-            TU_IFLET(::HIR::TypeRef::Data, v.type->m_data, Infer, e,
+            TU_IFLET(::HIR::TypeRef::Data, v.type.m_data, Infer, e,
                 switch(e.ty_class)
                 {
                 case ::HIR::InferClass::None:
                     break;
                 case ::HIR::InferClass::Diverge:
                     rv = true;
-                    DEBUG("- " << *v.type << " -> !");
-                    *v.type = ::HIR::TypeRef(::HIR::TypeRef::Data::make_Diverge({}));
+                    DEBUG("- " << v.type << " -> !");
+                    v.type = ::HIR::TypeRef(::HIR::TypeRef::Data::make_Diverge({}));
                     break;
                 case ::HIR::InferClass::Integer:
                     rv = true;
-                    DEBUG("- " << *v.type << " -> i32");
-                    *v.type = ::HIR::TypeRef( ::HIR::CoreType::I32 );
+                    DEBUG("- " << v.type << " -> i32");
+                    v.type = ::HIR::TypeRef( ::HIR::CoreType::I32 );
                     break;
                 case ::HIR::InferClass::Float:
                     rv = true;
-                    DEBUG("- " << *v.type << " -> f64");
-                    *v.type = ::HIR::TypeRef( ::HIR::CoreType::F64 );
+                    DEBUG("- " << v.type << " -> f64");
+                    v.type = ::HIR::TypeRef( ::HIR::CoreType::F64 );
                     break;
                 }
             )
@@ -514,7 +501,7 @@ void HMTypeInferrence::add_ivars_params(::HIR::PathParams& params)
 unsigned int HMTypeInferrence::new_ivar()
 {
     m_ivars.push_back( IVar() );
-    m_ivars.back().type->m_data.as_Infer().index = m_ivars.size() - 1;
+    m_ivars.back().type.m_data.as_Infer().index = m_ivars.size() - 1;
     return m_ivars.size() - 1;
 }
 ::HIR::TypeRef HMTypeInferrence::new_ivar_tr()
@@ -528,7 +515,7 @@ unsigned int HMTypeInferrence::new_ivar()
 {
     TU_IFLET(::HIR::TypeRef::Data, type.m_data, Infer, e,
         assert(e.index != ~0u);
-        return *get_pointed_ivar(e.index).type;
+        return get_pointed_ivar(e.index).type;
     )
     else {
         return type;
@@ -539,7 +526,7 @@ const ::HIR::TypeRef& HMTypeInferrence::get_type(const ::HIR::TypeRef& type) con
 {
     TU_IFLET(::HIR::TypeRef::Data, type.m_data, Infer, e,
         assert(e.index != ~0u);
-        return *get_pointed_ivar(e.index).type;
+        return get_pointed_ivar(e.index).type;
     )
     else {
         return type;
@@ -550,7 +537,7 @@ void HMTypeInferrence::set_ivar_to(unsigned int slot, ::HIR::TypeRef type)
 {
     auto sp = Span();
     auto& root_ivar = this->get_pointed_ivar(slot);
-    DEBUG("set_ivar_to(" << slot << " { " << *root_ivar.type << " }, " << type << ")");
+    DEBUG("set_ivar_to(" << slot << " { " << root_ivar.type << " }, " << type << ")");
 
     // If the left type was '_', alias the right to it
     TU_IFLET(::HIR::TypeRef::Data, type.m_data, Infer, l_e,
@@ -558,9 +545,9 @@ void HMTypeInferrence::set_ivar_to(unsigned int slot, ::HIR::TypeRef type)
         DEBUG("Set IVar " << slot << " = @" << l_e.index);
 
         if( l_e.ty_class != ::HIR::InferClass::None ) {
-            TU_MATCH_DEF(::HIR::TypeRef::Data, (root_ivar.type->m_data), (e),
+            TU_MATCH_DEF(::HIR::TypeRef::Data, (root_ivar.type.m_data), (e),
             (
-                ERROR(sp, E0000, "Type unificiation of literal with invalid type - " << *root_ivar.type);
+                ERROR(sp, E0000, "Type unificiation of literal with invalid type - " << root_ivar.type);
                 ),
             (Primitive,
                 check_type_class_primitive(sp, type, l_e.ty_class, e);
@@ -568,22 +555,28 @@ void HMTypeInferrence::set_ivar_to(unsigned int slot, ::HIR::TypeRef type)
             (Infer,
                 // Check for right having a ty_class
                 if( e.ty_class != ::HIR::InferClass::None && e.ty_class != l_e.ty_class ) {
-                    ERROR(sp, E0000, "Unifying types with mismatching literal classes - " << type << " := " << *root_ivar.type);
+                    ERROR(sp, E0000, "Unifying types with mismatching literal classes - " << type << " := " << root_ivar.type);
                 }
                 )
             )
         }
 
-        root_ivar.alias = l_e.index;
-        root_ivar.type.reset();
+        auto l_root = this->get_root_index(l_e.index);
+        if( l_root == this->get_root_index(slot) ) {
+            return ;
+        }
+        root_ivar.alias = l_root;
+        auto& l_ivar = m_ivars[l_root];
+        if( l_ivar.rank <= root_ivar.rank )
+            l_ivar.rank = root_ivar.rank + 1;
     )
-    else if( *root_ivar.type == type ) {
+    else if( root_ivar.type == type ) {
         return ;
     }
     else {
         // Otherwise, store left in right's slot
         DEBUG("Set IVar " << slot << " = " << type);
-        TU_IFLET(::HIR::TypeRef::Data, root_ivar.type->m_data, Infer, e,
+        TU_IFLET(::HIR::TypeRef::Data, root_ivar.type.m_data, Infer, e,
             switch(e.ty_class)
             {
             case ::HIR::InferClass::None:
@@ -603,21 +596,21 @@ void HMTypeInferrence::set_ivar_to(unsigned int slot, ::HIR::TypeRef type)
             }
         )
         #if 0
-        else TU_IFLET(::HIR::TypeRef::Data, root_ivar.type->m_data, Diverge, e,
+        else TU_IFLET(::HIR::TypeRef::Data, root_ivar.type.m_data, Diverge, e,
             // Overwriting ! with anything is valid (it's like a magic ivar)
         )
         #endif
         else {
-            BUG(sp, "Overwriting ivar " << slot << " (" << *root_ivar.type << ") with " << type);
+            BUG(sp, "Overwriting ivar " << slot << " (" << root_ivar.type << ") with " << type);
         }
 
         #if 1
         TU_IFLET(::HIR::TypeRef::Data, type.m_data, Diverge, e,
-            root_ivar.type->m_data.as_Infer().ty_class = ::HIR::InferClass::Diverge;
+            root_ivar.type.m_data.as_Infer().ty_class = ::HIR::InferClass::Diverge;
         )
         else
         #endif
-        root_ivar.type = box$( mv$(type) );
+        root_ivar.type = mv$(type);
     }
 
     this->mark_change();
@@ -626,17 +619,17 @@ void HMTypeInferrence::set_ivar_to(unsigned int slot, ::HIR::TypeRef type)
 void HMTypeInferrence::ivar_unify(unsigned int left_slot, unsigned int right_slot)
 {
     auto sp = Span();
-    if( left_slot != right_slot )
+    auto left_root = this->get_root_index(left_slot);
+    auto right_root = this->get_root_index(right_slot);
+    if( left_root != right_root )
     {
-        auto& left_ivar = this->get_pointed_ivar(left_slot);
+        auto& left_ivar = m_ivars[left_root];
+        auto& root_ivar = m_ivars[right_root];
 
-        // TODO: Assert that setting this won't cause a loop.
-        auto& root_ivar = this->get_pointed_ivar(right_slot);
-
-        TU_IFLET(::HIR::TypeRef::Data, root_ivar.type->m_data, Infer, re,
+        TU_IFLET(::HIR::TypeRef::Data, root_ivar.type.m_data, Infer, re,
             if( re.ty_class == ::HIR::InferClass::Diverge )
             {
-                TU_IFLET(::HIR::TypeRef::Data, left_ivar.type->m_data, Infer, le,
+                TU_IFLET(::HIR::TypeRef::Data, left_ivar.type.m_data, Infer, le,
                     if( le.ty_class == ::HIR::InferClass::None ) {
                         le.ty_class = ::HIR::InferClass::Diverge;
                     }
@@ -644,9 +637,9 @@ void HMTypeInferrence::ivar_unify(unsigned int left_slot, unsigned int right_slo
             }
             else if(re.ty_class != ::HIR::InferClass::None)
             {
-                TU_MATCH_DEF(::HIR::TypeRef::Data, (left_ivar.type->m_data), (le),
+                TU_MATCH_DEF(::HIR::TypeRef::Data, (left_ivar.type.m_data), (le),
                 (
-                    ERROR(sp, E0000, "Type unificiation of literal with invalid type - " << *left_ivar.type);
+                    ERROR(sp, E0000, "Type unificiation of literal with invalid type - " << left_ivar.type);
                     ),
                 (Infer,
                     if( le.ty_class == ::HIR::InferClass::Diverge )
@@ -654,7 +647,7 @@ void HMTypeInferrence::ivar_unify(unsigned int left_slot, unsigned int right_slo
                     }
                     else if( le.ty_class != ::HIR::InferClass::None && le.ty_class != re.ty_class )
                     {
-                        ERROR(sp, E0000, "Unifying types with mismatching literal classes - " << *left_ivar.type << " := " << *root_ivar.type);
+                        ERROR(sp, E0000, "Unifying types with mismatching literal classes - " << left_ivar.type << " := " << root_ivar.type);
                     }
                     else
                     {
@@ -662,7 +655,7 @@ void HMTypeInferrence::ivar_unify(unsigned int left_slot, unsigned int right_slo
                     le.ty_class = re.ty_class;
                     ),
                 (Primitive,
-                    check_type_class_primitive(sp, *left_ivar.type, re.ty_class, le);
+                    check_type_class_primitive(sp, left_ivar.type, re.ty_class, le);
                     )
                 )
             }
@@ -671,23 +664,34 @@ void HMTypeInferrence::ivar_unify(unsigned int left_slot, unsigned int right_slo
             }
         )
         else {
-            BUG(sp, "Unifying over a concrete type - " << *root_ivar.type);
+            BUG(sp, "Unifying over a concrete type - " << root_ivar.type);
         }
 
-        DEBUG("IVar " << root_ivar.type->m_data.as_Infer().index << " = @" << left_slot);
-        root_ivar.alias = left_slot;
-        root_ivar.type.reset();
+        // Union by rank, the left side must stay the root if it's already known
+        if( left_ivar.type.m_data.is_Infer() && left_ivar.rank < root_ivar.rank )
+        {
+            DEBUG("IVar " << left_root << " = @" << right_root);
+            root_ivar.type.m_data.as_Infer().ty_class = left_ivar.type.m_data.as_Infer().ty_class;
+            left_ivar.alias = right_root;
+        }
+        else
+        {
+            DEBUG("IVar " << right_root << " = @" << left_root);
+            root_ivar.alias = left_root;
+            if( left_ivar.rank == root_ivar.rank )
+                left_ivar.rank += 1;
+        }
 
         this->mark_change();
     }
 }
-HMTypeInferrence::IVar& HMTypeInferrence::get_pointed_ivar(unsigned int slot) const
+unsigned int HMTypeInferrence::get_root_index(unsigned int slot) const
 {
     auto index = slot;
     unsigned int count = 0;
     assert(index < m_ivars.size());
-    while( m_ivars.at(index).is_alias() ) {
-        index = m_ivars.at(index).alias;
+    while( m_ivars[index].is_alias() ) {
+        index = m_ivars[index].alias;
 
         if( count >= m_ivars.size() ) {
             this->dump();
@@ -695,7 +699,17 @@ HMTypeInferrence::IVar& HMTypeInferrence::get_pointed_ivar(unsigned int slot) co
         }
         count ++;
     }
-    return const_cast<IVar&>(m_ivars.at(index));
+    // Path compression - point everything walked over directly at the root
+    while( slot != index ) {
+        auto next = m_ivars[slot].alias;
+        m_ivars[slot].alias = index;
+        slot = next;
+    }
+    return index;
+}
+HMTypeInferrence::IVar& HMTypeInferrence::get_pointed_ivar(unsigned int slot) const
+{
+    return const_cast<IVar&>(m_ivars[this->get_root_index(slot)]);
 }
 
 bool HMTypeInferrence::pathparams_contain_ivars(const ::HIR::PathParams& pps) const {
@@ -1467,30 +1481,17 @@ void TraitResolution::compact_ivars(HMTypeInferrence& m_ivars)
     for(auto& v : m_ivars.m_ivars)
     {
         if( !v.is_alias() ) {
-            m_ivars.expand_ivars( *v.type );
+            m_ivars.expand_ivars( v.type );
             // Don't expand unless it is needed
-            if( this->has_associated_type(*v.type) ) {
+            if( this->has_associated_type(v.type) ) {
                 // TODO: cloning is expensive, BUT printing below is nice
-                auto nt = this->expand_associated_types(Span(), v.type->clone());
-                DEBUG("- " << i << " " << *v.type << " -> " << nt);
-                *v.type = mv$(nt);
+                auto nt = this->expand_associated_types(Span(), v.type.clone());
+                DEBUG("- " << i << " " << v.type << " -> " << nt);
+                v.type = mv$(nt);
             }
         }
         else {
-
-            auto index = v.alias;
-            unsigned int count = 0;
-            assert(index < m_ivars.m_ivars.size());
-            while( m_ivars.m_ivars.at(index).is_alias() ) {
-                index = m_ivars.m_ivars.at(index).alias;
-
-                if( count >= m_ivars.m_ivars.size() ) {
-                    this->m_ivars.dump();
-                    BUG(Span(), "Loop detected in ivar list when starting at " << v.alias << ", current is " << index);
-                }
-                count ++;
-            }
-            v.alias = index;
+            v.alias = m_ivars.get_root_index(v.alias);
         }
         i ++;
     }
@@ -3464,8 +3465,142 @@ const ::HIR::TypeRef* TraitResolution::autoderef(const Span& sp, const ::HIR::Ty
     }
 }
 
-//unsigned int TraitResolution::autoderef_find_method(const Span& sp, const HIR::t_trait_list& traits, const ::std::vector<unsigned>& ivars, const ::HIR::TypeRef& top_ty, const ::std::string& method_name,  /* Out -> */::std::vector<AutoderefBorrow,::HIR::Path>& possibilities) const
+namespace {
+    /// Crate-wide memo of method lookups on receivers with no inference variables or generics (owned by the crate)
+    struct MethodCache:
+        public ::HIR::CrateCache
+    {
+        struct Key
+        {
+            ::HIR::TypeRef  ty;
+            ::std::string   name;
+            ::std::vector<const ::HIR::Trait*>  traits;
+
+            bool operator<(const Key& x) const {
+                if( name != x.name )    return name < x.name;
+                if( traits != x.traits )    return traits < x.traits;
+                return ty < x.ty;
+            }
+        };
+        struct Ent
+        {
+            unsigned int    deref_count;
+            TraitResolution::AutoderefBorrow    borrow;
+            ::HIR::Path fcn_path;
+        };
+
+        ::std::map<Key, Ent>    ents;
+    };
+}
+bool TraitResolution::method_cache_usable(const ::HIR::TypeRef& ty) const
+{
+    // Bounds on concrete types would be searched before impls, so could change the result
+    const ::HIR::GenericParams* v[2] = { m_item_params, m_impl_params };
+    for(auto p : v)
+    {
+        if( !p )    continue ;
+        for(const auto& b : p->m_bounds)
+        {
+            if( const auto* be = b.opt_TraitBound() ) {
+                if( !visit_ty_with(be->type, [](const auto& t){ return t.m_data.is_Generic(); }) )
+                    return false;
+            }
+        }
+    }
+    return !visit_ty_with(ty, [](const ::HIR::TypeRef& t)->bool {
+        TU_MATCH_DEF(::HIR::TypeRef::Data, (t.m_data), (te),
+        (
+            return false;
+            ),
+        (Infer,
+            return true;
+            ),
+        (Generic,
+            return true;
+            ),
+        (ErasedType,
+            return true;
+            ),
+        (Closure,
+            return true;
+            ),
+        (Path,
+            return !te.binding.is_Struct() && !te.binding.is_Enum() && !te.binding.is_Union();
+            )
+        )
+        });
+}
 unsigned int TraitResolution::autoderef_find_method(const Span& sp, const HIR::t_trait_list& traits, const ::std::vector<unsigned>& ivars, const ::HIR::TypeRef& top_ty, const ::std::string& method_name,  /* Out -> */::HIR::Path& fcn_path, AutoderefBorrow& borrow) const
+{
+    if( this->m_ivars.type_contains_ivars(top_ty) )
+        return autoderef_find_method_inner(sp, traits, ivars, top_ty, method_name,  fcn_path, borrow);
+
+    MethodCache::Key    key;
+    ::std::function<bool(const ::HIR::TypeRef&, ::HIR::TypeRef&)>   cb_resolve = [&](const ::HIR::TypeRef& t, ::HIR::TypeRef& out)->bool {
+        if( !t.m_data.is_Infer() )
+            return false;
+        const auto& rt = this->m_ivars.get_type(t);
+        if( rt.m_data.is_Infer() )
+            return false;
+        out = clone_ty_with(sp, rt, cb_resolve);
+        return true;
+        };
+    key.ty = clone_ty_with(sp, top_ty, cb_resolve);
+    if( !this->method_cache_usable(key.ty) )
+        return autoderef_find_method_inner(sp, traits, ivars, top_ty, method_name,  fcn_path, borrow);
+    key.name = method_name;
+    key.traits.reserve(traits.size());
+    for(const auto& t : traits)
+        key.traits.push_back(t.second);
+
+    {
+        auto cache = m_crate.get_cache<MethodCache>();
+        auto it = cache->ents.find(key);
+        if( it != cache->ents.end() )
+        {
+            const auto& ent = it->second;
+            fcn_path = ent.fcn_path.clone();
+            borrow = ent.borrow;
+            DEBUG("Cached {" << key.ty << "}." << method_name << " = " << fcn_path);
+            return ent.deref_count;
+        }
+    }
+
+    auto rv = autoderef_find_method_inner(sp, traits, ivars, top_ty, method_name,  fcn_path, borrow);
+    if( rv == ~0u )
+        return rv;
+
+    // Only cache if the result has no inference variables at all
+    // - A result that refers to the call's trait parameter ivars would tie later calls to this call's ivars
+    auto is_infer = [](const ::HIR::TypeRef& t){ return t.m_data.is_Infer(); };
+    TU_MATCH_DEF(::HIR::Path::Data, (fcn_path.m_data), (pe),
+    (
+        return rv;
+        ),
+    (UfcsInherent,
+        if( visit_ty_with(*pe.type, is_infer) )
+            return rv;
+        for(const auto& t : pe.params.m_types)
+            if( visit_ty_with(t, is_infer) )
+                return rv;
+        ),
+    (UfcsKnown,
+        if( visit_ty_with(*pe.type, is_infer) )
+            return rv;
+        for(const auto& t : pe.trait.m_params.m_types)
+            if( visit_ty_with(t, is_infer) )
+                return rv;
+        for(const auto& t : pe.params.m_types)
+            if( visit_ty_with(t, is_infer) )
+                return rv;
+        )
+    )
+
+    m_crate.get_cache<MethodCache>()->ents.insert(::std::make_pair( mv$(key), MethodCache::Ent { rv, borrow, fcn_path.clone() } ));
+    return rv;
+}
+//unsigned int TraitResolution::autoderef_find_method(const Span& sp, const HIR::t_trait_list& traits, const ::std::vector<unsigned>& ivars, const ::HIR::TypeRef& top_ty, const ::std::string& method_name,  /* Out -> */::std::vector<AutoderefBorrow,::HIR::Path>& possibilities) const
+unsigned int TraitResolution::autoderef_find_method_inner(const Span& sp, const HIR::t_trait_list& traits, const ::std::vector<unsigned>& ivars, const ::HIR::TypeRef& top_ty, const ::std::string& method_name,  /* Out -> */::HIR::Path& fcn_path, AutoderefBorrow& borrow) const
 {
     TRACE_FUNCTION_F("{" << top_ty << "}." << method_name);
     unsigned int deref_count = 0;
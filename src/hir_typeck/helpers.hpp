@@ -9,6 +9,7 @@
 
 #include <hir/hir.hpp>
 #include <hir/expr.hpp> // t_trait_list
+#include <deque>
 
 #include "common.hpp"
 
@@ -55,19 +56,25 @@ public:
     };
 
 public: // ?? - Needed once, anymore?
+    /// Union-find node for an inference variable
     struct IVar
     {
-        unsigned int alias; // If not ~0, this points to another ivar
-        ::std::unique_ptr< ::HIR::TypeRef> type;    // Type (only nullptr if alias!=0)
+        /// If not ~0, this points to another ivar (compressed towards the root on lookup)
+        mutable unsigned int alias;
+        /// Upper bound on the height of the alias tree rooted here
+        unsigned int rank;
+        /// Type (unused if alias!=~0)
+        ::HIR::TypeRef  type;
 
         IVar():
             alias(~0u),
-            type(new ::HIR::TypeRef())
+            rank(0)
         {}
         bool is_alias() const { return alias != ~0u; }
     };
 
-    ::std::vector< IVar>    m_ivars;
+    // NOTE: deque so references returned by `get_type` stay valid when new ivars are added
+    ::std::deque< IVar>    m_ivars;
     bool    m_has_changed;
 
 public:
@@ -126,6 +133,7 @@ public:
     void ivar_unify(unsigned int left_slot, unsigned int right_slot);
 
     // Lookup
+    unsigned int get_root_index(unsigned int slot) const;
     ::HIR::TypeRef& get_type(::HIR::TypeRef& type);
     const ::HIR::TypeRef& get_type(const ::HIR::TypeRef& type) const;
 
@@ -243,6 +251,10 @@ public:
     /// Locate the named method by applying auto-dereferencing.
     /// \return Number of times deref was applied (or ~0 if _ was hit)
     unsigned int autoderef_find_method(const Span& sp, const HIR::t_trait_list& traits, const ::std::vector<unsigned>& ivars, const ::HIR::TypeRef& top_ty, const ::std::string& method_name,  /* Out -> */::HIR::Path& fcn_path, AutoderefBorrow& borrow) const;
+private:
+    unsigned int autoderef_find_method_inner(const Span& sp, const HIR::t_trait_list& traits, const ::std::vector<unsigned>& ivars, const ::HIR::TypeRef& top_ty, const ::std::string& method_name,  /* Out -> */::HIR::Path& fcn_path, AutoderefBorrow& borrow) const;
+    bool method_cache_usable(const ::HIR::TypeRef& ty) const;
+public:
     /// Locate the named field by applying auto-dereferencing.
     /// \return Number of times deref was applied (or ~0 if _ was hit)
     unsigned int autoderef_find_field(const Span& sp, const ::HIR::TypeRef& top_ty, const ::std::string& name,  /* Out -> */::HIR::TypeRef& field_type) const;
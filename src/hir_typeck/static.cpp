@@ -7,6 +7,91 @@
  */
 #include "static.hpp"
 #include <algorithm>
+#include <trans/target.hpp>    // TypeRepr (for the layout cache)
+
+bool StaticTraitResolveCache::type_is_concrete(const ::HIR::TypeRef& ty)
+{
+    return !visit_ty_with(ty, [](const ::HIR::TypeRef& t)->bool {
+        TU_MATCH_DEF(::HIR::TypeRef::Data, (t.m_data), (te),
+        (
+            return false;
+            ),
+        (Generic,
+            return true;
+            ),
+        (Infer,
+            return true;
+            ),
+        (ErasedType,
+            return true;
+            ),
+        (Closure,
+            return true;
+            ),
+        (Path,
+            return te.binding.is_Opaque();
+            )
+        )
+        });
+}
+bool StaticTraitResolveCache::get_is_copy(const ::HIR::TypeRef& ty, bool& out) const
+{
+    auto it = m_is_copy.find(ty);
+    if( it == m_is_copy.end() )
+        return false;
+    out = it->second;
+    return true;
+}
+void StaticTraitResolveCache::set_is_copy(const ::HIR::TypeRef& ty, bool v)
+{
+    m_is_copy.insert(::std::make_pair( ty.clone(), v ));
+}
+bool StaticTraitResolveCache::get_needs_drop_glue(const ::HIR::TypeRef& ty, bool& out) const
+{
+    auto it = m_needs_drop_glue.find(ty);
+    if( it == m_needs_drop_glue.end() )
+        return false;
+    out = it->second;
+    return true;
+}
+void StaticTraitResolveCache::set_needs_drop_glue(const ::HIR::TypeRef& ty, bool v)
+{
+    m_needs_drop_glue.insert(::std::make_pair( ty.clone(), v ));
+}
+bool StaticTraitResolveCache::get_assoc_type(const ::HIR::TypeRef& ty, ::HIR::TypeRef& out_ty, bool& out_rv) const
+{
+    auto it = m_assoc_types.find(ty);
+    if( it == m_assoc_types.end() )
+        return false;
+    out_ty = it->second.first.clone();
+    out_rv = it->second.second;
+    return true;
+}
+void StaticTraitResolveCache::set_assoc_type(const ::HIR::TypeRef& ty, const ::HIR::TypeRef& res_ty, bool rv)
+{
+    m_assoc_types.insert(::std::make_pair( ty.clone(), ::std::make_pair(res_ty.clone(), rv) ));
+}
+
+StaticTraitResolve::StaticTraitResolve(const ::HIR::Crate& crate):
+    m_crate(crate),
+    m_impl_generics(nullptr),
+    m_item_generics(nullptr)
+{
+    m_lang_Copy = m_crate.get_lang_item_path_opt("copy");
+    m_lang_Drop = m_crate.get_lang_item_path_opt("drop");
+    m_lang_Sized = m_crate.get_lang_item_path_opt("sized");
+    m_lang_Unsize = m_crate.get_lang_item_path_opt("unsize");
+    m_lang_Fn = m_crate.get_lang_item_path_opt("fn");
+    m_lang_FnMut = m_crate.get_lang_item_path_opt("fn_mut");
+    m_lang_FnOnce = m_crate.get_lang_item_path_opt("fn_once");
+    m_lang_Box = m_crate.get_lang_item_path_opt("owned_box");
+    m_lang_PhantomData = m_crate.get_lang_item_path_opt("phantom_data");
+    m_lang_UnsafeCell = m_crate.get_lang_item_path_opt("unsafe_cell");
+    prep_indexes();
+}
+StaticTraitResolve::~StaticTraitResolve()
+{
+}
 
 void StaticTraitResolve::prep_indexes()
 {
@@ -1158,6 +1243,19 @@ bool StaticTraitResolve::expand_associated_types__UfcsKnown(const Span& sp, ::HI
 
     // 2. Crate-level impls
 
+    // - Concrete types resolve the same way everywhere, so check the crate-wide cache first
+    ::HIR::TypeRef  cache_key;
+    if( recurse && StaticTraitResolveCache::type_is_concrete(input) )
+    {
+        bool cached_rv;
+        if( m_crate.get_cache<StaticTraitResolveCache>()->get_assoc_type(input, cache_key, cached_rv) ) {
+            DEBUG("Cached " << input << " = " << cache_key);
+            input = mv$(cache_key);
+            return cached_rv;
+        }
+        cache_key = input.clone();
+    }
+
     // - Search for the actual trait containing this associated type
     ::HIR::GenericPath  trait_path;
     if( !this->trait_contains_type(sp, e2.trait, this->m_crate.get_trait_by_path(sp, e2.trait.m_path), e2.item, trait_path) )
@@ -1215,6 +1313,9 @@ bool StaticTraitResolve::expand_associated_types__UfcsKnown(const Span& sp, ::HI
     if( rv ) {
         if( recurse )
             this->expand_associated_types(sp, input);
+        // NOTE: Opaque results may have been replaced using local equalities, so aren't cached
+        if( cache_key != ::HIR::TypeRef() && StaticTraitResolveCache::type_is_concrete(input) )
+            m_crate.get_cache<StaticTraitResolveCache>()->set_assoc_type(cache_key, input, replacement_happened);
         return replacement_happened;
     }
     if( best_impl.is_valid() ) {
@@ -1381,6 +1482,14 @@ bool StaticTraitResolve::type_is_copy(const Span& sp, const ::HIR::TypeRef& ty)
         return rv;
         ),
     (Path,
+        bool is_concrete = StaticTraitResolveCache::type_is_concrete(ty);
+        if( is_concrete )
+        {
+            bool rv;
+            if( m_crate.get_cache<StaticTraitResolveCache>()->get_is_copy(ty, rv) )
+                return rv;
+        }
+        else
         {
             auto it = m_copy_cache.find(ty);
             if( it != m_copy_cache.end() )
@@ -1388,7 +1497,10 @@ bool StaticTraitResolve::type_is_copy(const Span& sp, const ::HIR::TypeRef& ty)
         }
         auto pp = ::HIR::PathParams();
         bool rv = this->find_impl(sp, m_lang_Copy, &pp, ty, [&](auto , bool){ return true; }, true);
-        m_copy_cache.insert(::std::make_pair( ty.clone(), rv ));
+        if( is_concrete )
+            m_crate.get_cache<StaticTraitResolveCache>()->set_is_copy(ty, rv);
+        else
+            m_copy_cache.insert(::std::make_pair( ty.clone(), rv ));
         return rv;
         ),
     (Diverge,
@@ -1752,84 +1864,17 @@ bool StaticTraitResolve::type_needs_drop_glue(const Span& sp, const ::HIR::TypeR
         if( e.binding.is_Opaque() )
             return true;
 
-        auto pp = ::HIR::PathParams();
-        bool has_direct_drop = this->find_impl(sp, m_lang_Drop, &pp, ty, [&](auto , bool){ return true; }, true);
-        if( has_direct_drop )
-            return true;
-
-        ::HIR::TypeRef  tmp_ty;
-        const auto& pe = e.path.m_data.as_Generic();
-        auto monomorph_cb = monomorphise_type_get_cb(sp, nullptr, &pe.m_params, nullptr, nullptr);
-        auto monomorph = [&](const auto& tpl)->const ::HIR::TypeRef& {
-            if( monomorphise_type_needed(tpl) ) {
-                tmp_ty = monomorphise_type_with(sp, tpl, monomorph_cb, false);
-                this->expand_associated_types(sp, tmp_ty);
-                return tmp_ty;
-            }
-            else {
-                return tpl;
-            }
-            };
-        TU_MATCHA( (e.binding), (pbe),
-        (Unbound,
-            BUG(sp, "Unbound path");
-            ),
-        (Opaque,
-            // Technically a bug, checked above
-            return true;
-            ),
-        (Struct,
-            TU_MATCHA( (pbe->m_data), (se),
-            (Unit,
-                ),
-            (Tuple,
-                for(const auto& e : se)
-                {
-                    if( type_needs_drop_glue(sp, monomorph(e.ent)) )
-                        return true;
-                }
-                ),
-            (Named,
-                for(const auto& e : se)
-                {
-                    if( type_needs_drop_glue(sp, monomorph(e.second.ent)) )
-                        return true;
-                }
-                )
-            )
-            return false;
-            ),
-        (Enum,
-            for(const auto& e : pbe->m_variants)
-            {
-                TU_MATCHA( (e.second), (ve),
-                (Unit,
-                    ),
-                (Value,
-                    ),
-                (Tuple,
-                    for(const auto& e : ve)
-                    {
-                        if( type_needs_drop_glue(sp, monomorph(e.ent)) )
-                            return true;
-                    }
-                    ),
-                (Struct,
-                    for(const auto& e : ve)
-                    {
-                        if( type_needs_drop_glue(sp, monomorph(e.second.ent)) )
-                            return true;
-                    }
-                    )
-                )
-            }
-            return false;
-            ),
-        (Union,
-            // Unions don't have drop glue unless they impl Drop
-            return false;
-            )
-        )
+        bool is_concrete = StaticTraitResolveCache::type_is_concrete(ty);
+        if( is_concrete )
+        {
+            bool rv;
+            if( m_crate.get_cache<StaticTraitResolveCache>()->get_needs_drop_glue(ty, rv) )
+                return rv;
+            rv = type_needs_drop_glue__path(sp, ty);
+            m_crate.get_cache<StaticTraitResolveCache>()->set_needs_drop_glue(ty, rv);
+            return rv;
+        }
+        return type_needs_drop_glue__path(sp, ty);
         ),
     (Diverge,
         return false;
@@ -1883,6 +1928,242 @@ bool StaticTraitResolve::type_needs_drop_glue(const Span& sp, const ::HIR::TypeR
     throw "";
 }
 
+bool StaticTraitResolve::type_needs_drop_glue__path(const Span& sp, const ::HIR::TypeRef& ty) const
+{
+    const auto& e = ty.m_data.as_Path();
+
+    auto pp = ::HIR::PathParams();
+    bool has_direct_drop = this->find_impl(sp, m_lang_Drop, &pp, ty, [&](auto , bool){ return true; }, true);
+    if( has_direct_drop )
+        return true;
+
+    ::HIR::TypeRef  tmp_ty;
+    const auto& pe = e.path.m_data.as_Generic();
+    auto monomorph_cb = monomorphise_type_get_cb(sp, nullptr, &pe.m_params, nullptr, nullptr);
+    auto monomorph = [&](const auto& tpl)->const ::HIR::TypeRef& {
+        if( monomorphise_type_needed(tpl) ) {
+            tmp_ty = monomorphise_type_with(sp, tpl, monomorph_cb, false);
+            this->expand_associated_types(sp, tmp_ty);
+            return tmp_ty;
+        }
+        else {
+            return tpl;
+        }
+        };
+    TU_MATCHA( (e.binding), (pbe),
+    (Unbound,
+        BUG(sp, "Unbound path");
+        ),
+    (Opaque,
+        // Technically a bug, checked above
+        return true;
+        ),
+    (Struct,
+        TU_MATCHA( (pbe->m_data), (se),
+        (Unit,
+            ),
+        (Tuple,
+            for(const auto& e : se)
+            {
+                if( type_needs_drop_glue(sp, monomorph(e.ent)) )
+                    return true;
+            }
+            ),
+        (Named,
+            for(const auto& e : se)
+            {
+                if( type_needs_drop_glue(sp, monomorph(e.second.ent)) )
+                    return true;
+            }
+            )
+        )
+        return false;
+        ),
+    (Enum,
+        for(const auto& e : pbe->m_variants)
+        {
+            TU_MATCHA( (e.second), (ve),
+            (Unit,
+                ),
+            (Value,
+                ),
+            (Tuple,
+                for(const auto& e : ve)
+                {
+                    if( type_needs_drop_glue(sp, monomorph(e.ent)) )
+                        return true;
+                }
+                ),
+            (Struct,
+                for(const auto& e : ve)
+                {
+                    if( type_needs_drop_glue(sp, monomorph(e.second.ent)) )
+                        return true;
+                }
+                )
+            )
+        }
+        return false;
+        ),
+    (Union,
+        // Unions don't have drop glue unless they impl Drop
+        return false;
+        )
+    )
+    throw "";
+}
+
+bool StaticTraitResolve::type_is_freeze(const Span& sp, const ::HIR::TypeRef& ty) const
+{
+    TU_MATCH(::HIR::TypeRef::Data, (ty.m_data), (e),
+    (Generic,
+        return false;
+        ),
+    (Path,
+        if( !e.path.m_data.is_Generic() || e.binding.is_Opaque() || e.binding.is_Unbound() )
+            return false;
+        if( e.path.m_data.as_Generic().m_path == m_lang_UnsafeCell )
+            return false;
+        auto it = m_freeze_cache.find(ty);
+        if( it != m_freeze_cache.end() )
+            return it->second;
+        auto rv = type_is_freeze__path(sp, ty);
+        m_freeze_cache.insert(::std::make_pair( ty.clone(), rv ));
+        return rv;
+        ),
+    (Diverge,
+        return true;
+        ),
+    (Closure,
+        return false;
+        ),
+    (Infer,
+        BUG(sp, "type_is_freeze on _");
+        ),
+    (Borrow,
+        // Only the pointer itself is part of the value
+        if( e.type != ::HIR::BorrowType::Owned )
+            return true;
+        return type_is_freeze(sp, *e.inner);
+        ),
+    (Pointer,
+        return true;
+        ),
+    (Function,
+        return true;
+        ),
+    (Primitive,
+        return true;
+        ),
+    (Array,
+        return type_is_freeze(sp, *e.inner);
+        ),
+    (Slice,
+        return type_is_freeze(sp, *e.inner);
+        ),
+    (TraitObject,
+        return false;
+        ),
+    (ErasedType,
+        return false;
+        ),
+    (Tuple,
+        for(const auto& ty : e)
+        {
+            if( !type_is_freeze(sp, ty) )
+                return false;
+        }
+        return true;
+        )
+    )
+    throw "";
+}
+bool StaticTraitResolve::type_is_freeze__path(const Span& sp, const ::HIR::TypeRef& ty) const
+{
+    const auto& e = ty.m_data.as_Path();
+    const auto& pe = e.path.m_data.as_Generic();
+
+    ::HIR::TypeRef  tmp_ty;
+    auto monomorph_cb = monomorphise_type_get_cb(sp, nullptr, &pe.m_params, nullptr, nullptr);
+    auto monomorph = [&](const auto& tpl)->const ::HIR::TypeRef& {
+        if( monomorphise_type_needed(tpl) ) {
+            tmp_ty = monomorphise_type_with(sp, tpl, monomorph_cb, false);
+            this->expand_associated_types(sp, tmp_ty);
+            return tmp_ty;
+        }
+        else {
+            return tpl;
+        }
+        };
+    auto check_struct_data = [&](const ::HIR::Struct::Data& data)->bool {
+        TU_MATCHA( (data), (se),
+        (Unit,
+            ),
+        (Tuple,
+            for(const auto& e : se)
+            {
+                if( !type_is_freeze(sp, monomorph(e.ent)) )
+                    return false;
+            }
+            ),
+        (Named,
+            for(const auto& e : se)
+            {
+                if( !type_is_freeze(sp, monomorph(e.second.ent)) )
+                    return false;
+            }
+            )
+        )
+        return true;
+        };
+    TU_MATCHA( (e.binding), (pbe),
+    (Unbound,
+        BUG(sp, "Unbound path");
+        ),
+    (Opaque,
+        return false;
+        ),
+    (Struct,
+        return check_struct_data(pbe->m_data);
+        ),
+    (Enum,
+        for(const auto& v : pbe->m_variants)
+        {
+            TU_MATCHA( (v.second), (ve),
+            (Unit,
+                ),
+            (Value,
+                ),
+            (Tuple,
+                for(const auto& e : ve)
+                {
+                    if( !type_is_freeze(sp, monomorph(e.ent)) )
+                        return false;
+                }
+                ),
+            (Struct,
+                for(const auto& e : ve)
+                {
+                    if( !type_is_freeze(sp, monomorph(e.second.ent)) )
+                        return false;
+                }
+                )
+            )
+        }
+        return true;
+        ),
+    (Union,
+        for(const auto& v : pbe->m_variants)
+        {
+            if( !type_is_freeze(sp, monomorph(v.second.ent)) )
+                return false;
+        }
+        return true;
+        )
+    )
+    throw "";
+}
+
 const ::HIR::TypeRef* StaticTraitResolve::is_type_owned_box(const ::HIR::TypeRef& ty) const
 {
     if( ! ty.m_data.is_Path() ) {
@@ -11,6 +11,30 @@
 #include "common.hpp"
 #include "impl_ref.hpp"
 
+struct TypeRepr;
+
+/// Crate-wide memo of trait resolution results for fully concrete types (owned by the crate, see `Crate::get_cache`)
+/// - These don't depend on the generic context, so are shared between all StaticTraitResolve instances
+class StaticTraitResolveCache:
+    public ::HIR::CrateCache
+{
+    ::std::map< ::HIR::TypeRef, bool>   m_is_copy;
+    ::std::map< ::HIR::TypeRef, bool>   m_needs_drop_glue;
+    /// `<T as Trait>::Type` => (expanded type, replacement_happened)
+    ::std::map< ::HIR::TypeRef, ::std::pair< ::HIR::TypeRef, bool> >  m_assoc_types;
+
+public:
+    /// Returns true if the type contains no generics, inference variables, or opaque/erased types
+    static bool type_is_concrete(const ::HIR::TypeRef& ty);
+
+    bool get_is_copy(const ::HIR::TypeRef& ty, bool& out) const;
+    void set_is_copy(const ::HIR::TypeRef& ty, bool v);
+    bool get_needs_drop_glue(const ::HIR::TypeRef& ty, bool& out) const;
+    void set_needs_drop_glue(const ::HIR::TypeRef& ty, bool v);
+    bool get_assoc_type(const ::HIR::TypeRef& ty, ::HIR::TypeRef& out_ty, bool& out_rv) const;
+    void set_assoc_type(const ::HIR::TypeRef& ty, const ::HIR::TypeRef& res_ty, bool rv);
+};
+
 class StaticTraitResolve
 {
 public:
@@ -22,6 +46,9 @@ public:
 
     ::std::map< ::HIR::TypeRef, ::HIR::TypeRef> m_type_equalities;
 
+    /// Layouts of concrete types, filled by `Target_GetTypeRepr` (freed along with this resolver)
+    mutable ::std::map< ::HIR::TypeRef, ::std::unique_ptr<TypeRepr> >  m_type_repr_cache;
+
     ::HIR::SimplePath   m_lang_Copy;
     ::HIR::SimplePath   m_lang_Drop;
     ::HIR::SimplePath   m_lang_Sized;
@@ -31,27 +58,15 @@ public:
     ::HIR::SimplePath   m_lang_FnOnce;
     ::HIR::SimplePath   m_lang_Box;
     ::HIR::SimplePath   m_lang_PhantomData;
+    ::HIR::SimplePath   m_lang_UnsafeCell;
 
 private:
     mutable ::std::map< ::HIR::TypeRef, bool >  m_copy_cache;
+    mutable ::std::map< ::HIR::TypeRef, bool >  m_freeze_cache;
 
 public:
-    StaticTraitResolve(const ::HIR::Crate& crate):
-        m_crate(crate),
-        m_impl_generics(nullptr),
-        m_item_generics(nullptr)
-    {
-        m_lang_Copy = m_crate.get_lang_item_path_opt("copy");
-        m_lang_Drop = m_crate.get_lang_item_path_opt("drop");
-        m_lang_Sized = m_crate.get_lang_item_path_opt("sized");
-        m_lang_Unsize = m_crate.get_lang_item_path_opt("unsize");
-        m_lang_Fn = m_crate.get_lang_item_path_opt("fn");
-        m_lang_FnMut = m_crate.get_lang_item_path_opt("fn_mut");
-        m_lang_FnOnce = m_crate.get_lang_item_path_opt("fn_once");
-        m_lang_Box = m_crate.get_lang_item_path_opt("owned_box");
-        m_lang_PhantomData = m_crate.get_lang_item_path_opt("phantom_data");
-        prep_indexes();
-    }
+    StaticTraitResolve(const ::HIR::Crate& crate);
+    ~StaticTraitResolve();
 
 private:
     void prep_indexes();
@@ -183,6 +198,15 @@ public:
 
     /// Returns `true` if the passed type either implements Drop, or contains a type that implements Drop
     bool type_needs_drop_glue(const Span& sp, const ::HIR::TypeRef& ty) const;
+private:
+    bool type_needs_drop_glue__path(const Span& sp, const ::HIR::TypeRef& ty) const;
+public:
+    /// Returns `true` if the type has no interior mutability (doesn't directly contain an `UnsafeCell`)
+    /// - Conservative, returns `false` for types that aren't known (generics, trait objects, ...)
+    bool type_is_freeze(const Span& sp, const ::HIR::TypeRef& ty) const;
+private:
+    bool type_is_freeze__path(const Span& sp, const ::HIR::TypeRef& ty) const;
+public:
 
     const ::HIR::TypeRef* is_type_owned_box(const ::HIR::TypeRef& ty) const;
     const ::HIR::TypeRef* is_type_phantom_data(const ::HIR::TypeRef& ty) const;
@@ -6,26 +6,86 @@
  * - Identifiers with hygiene
  */
 #include <iostream>
+#include <unordered_map>
+#include <cstdint>
+#include <algorithm>
 #include <ident.hpp>
 #include <debug.hpp>
 #include <common.hpp>   // vector print
 
-unsigned int Ident::Hygiene::g_next_scope = 0;
+namespace {
+    /// A node in the hygiene context tree
+    struct HygieneNode
+    {
+        unsigned int    parent;
+        /// Number of scopes in the chain (including this one)
+        unsigned int    depth;
+    };
+    /// Shared tree of all hygiene contexts, index 0 is the empty root context
+    ::std::vector<HygieneNode>  g_hygiene_nodes { HygieneNode { 0, 0 } };
+    /// Cache of `is_visible` results for contexts with long chains (keyed on `(target << 32) | source`)
+    ::std::unordered_map<uint64_t, bool>    g_hygiene_visible_cache;
+}
+
+Ident::Hygiene Ident::Hygiene::new_scope()
+{
+    g_hygiene_nodes.push_back( HygieneNode { 0, 1 } );
+    return Hygiene(g_hygiene_nodes.size() - 1);
+}
+Ident::Hygiene Ident::Hygiene::new_scope_chained(const Hygiene& parent)
+{
+    unsigned int depth = g_hygiene_nodes[parent.m_index].depth + 1;
+    g_hygiene_nodes.push_back( HygieneNode { parent.m_index, depth } );
+    return Hygiene(g_hygiene_nodes.size() - 1);
+}
+Ident::Hygiene Ident::Hygiene::get_parent() const
+{
+    //assert(this->m_index != 0);
+    return Hygiene(g_hygiene_nodes[m_index].parent);
+}
+
+void Ident::Hygiene::release_caches()
+{
+    // NOTE: The nodes themselves are kept, exported macros still reference them
+    g_hygiene_visible_cache = ::std::unordered_map<uint64_t, bool>();
+}
 
 bool Ident::Hygiene::is_visible(const Hygiene& src) const
 {
     // HACK: Disable hygiene for now
     //return true;
 
-    if( this->contexts.size() == 0 ) {
-        return src.contexts.size() == 0;
+    // The root context is only visible to itself
+    if( this->m_index == 0 ) {
+        return src.m_index == 0;
+    }
+    if( this->m_index == src.m_index ) {
+        return true;
+    }
+
+    // Visible if this context's scope is within the source's chain (i.e. this node is an ancestor of the source)
+    const auto des_depth = g_hygiene_nodes[this->m_index].depth;
+    const auto src_depth = g_hygiene_nodes[src.m_index].depth;
+    if( src_depth <= des_depth ) {
+        return false;
+    }
+    auto walk = [&]()->bool {
+        auto idx = src.m_index;
+        while( g_hygiene_nodes[idx].depth > des_depth )
+            idx = g_hygiene_nodes[idx].parent;
+        return idx == this->m_index;
+        };
+    // - Short walks are cheaper than a cache lookup
+    if( src_depth - des_depth <= 4 ) {
+        return walk();
     }
 
-    auto des = this->contexts.back();
-    for(const auto& c : src.contexts)
-        if( des == c )
-            return true;
-    return false;
+    auto key = (static_cast<uint64_t>(this->m_index) << 32) | src.m_index;
+    auto it = g_hygiene_visible_cache.find(key);
+    if( it == g_hygiene_visible_cache.end() ) {
+        it = g_hygiene_visible_cache.insert( ::std::make_pair(key, walk()) ).first;
+    }
+    return it->second;
 }
 
 ::std::ostream& operator<<(::std::ostream& os, const Ident& x) {
@@ -34,7 +94,12 @@ bool Ident::Hygiene::is_visible(const Hygiene& src) const
 }
 
 ::std::ostream& operator<<(::std::ostream& os, const Ident::Hygiene& x) {
-    os << "{" << x.contexts << "}";
+    // Print the full chain of scopes (outermost first)
+    ::std::vector<unsigned int> contexts;
+    for(auto idx = x.m_index; idx != 0; idx = g_hygiene_nodes[idx].parent)
+        contexts.push_back(idx);
+    ::std::reverse(contexts.begin(), contexts.end());
+    os << "{" << contexts << "}";
     return os;
 }
 
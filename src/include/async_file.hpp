@@ -0,0 +1,25 @@
+/*
+ * MRustC - Rust Compiler
+ * - By John Hodge (Mutabah/thePowersGang)
+ *
+ * include/async_file.hpp
+ * - Buffered output file written by a background thread (used for debug dumps)
+ */
+#pragma once
+
+#include <ostream>
+#include <memory>
+#include <string>
+
+/// Output file stream that hands full buffers to a background thread for writing
+/// - The destructor flushes any remaining data and waits for the writer to finish
+class AsyncOutputFile:
+    public ::std::ostream
+{
+    class Buffer;
+    ::std::unique_ptr<Buffer>   m_buf;
+public:
+    AsyncOutputFile(const ::std::string& path);
+    AsyncOutputFile(const AsyncOutputFile&) = delete;
+    ~AsyncOutputFile();
+};
@@ -0,0 +1,42 @@
+/*
+ * MRustC - Rust Compiler
+ * - By John Hodge (Mutabah/thePowersGang)
+ *
+ * include/function_ref.hpp
+ * - Non-owning reference to a callable
+ */
+#pragma once
+#include <type_traits>
+#include <memory>   // addressof
+
+template<typename Sig> class FunctionRef;
+
+/// Non-owning, non-allocating reference to a callable (cheaper than `::std::function` for callback arguments)
+///
+/// NOTE: Only holds a pointer to the callable, so must not outlive it. This is fine for function arguments (temporaries
+/// live until the end of the full expression), but a `FunctionRef` must not be stored or returned. Use `::std::function`
+/// for that.
+template<typename Rv, typename... Args>
+class FunctionRef<Rv(Args...)>
+{
+    void*   m_obj;
+    Rv  (*m_call)(void* obj, Args... args);
+
+    template<typename F>
+    static Rv call_obj(void* obj, Args... args) {
+        return (*static_cast<F*>(obj))( ::std::forward<Args>(args)... );
+    }
+public:
+    template<typename F, typename = typename ::std::enable_if< !::std::is_same<typename ::std::decay<F>::type, FunctionRef>::value >::type>
+    FunctionRef(F&& f):
+        m_obj( const_cast<void*>(static_cast<const void*>(::std::addressof(f))) ),
+        m_call( &call_obj<typename ::std::remove_reference<F>::type> )
+    {
+    }
+    FunctionRef(const FunctionRef& ) = default;
+    FunctionRef& operator=(const FunctionRef& ) = default;
+
+    Rv operator()(Args... args) const {
+        return m_call(m_obj, ::std::forward<Args>(args)...);
+    }
+};
@@ -13,37 +13,23 @@ struct Ident
 {
     class Hygiene
     {
-        static unsigned g_next_scope;
-
-        ::std::vector<unsigned int> contexts;
+        /// Index into the shared tree of hygiene contexts (see ident.cpp)
+        /// - Zero is the root (no context), each other node is a single scope chained to a parent node
+        unsigned int m_index;
 
         Hygiene(unsigned int index):
-            contexts({index})
+            m_index(index)
         {}
     public:
         Hygiene():
-            contexts({})
+            m_index(0)
         {}
 
-        static Hygiene new_scope()
-        {
-            return Hygiene(++g_next_scope);
-        }
-        static Hygiene new_scope_chained(const Hygiene& parent)
-        {
-            Hygiene rv;
-            rv.contexts.reserve( parent.contexts.size() + 1 );
-            rv.contexts.insert( rv.contexts.begin(),  parent.contexts.begin(), parent.contexts.end() );
-            rv.contexts.push_back( ++g_next_scope );
-            return rv;
-        }
-        Hygiene get_parent() const
-        {
-            //assert(this->contexts.size() > 1);
-            Hygiene rv;
-            rv.contexts.insert(rv.contexts.begin(),  this->contexts.begin(), this->contexts.end()-1);
-            return rv;
-        }
+        static Hygiene new_scope();
+        static Hygiene new_scope_chained(const Hygiene& parent);
+        Hygiene get_parent() const;
+        /// Drop memoised visibility results (called once name resolution is complete)
+        static void release_caches();
 
         Hygiene(Hygiene&& x) = default;
         Hygiene(const Hygiene& x) = default;
@@ -52,8 +38,8 @@ struct Ident
 
         // Returns true if an ident with hygine `souce` can see an ident with this hygine
         bool is_visible(const Hygiene& source) const;
-        //bool operator==(const Hygiene& x) const { return scope_index == x.scope_index; }
-        //bool operator!=(const Hygiene& x) const { return scope_index != x.scope_index; }
+        bool operator==(const Hygiene& x) const { return m_index == x.m_index; }
+        bool operator!=(const Hygiene& x) const { return m_index != x.m_index; }
 
         friend ::std::ostream& operator<<(::std::ostream& os, const Hygiene& v);
     };
@@ -5,6 +5,7 @@
 
 #include <string>
 #include <memory>
+#include <iosfwd>
 
 namespace AST {
     class Crate;
@@ -26,7 +27,8 @@ extern AST::Flat Convert_Flatten(const AST::Crate& crate);
 
 
 /// Dump the crate as annotated rust
-extern void Dump_Rust(const char *Filename, const AST::Crate& crate);
+/// - `item_filter` restricts the output to items with a path containing the string (empty for all items)
+extern void Dump_Rust(::std::ostream& os, const AST::Crate& crate, const ::std::string& item_filter);
 
 #endif
 
@@ -0,0 +1,28 @@
+/*
+ * MRustC - Rust Compiler
+ * - By John Hodge (Mutabah/thePowersGang)
+ *
+ * include/node_pool.hpp
+ * - Pooled allocation for expression tree nodes
+ */
+#pragma once
+#include <cstddef>
+
+/// Allocator for small tree nodes (AST/HIR expression nodes)
+///
+/// Nodes are bump-allocated from 256KiB chunks, each chunk counts its live nodes and is handed back to the global
+/// allocator as soon as the last one is freed. Nodes built together (a crate's AST, a lowered body) share chunks, so
+/// dropping a whole tree releases its memory in bulk.
+/// Each thread bump-allocates from its own chunk, and nodes may be freed from any thread.
+class NodePool
+{
+public:
+    static void* allocate(size_t size);
+    static void deallocate(void* ptr, size_t size);
+};
+
+/// Class-level `operator new`/`operator delete` that route allocations through `NodePool`
+/// - The sized `operator delete` gets the size of the most-derived type (the node base classes have virtual destructors)
+#define NODE_POOL_ALLOCATED() \
+    static void* operator new(size_t size) { return ::NodePool::allocate(size); } \
+    static void operator delete(void* ptr, size_t size) { ::NodePool::deallocate(ptr, size); }
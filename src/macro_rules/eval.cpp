@@ -20,8 +20,7 @@ class ParameterMappings
     /// A particular captured fragment
     struct CapturedVal
     {
-        unsigned int    num_uses;   // Number of times this var will be used
-        unsigned int    num_used;   // Number of times it has been used
+        bool    is_moved;   // Set once the final use has taken ownership of `frag`
         InterpolatedFragment    frag;
     };
 
@@ -67,10 +66,9 @@ public:
     InterpolatedFragment* get(const ::std::vector<unsigned int>& iterations, unsigned int name_idx);
     unsigned int count_in(const ::std::vector<unsigned int>& iterations, unsigned int name_idx) const;
 
-    /// Increment the number of times a particular fragment will be used
-    void inc_count(const ::std::vector<unsigned int>& iterations, unsigned int name_idx);
-    /// Decrement the number of times a particular fragment is used (returns true if there are still usages remaining)
-    bool dec_count(const ::std::vector<unsigned int>& iterations, unsigned int name_idx);
+    /// Record a use of a particular fragment (returns true if the caller can move out of the fragment)
+    /// - `is_last_use` comes from the expansion entry (see `MacroExpansionEnt::NamedValue`)
+    bool take(const ::std::vector<unsigned int>& iterations, unsigned int name_idx, bool is_last_use);
 
 
     friend ::std::ostream& operator<<(::std::ostream& os, const CapturedVal& x) {
@@ -90,7 +88,7 @@ public:
     }
 
 private:
-    CapturedVal& get_cap(const ::std::vector<unsigned int>& iterations, unsigned int name_idx);
+    CapturedVal& get_cap(const ::std::vector<unsigned int>& iterations, unsigned int name_idx, bool* out_is_shared=nullptr);
 };
 
 /// Simple pattern entry for macro_rules! arm patterns
@@ -170,7 +168,6 @@ private:
 
 // === Prototypes ===
 unsigned int Macro_InvokeRules_MatchPattern(const MacroRules& rules, TokenTree input, AST::Module& mod,  ParameterMappings& bound_tts);
-void Macro_InvokeRules_CountSubstUses(ParameterMappings& bound_tts, const ::std::vector<MacroExpansionEnt>& contents);
 
 // ------------------------------------
 // ParameterMappings
@@ -214,10 +211,10 @@ void ParameterMappings::insert(unsigned int name_index, const ::std::vector<unsi
     else {
         assert(layer->as_Vals().size() == 0);
     }
-    layer->as_Vals().push_back( CapturedVal { 0,0, mv$(data) } );
+    layer->as_Vals().push_back( CapturedVal { false, mv$(data) } );
 }
 
-ParameterMappings::CapturedVal& ParameterMappings::get_cap(const ::std::vector<unsigned int>& iterations, unsigned int name_idx)
+ParameterMappings::CapturedVal& ParameterMappings::get_cap(const ::std::vector<unsigned int>& iterations, unsigned int name_idx, bool* out_is_shared)
 {
     DEBUG("(iterations=[" << iterations << "], name_idx=" << name_idx << ")");
     auto& e = m_mappings.at(name_idx);
@@ -225,8 +222,11 @@ ParameterMappings::CapturedVal& ParameterMappings::get_cap(const ::std::vector<u
     auto* layer = &e.top_layer;
 
     // - If the top layer is a 1-sized set of values, unconditionally return it
+    //  > If within a loop, the same value may be returned for other iterations.
     TU_IFLET(CaptureLayer, (*layer), Vals, e,
         if( e.size() == 1 ) {
+            if( out_is_shared )
+                *out_is_shared = (iterations.size() > 0);
             return e[0];
         }
         if( e.size() == 0 ) {
@@ -294,18 +294,17 @@ unsigned int ParameterMappings::count_in(const ::std::vector<unsigned int>& iter
     )
     return 0;
 }
-void ParameterMappings::inc_count(const ::std::vector<unsigned int>& iterations, unsigned int name_idx)
+bool ParameterMappings::take(const ::std::vector<unsigned int>& iterations, unsigned int name_idx, bool is_last_use)
 {
-    auto& cap = get_cap(iterations, name_idx);
-    assert(cap.num_used == 0);
-    cap.num_uses += 1;
-}
-bool ParameterMappings::dec_count(const ::std::vector<unsigned int>& iterations, unsigned int name_idx)
-{
-    auto& cap = get_cap(iterations, name_idx);
-    assert(cap.num_used < cap.num_uses);
-    cap.num_used += 1;
-    return (cap.num_used < cap.num_uses);
+    bool is_shared = false;
+    auto& cap = get_cap(iterations, name_idx, &is_shared);
+    ASSERT_BUG(Span(), !cap.is_moved, "Macro fragment #" << name_idx << " used after its last use - iterations=[" << iterations << "]");
+    if( is_last_use && !is_shared )
+    {
+        cap.is_moved = true;
+        return true;
+    }
+    return false;
 }
 
 // ------------------------------------
@@ -532,7 +531,7 @@ void MacroPatternStream::break_loop()
 }
 
 // ----------------------------------------------------------------
-/// State for MacroExpander and Macro_InvokeRules_CountSubstUses
+/// State for MacroExpander
 class MacroExpandState
 {
     const ::std::vector<MacroExpansionEnt>&  m_root_contents;
@@ -741,9 +740,6 @@ InterpolatedFragment Macro_HandlePatternCap(TokenStream& lex, MacroPatEnt::Type
     }
     //bound_tts.dump();
 
-    // Run through the expansion counting the number of times each fragment is used
-    Macro_InvokeRules_CountSubstUses(bound_tts, rule.m_contents);
-
     TokenStream* ret_ptr = new MacroExpander(name, sp, rules.m_hygiene, rule.m_contents, mv$(bound_tts), rules.m_source_crate);
 
     return ::std::unique_ptr<TokenStream>( ret_ptr );
@@ -758,35 +754,19 @@ namespace
     class TokenStreamRO
     {
         const TokenTree& m_tt;
-        ::std::vector<size_t>   m_offsets;
-        size_t  m_active_offset;
+        /// Index of the current token in the flattened tree (equal to the tree size at EOF)
+        size_t  m_pos;
 
         size_t  m_consume_count;
     public:
         TokenStreamRO(const TokenTree& tt):
             m_tt(tt),
-            m_active_offset(0),
+            m_pos(0),
             m_consume_count(0)
         {
             assert( ! m_tt.is_token() );
-            if( m_tt.size() == 0 )
-            {
-                m_active_offset = 0;
-                DEBUG("TOK_EOF");
-            }
-            else
-            {
-                const auto* cur_tree = &m_tt;
-                while( !cur_tree->is_token() )
-                {
-                    cur_tree = &(*cur_tree)[0];
-                    m_offsets.push_back(0);
-                }
-                assert(m_offsets.size() > 0);
-                m_offsets.pop_back();
-                m_active_offset = 0;
-                DEBUG(next_tok());
-            }
+            skip_groups();
+            DEBUG(next_tok());
         }
         TokenStreamRO clone() const {
             return TokenStreamRO(*this);
@@ -798,57 +778,27 @@ namespace
         const Token& next_tok() const {
             static Token    eof_token = TOK_EOF;
 
-            if( m_offsets.empty() && m_active_offset == m_tt.size() )
+            if( m_pos == m_tt.ents().size() )
             {
                 //DEBUG(m_consume_count << " " << eof_token << "(EOF)");
                 return eof_token;
             }
             else
             {
-                const auto* cur_tree = &m_tt;
-                for(auto idx : m_offsets)
-                    cur_tree = &(*cur_tree)[idx];
-                const auto& rv = (*cur_tree)[m_active_offset].tok();
+                const auto& rv = m_tt.ents()[m_pos].tok;
                 //DEBUG(m_consume_count << " " << rv);
                 return rv;
             }
         }
         void consume()
         {
-            if( m_offsets.empty() && m_active_offset == m_tt.size() )
+            if( m_pos == m_tt.ents().size() )
                 throw ::std::runtime_error("Attempting to consume EOS");
             DEBUG(m_consume_count << " " << next_tok());
             m_consume_count ++;
-            for(;;)
-            {
-                const auto* cur_tree = &m_tt;
-                for(auto idx : m_offsets)
-                    cur_tree = &(*cur_tree)[idx];
-
-                m_active_offset ++;
-                // If reached the end of a tree...
-                if(m_active_offset == cur_tree->size())
-                {
-                    // If the end of the root is reached, return (leaving the state indicating EOS0
-                    if( m_offsets.empty() )
-                        return ;
-                    // Pop and continue
-                    m_active_offset = m_offsets.back();
-                    m_offsets.pop_back();
-                }
-                else
-                {
-                    // Dig into nested trees
-                    while( !(*cur_tree)[m_active_offset].is_token() )
-                    {
-                        cur_tree = &(*cur_tree)[m_active_offset];
-                        m_offsets.push_back(m_active_offset);
-                        m_active_offset = 0;
-                    }
-                    DEBUG("-> " << next_tok());
-                    return ;
-                }
-            }
+            m_pos ++;
+            skip_groups();
+            DEBUG("-> " << next_tok());
         }
 
         // Consumes if the current token is `ty`, otherwise doesn't and returns false
@@ -867,6 +817,15 @@ namespace
         size_t position() const {
             return m_consume_count;
         }
+
+    private:
+        // Step over group headers (their contents immediately follow in the flattened tree)
+        void skip_groups()
+        {
+            const auto& ents = m_tt.ents();
+            while( m_pos < ents.size() && ents[m_pos].tok.type() == TOK_NULL )
+                m_pos ++;
+        }
     };
 
     // Consume an entire TT
@@ -2227,25 +2186,6 @@ unsigned int Macro_InvokeRules_MatchPattern(const MacroRules& rules, TokenTree i
 }
 #endif
 
-void Macro_InvokeRules_CountSubstUses(ParameterMappings& bound_tts, const ::std::vector<MacroExpansionEnt>& contents)
-{
-    TRACE_FUNCTION;
-    MacroExpandState    state(contents, bound_tts);
-
-    while(const auto* ent_ptr = state.next_ent())
-    {
-        DEBUG(*ent_ptr);
-        TU_IFLET(MacroExpansionEnt, (*ent_ptr), NamedValue, e,
-            if( e >> 30 ) {
-            }
-            else {
-                // Increment a counter in `bound_tts`
-                bound_tts.inc_count(state.iterations(), e);
-            }
-        )
-    }
-}
-
 Position MacroExpander::getPosition() const
 {
     // TODO: Return the attached position of the last fetched token
@@ -2310,11 +2250,13 @@ Token MacroExpander::realGetToken()
                 }
             }
             else {
-                auto* frag = m_mappings.get(m_state.iterations(), e);
-                ASSERT_BUG(this->getPosition(), frag, "Cannot find '" << e << "' for " << m_state.iterations());
+                unsigned int idx = e & 0x1FFFFFFF;
+                auto* frag = m_mappings.get(m_state.iterations(), idx);
+                ASSERT_BUG(this->getPosition(), frag, "Cannot find '" << idx << "' for " << m_state.iterations());
 
-                bool can_steal = ( m_mappings.dec_count(m_state.iterations(), e) == false );
-                DEBUG("Insert replacement #" << e << " = " << *frag);
+                // NOTE: The last use flag is determined when the macro is defined (see `Parse_MacroRules`)
+                bool can_steal = m_mappings.take(m_state.iterations(), idx, (e >> 29) & 1);
+                DEBUG("Insert replacement #" << idx << " = " << *frag << (can_steal ? " (move)" : ""));
                 if( frag->m_type == InterpolatedFragment::TT )
                 {
                     if( can_steal )
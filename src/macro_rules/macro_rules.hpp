@@ -22,8 +22,9 @@ class MacroExpander;
 TAGGED_UNION_EX(MacroExpansionEnt, (: public Serialisable), Token, (
     // TODO: have a "raw" stream instead of just tokens
     (Token, Token),
-    // TODO: Have a flag on `NamedValue` that indicates that it is the only/last usage of this particular value (at this level)
-    // NOTE: This is a 2:30 bitfield - with the high range indicating $crate
+    // NOTE: This is a 2:1:29 bitfield - with the high range indicating $crate
+    // - Bit 29 is set (by `Parse_MacroRules`) when this is the last usage of the value at this level, allowing the
+    //   expander to move the captured fragment instead of cloning it.
     (NamedValue, unsigned int),
     (Loop, struct {
         /// Contained entries
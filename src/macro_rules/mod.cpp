@@ -282,7 +282,9 @@ SERIALISE_TU(MacroExpansionEnt, "MacroExpansionEnt", e,
             os << "$crate";
         }
         else {
-            os << "$" << e;
+            os << "$" << (e & 0x1FFFFFFF);
+            if( e & (1<<29) )
+                os << "!";
         }
         ),
     (Loop,
@@ -443,6 +443,53 @@ void enumerate_names(const ::std::vector<MacroPatEnt>& pats, ::std::vector< ::st
     }
 }
 
+/// Obtain the loop depth that each variable is captured at
+void enumerate_capture_depths(const ::std::vector<MacroPatEnt>& pats, unsigned int depth, ::std::vector<unsigned int>& depths)
+{
+    for( const auto& pat : pats )
+    {
+        if( pat.type == MacroPatEnt::PAT_LOOP ) {
+            enumerate_capture_depths(pat.subpats, depth+1, depths);
+        }
+        else if( pat.name != "" ) {
+            if( pat.name_index >= depths.size() ) {
+                depths.resize( pat.name_index+1, 0 );
+            }
+            depths[pat.name_index] = depth;
+        }
+    }
+}
+
+/// Flag the final use of each captured value in an arm's expansion (so the expander can move instead of clone)
+/// - Walks the contents backwards, a use is final if no later entry refers to the same variable and it isn't repeated
+///   by a loop deeper than the level the variable was captured at.
+void mark_last_uses(::std::vector<MacroExpansionEnt>& ents, unsigned int loop_depth, const ::std::vector<unsigned int>& capture_depths, ::std::vector<bool>& seen)
+{
+    for(auto it = ents.rbegin(); it != ents.rend(); ++ it)
+    {
+        if( it->is_NamedValue() )
+        {
+            auto& e = it->as_NamedValue();
+            // Skip `$crate`
+            if( e >> 30 )
+                continue ;
+            unsigned int idx = e & 0x1FFFFFFF;
+            if( idx >= seen.size() )
+                seen.resize(idx+1, false);
+            if( !seen[idx] && idx < capture_depths.size() && capture_depths[idx] == loop_depth )
+            {
+                DEBUG("Last use of #" << idx << " at depth " << loop_depth);
+                e |= (1 << 29);
+            }
+            seen[idx] = true;
+        }
+        else if( it->is_Loop() )
+        {
+            mark_last_uses(it->as_Loop().entries, loop_depth+1, capture_depths, seen);
+        }
+    }
+}
+
 /// Parse an entire macro_rules! block into a format that exec.cpp can use
 MacroRulesPtr Parse_MacroRules(TokenStream& lex)
 {
@@ -473,6 +520,11 @@ MacroRulesPtr Parse_MacroRules(TokenStream& lex)
 
         enumerate_names(arm.m_pattern,  arm.m_param_names);
 
+        ::std::vector<unsigned int> capture_depths;
+        enumerate_capture_depths(arm.m_pattern, 0, capture_depths);
+        ::std::vector<bool> seen;
+        mark_last_uses(arm.m_contents, 0, capture_depths, seen);
+
         rule_arms.push_back( mv$(arm) );
     }
 
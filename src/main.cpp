@@ -26,6 +26,17 @@
 #include "trans/target.hpp"
 
 #include "expand/cfg.hpp"
+#include <async_file.hpp>
+
+#ifdef _WIN32
+# define NOGDI  // prevent ERROR from being defined
+# define NOMINMAX
+# include <windows.h>
+# include <psapi.h>
+# pragma comment(lib, "psapi.lib")
+#else
+# include <sys/resource.h>
+#endif
 
 // Hacky default target
 #ifdef _MSC_VER
@@ -46,6 +57,8 @@ int g_debug_indent_level = 0;
 bool g_debug_enabled = true;
 ::std::string g_cur_phase;
 ::std::set< ::std::string>    g_debug_disable_map;
+/// Set by `-Z print-memory`, reports the peak memory usage after each phase
+bool g_print_peak_memory = false;
 
 void init_debug_list()
 {
@@ -53,6 +66,7 @@ void init_debug_list()
     g_debug_disable_map.insert( "LoadCrates" );
     g_debug_disable_map.insert( "Expand" );
     g_debug_disable_map.insert( "Dump Expanded" );
+    g_debug_disable_map.insert( "Dump Resolved" );
     g_debug_disable_map.insert( "Implicit Crates" );
 
     g_debug_disable_map.insert( "Resolve Use" );
@@ -88,6 +102,10 @@ void init_debug_list()
     g_debug_disable_map.insert( "MIR Optimise" );
     g_debug_disable_map.insert( "MIR Validate PO" );
     g_debug_disable_map.insert( "MIR Validate Full" );
+    g_debug_disable_map.insert( "Lower MIR (const)" );
+    g_debug_disable_map.insert( "MIR Cleanup (const)" );
+    g_debug_disable_map.insert( "MIR Per-Body" );
+    g_debug_disable_map.insert( "HIR Free Expressions" );
 
     g_debug_disable_map.insert( "HIR Serialise" );
     g_debug_disable_map.insert( "Trans Enumerate" );
@@ -147,6 +165,8 @@ struct ProgramParams
     ::std::string   outfile;
     ::std::string   output_dir = "";
     ::std::string   target = DEFAULT_TARGET_NAME;
+    /// `--target-feature` entries (`+name` or `-name`), applied in order
+    ::std::vector< ::std::string>   target_features;
 
     ::AST::Crate::Type  crate_type = ::AST::Crate::Type::Unknown;
     ::std::string   crate_name;
@@ -156,6 +176,12 @@ struct ProgramParams
     bool emit_debug_info = false;
 
     bool test_harness = false;
+    /// Library only contains MIR (no object file), see `--mir-only`
+    bool mir_only_rlib = false;
+    /// Executable contains code for every function it uses (from library MIR), libraries save MIR for it, see `--whole-program`
+    bool whole_program = false;
+    /// Generated C has no comments or unused labels, see `--compact-c`
+    bool compact_c = false;
 
     ::std::vector<const char*> lib_search_dirs;
     ::std::vector<const char*> libraries;
@@ -163,16 +189,45 @@ struct ProgramParams
 
     ::std::set< ::std::string> features;
 
+    // `--dump=<phase>[:<filter>]` - Map of requested dump phases to item path filters
+    ::std::map< ::std::string, ::std::string>   dumps;
 
     struct {
         bool disable_mir_optimisations = false;
         bool full_validate = false;
         bool full_validate_early = false;
+        bool mir_per_body = false;
     } debug;
 
     ProgramParams(int argc, char *argv[]);
+
+    /// Returns the item filter for the specified dump phase, or nullptr if the dump wasn't requested
+    const ::std::string* get_dump(const char* phase) const {
+        auto it = dumps.find(phase);
+        return it == dumps.end() ? nullptr : &it->second;
+    }
 };
 
+/// Peak resident set size of the process (in KiB)
+size_t get_peak_memory_kib()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS pmc;
+    if( !GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)) )
+        return 0;
+    return pmc.PeakWorkingSetSize / 1024;
+#else
+    struct rusage   ru;
+    if( getrusage(RUSAGE_SELF, &ru) != 0 )
+        return 0;
+# ifdef __APPLE__
+    return ru.ru_maxrss / 1024; // bytes on OSX
+# else
+    return ru.ru_maxrss;
+# endif
+#endif
+}
+
 template <typename Rv, typename Fcn>
 Rv CompilePhase(const char *name, Fcn f) {
     ::std::cout << name << ": V V V" << ::std::endl;
@@ -186,6 +241,9 @@ Rv CompilePhase(const char *name, Fcn f) {
 
     ::std::cout <<"(" << ::std::fixed << ::std::setprecision(2) << static_cast<double>(end - start) / static_cast<double>(CLOCKS_PER_SEC) << " s) ";
     ::std::cout << name << ": DONE";
+    if( g_print_peak_memory ) {
+        ::std::cout << " (peak " << get_peak_memory_kib() / 1024 << " MiB)";
+    }
     ::std::cout << ::std::endl;
     return rv;
 }
@@ -206,6 +264,8 @@ int main(int argc, char *argv[])
         return params.features.count(s) != 0;
         });
     Target_SetCfg(params.target);
+    for(const auto& f : params.target_features)
+        Target_SetFeature(f);
 
 
     if( params.test_harness )
@@ -312,10 +372,13 @@ int main(int argc, char *argv[])
             DEBUG("params.outfile = " << params.outfile);
         }
 
-        // XXX: Dump crate before resolve
-        CompilePhaseV("Dump Expanded", [&]() {
-            Dump_Rust( FMT(params.outfile << "_0a_exp.rs").c_str(), crate );
-            });
+        if( const auto* filter = params.get_dump("expand") )
+        {
+            CompilePhaseV("Dump Expanded", [&]() {
+                AsyncOutputFile os { FMT(params.outfile << "_0a_exp.rs") };
+                Dump_Rust( os, crate, *filter );
+                });
+        }
 
         if( params.last_stage == ProgramParams::STAGE_EXPAND ) {
             return 0;
@@ -351,10 +414,13 @@ int main(int argc, char *argv[])
             Resolve_Absolutise(crate);  // - Convert all paths to Absolute or UFCS, and resolve variables
             });
 
-        // XXX: Dump crate before HIR
-        CompilePhaseV("Temp output - Resolved", [&]() {
-            Dump_Rust( FMT(params.outfile << "_1_res.rs").c_str(), crate );
-            });
+        if( const auto* filter = params.get_dump("resolve") )
+        {
+            CompilePhaseV("Dump Resolved", [&]() {
+                AsyncOutputFile os { FMT(params.outfile << "_1_res.rs") };
+                Dump_Rust( os, crate, *filter );
+                });
+        }
 
         if( params.last_stage == ProgramParams::STAGE_RESOLVE ) {
             return 0;
@@ -367,8 +433,9 @@ int main(int argc, char *argv[])
         ::HIR::CratePtr hir_crate = CompilePhase< ::HIR::CratePtr>("HIR Lower", [&]() {
             return LowerHIR_FromAST(mv$( crate ));
             });
-        // Deallocate the original crate
+        // Deallocate the original crate (and data only used by expansion/resolve)
         crate = ::AST::Crate();
+        Ident::Hygiene::release_caches();
 
         // Replace type aliases (`type`) into the actual type
         // - Also inserts defaults in trait impls
@@ -392,10 +459,18 @@ int main(int argc, char *argv[])
             ConvertHIR_ConstantEvaluate(*hir_crate);
             });
 
-        CompilePhaseV("Dump HIR", [&]() {
-            ::std::ofstream os (FMT(params.outfile << "_2_hir.rs"));
-            HIR_Dump( os, *hir_crate );
-            });
+        // HIR is dumped at each major phase boundary, each dump replaces the last
+        // - Errors abort compilation, so a failed build still leaves the HIR from the last boundary it reached
+        auto dump_hir = [&]() {
+            if( const auto* filter = params.get_dump("hir") )
+            {
+                CompilePhaseV("Dump HIR", [&]() {
+                    AsyncOutputFile os { FMT(params.outfile << "_2_hir.rs") };
+                    HIR_Dump( os, *hir_crate, *filter );
+                    });
+            }
+            };
+        dump_hir();
 
         // === Type checking ===
         // - This can recurse and call the MIR lower to evaluate constants
@@ -430,10 +505,7 @@ int main(int argc, char *argv[])
         CompilePhaseV("Expand HIR ErasedType", [&]() {
             HIR_Expand_ErasedType(*hir_crate);
             });
-        CompilePhaseV("Dump HIR", [&]() {
-            ::std::ofstream os (FMT(params.outfile << "_2_hir.rs"));
-            HIR_Dump( os, *hir_crate );
-            });
+        dump_hir();
         // - Ensure that typeck worked (including Fn trait call insertion etc)
         CompilePhaseV("Typecheck Expressions (validate)", [&]() {
             Typecheck_Expressions_Validate(*hir_crate);
@@ -443,59 +515,91 @@ int main(int argc, char *argv[])
             return 0;
         }
 
-        // Lower expressions into MIR
-        CompilePhaseV("Lower MIR", [&]() {
-            HIR_GenerateMIR(*hir_crate);
-            });
+        if( params.debug.mir_per_body )
+        {
+            // Lower the bodies used by constant evaluation first, then take every other body through the full MIR
+            // pipeline one at a time.
+            CompilePhaseV("Lower MIR (const)", [&]() {
+                HIR_GenerateMIR_Const(*hir_crate);
+                });
+            CompilePhaseV("Constant Evaluate Full", [&]() {
+                ConvertHIR_ConstantEvaluateFull(*hir_crate);
+                });
+            dump_hir();
+            CompilePhaseV("MIR Cleanup (const)", [&]() {
+                MIR_CleanupCrate_Const(*hir_crate);
+                });
+            CompilePhaseV("MIR Per-Body", [&]() {
+                MIR_ProcessCrate_PerBody(*hir_crate, params.debug.disable_mir_optimisations,
+                    params.debug.full_validate_early || getenv("MRUSTC_FULL_VALIDATE_PREOPT"),
+                    params.debug.full_validate || getenv("MRUSTC_FULL_VALIDATE")
+                    );
+                });
+            if( const auto* filter = params.get_dump("mir") )
+            {
+                CompilePhaseV("Dump MIR", [&]() {
+                    AsyncOutputFile os { FMT(params.outfile << "_3_mir.rs") };
+                    MIR_Dump( os, *hir_crate, *filter );
+                    });
+            }
+        }
+        else
+        {
+            // Lower expressions into MIR
+            CompilePhaseV("Lower MIR", [&]() {
+                HIR_GenerateMIR(*hir_crate);
+                });
 
-        CompilePhaseV("Dump MIR", [&]() {
-            ::std::ofstream os (FMT(params.outfile << "_3_mir.rs"));
-            MIR_Dump( os, *hir_crate );
-            });
+            // Validate the MIR
+            CompilePhaseV("MIR Validate", [&]() {
+                MIR_CheckCrate(*hir_crate);
+                });
 
-        // Validate the MIR
-        CompilePhaseV("MIR Validate", [&]() {
-            MIR_CheckCrate(*hir_crate);
-            });
+            // Second shot of constant evaluation (with full type information)
+            CompilePhaseV("Constant Evaluate Full", [&]() {
+                ConvertHIR_ConstantEvaluateFull(*hir_crate);
+                });
+            dump_hir();
 
-        // Second shot of constant evaluation (with full type information)
-        CompilePhaseV("Constant Evaluate Full", [&]() {
-            ConvertHIR_ConstantEvaluateFull(*hir_crate);
-            });
-        CompilePhaseV("Dump HIR", [&]() {
-            ::std::ofstream os (FMT(params.outfile << "_2_hir.rs"));
-            HIR_Dump( os, *hir_crate );
-            });
+            // - Expand constants in HIR and virtualise calls
+            CompilePhaseV("MIR Cleanup", [&]() {
+                MIR_CleanupCrate(*hir_crate);
+                });
+            if( params.debug.full_validate_early || getenv("MRUSTC_FULL_VALIDATE_PREOPT") )
+            {
+                CompilePhaseV("MIR Validate Full Early", [&]() {
+                    MIR_CheckCrate_Full(*hir_crate);
+                    });
+            }
 
-        // - Expand constants in HIR and virtualise calls
-        CompilePhaseV("MIR Cleanup", [&]() {
-            MIR_CleanupCrate(*hir_crate);
-            });
-        if( params.debug.full_validate_early || getenv("MRUSTC_FULL_VALIDATE_PREOPT") )
-        {
-            CompilePhaseV("MIR Validate Full Early", [&]() {
-                MIR_CheckCrate_Full(*hir_crate);
+            // Optimise the MIR
+            CompilePhaseV("MIR Optimise", [&]() {
+                MIR_OptimiseCrate(*hir_crate, params.debug.disable_mir_optimisations);
                 });
-        }
 
-        // Optimise the MIR
-        CompilePhaseV("MIR Optimise", [&]() {
-            MIR_OptimiseCrate(*hir_crate, params.debug.disable_mir_optimisations);
-            });
+            if( const auto* filter = params.get_dump("mir") )
+            {
+                CompilePhaseV("Dump MIR", [&]() {
+                    AsyncOutputFile os { FMT(params.outfile << "_3_mir.rs") };
+                    MIR_Dump( os, *hir_crate, *filter );
+                    });
+            }
+            CompilePhaseV("MIR Validate PO", [&]() {
+                MIR_CheckCrate(*hir_crate);
+                });
+            // - Exhaustive MIR validation (follows every code path and checks variable validity)
+            // > DEBUGGING ONLY
+            CompilePhaseV("MIR Validate Full", [&]() {
+                if( params.debug.full_validate || getenv("MRUSTC_FULL_VALIDATE") )
+                    MIR_CheckCrate_Full(*hir_crate);
+                });
 
-        CompilePhaseV("Dump MIR", [&]() {
-            ::std::ofstream os (FMT(params.outfile << "_3_mir.rs"));
-            MIR_Dump( os, *hir_crate );
-            });
-        CompilePhaseV("MIR Validate PO", [&]() {
-            MIR_CheckCrate(*hir_crate);
-            });
-        // - Exhaustive MIR validation (follows every code path and checks variable validity)
-        // > DEBUGGING ONLY
-        CompilePhaseV("MIR Validate Full", [&]() {
-            if( params.debug.full_validate || getenv("MRUSTC_FULL_VALIDATE") )
-                MIR_CheckCrate_Full(*hir_crate);
-            });
+            // HIR expression trees are not needed past this point (serialisation and codegen only use MIR)
+            // - The per-body pipeline releases them as it goes
+            CompilePhaseV("HIR Free Expressions", [&]() {
+                HIR_FreeExpressions(*hir_crate);
+                });
+        }
 
         if( params.last_stage == ProgramParams::STAGE_MIR ) {
             return 0;
@@ -515,6 +619,8 @@ int main(int argc, char *argv[])
             hir_crate->m_ext_libs.push_back(::HIR::ExternLibrary { libname });
         }
         trans_opt.emit_debug_info = params.emit_debug_info;
+        trans_opt.whole_program = params.whole_program;
+        trans_opt.compact_c = params.compact_c;
 
         // Generate code for non-generic public items (if requested)
         if( params.test_harness )
@@ -528,11 +634,17 @@ int main(int argc, char *argv[])
             // ERROR?
             break;
         case ::AST::Crate::Type::RustLib: {
-            #if 1
-            // Generate a .o
-            TransList   items = CompilePhase<TransList>("Trans Enumerate", [&]() { return Trans_Enumerate_Public(*hir_crate); });
-            CompilePhaseV("Trans Codegen", [&]() { Trans_Codegen(params.outfile + ".o", trans_opt, *hir_crate, items, false); });
-            #endif
+            if( params.mir_only_rlib )
+            {
+                // No object, just save MIR for everything (the executable generates code for what it uses)
+                CompilePhaseV("Trans Enumerate", [&]() { Trans_SetMirOnly(*hir_crate); });
+            }
+            else
+            {
+                // Generate a .o
+                TransList   items = CompilePhase<TransList>("Trans Enumerate", [&]() { return Trans_Enumerate_Public(*hir_crate, params.whole_program); });
+                CompilePhaseV("Trans Codegen", [&]() { Trans_Codegen(params.outfile + ".o", trans_opt, *hir_crate, items, false); });
+            }
 
             // Save a loadable HIR dump
             CompilePhaseV("HIR Serialise", [&]() {
@@ -545,7 +657,7 @@ int main(int argc, char *argv[])
         case ::AST::Crate::Type::RustDylib: {
             #if 1
             // Generate a .o
-            TransList   items = CompilePhase<TransList>("Trans Enumerate", [&]() { return Trans_Enumerate_Public(*hir_crate); });
+            TransList   items = CompilePhase<TransList>("Trans Enumerate", [&]() { return Trans_Enumerate_Public(*hir_crate, params.whole_program); });
             CompilePhaseV("Trans Codegen", [&]() { Trans_Codegen(params.outfile + ".o", trans_opt, *hir_crate, items, false); });
             #endif
             // Save a loadable HIR dump
@@ -560,7 +672,7 @@ int main(int argc, char *argv[])
         case ::AST::Crate::Type::Executable:
             // Generate a binary
             // - Enumerate items for translation
-            TransList items = CompilePhase<TransList>("Trans Enumerate", [&]() { return Trans_Enumerate_Main(*hir_crate); });
+            TransList items = CompilePhase<TransList>("Trans Enumerate", [&]() { return Trans_Enumerate_Main(*hir_crate, params.whole_program); });
             // - Perform codegen
             CompilePhaseV("Trans Codegen", [&]() { Trans_Codegen(params.outfile, trans_opt, *hir_crate, items, true); });
             // - Invoke linker?
@@ -659,6 +771,12 @@ ProgramParams::ProgramParams(int argc, char *argv[])
                 else if( optname == "full-validate-early" ) {
                     this->debug.full_validate_early = true;
                 }
+                else if( optname == "mir-per-body" ) {
+                    this->debug.mir_per_body = true;
+                }
+                else if( optname == "print-memory" ) {
+                    g_print_peak_memory = true;
+                }
                 else {
                     ::std::cerr << "Unknown debug option: '" << optname << "'" << ::std::endl;
                     exit(1);
@@ -764,6 +882,21 @@ ProgramParams::ProgramParams(int argc, char *argv[])
                     exit(1);
                 }
             }
+            // `--mir-only`  - Library crates: Don't generate code, save MIR for all functions instead
+            //   Code for everything the executable uses is then generated when it is built.
+            else if( strcmp(arg, "--mir-only") == 0 ) {
+                this->mir_only_rlib = true;
+            }
+            // `--whole-program`  - Executables: Generate code for every function used (from the libraries' MIR)
+            //   All of it is in the one C file (with internal linkage), so the C compiler can optimise across crates.
+            //   Libraries: Save the MIR for every function, so whole-program executables can do the above.
+            else if( strcmp(arg, "--whole-program") == 0 ) {
+                this->whole_program = true;
+            }
+            // `--compact-c`  - Leave the MIR/type comments out of the generated C (smaller and faster to compile)
+            else if( strcmp(arg, "--compact-c") == 0 ) {
+                this->compact_c = true;
+            }
             // `--cfg <flag>`
             // `--cfg <var>=<value>`
             else if( strcmp(arg, "--cfg") == 0 ) {
@@ -806,6 +939,22 @@ ProgramParams::ProgramParams(int argc, char *argv[])
                 }
                 this->target = argv[++i];
             }
+            // `--target-feature <+feat,-feat,...>` - Enable/disable target features (e.g. `+avx2`)
+            else if( strcmp(arg, "--target-feature") == 0 ) {
+                if (i == argc - 1) {
+                    ::std::cerr << "Flag " << arg << " requires an argument" << ::std::endl;
+                    exit(1);
+                }
+                ::std::string   list = argv[++i];
+                for(size_t start = 0; start <= list.size(); )
+                {
+                    size_t end = list.find(',', start);
+                    if( end == ::std::string::npos )
+                        end = list.size();
+                    this->target_features.push_back( list.substr(start, end - start) );
+                    start = end + 1;
+                }
+            }
             // `--stop-after <stage>`   - Stops the compiler after the specified stage
             // TODO: Convert this to a `-Z` option
             else if( strcmp(arg, "--stop-after") == 0 ) {
@@ -833,6 +982,21 @@ ProgramParams::ProgramParams(int argc, char *argv[])
             else if( strcmp(arg, "--test") == 0 ) {
                 this->test_harness = true;
             }
+            // `--dump=<phase>[:<filter>]`  - Dump the crate after the specified phase (optionally only items with paths containing `filter`)
+            else if( strncmp(arg, "--dump=", 7) == 0 ) {
+                ::std::string   phase = arg + 7;
+                ::std::string   filter;
+                auto colon_pos = phase.find(':');
+                if( colon_pos != ::std::string::npos ) {
+                    filter = phase.substr(colon_pos+1);
+                    phase = phase.substr(0, colon_pos);
+                }
+                if( phase != "expand" && phase != "resolve" && phase != "hir" && phase != "mir" ) {
+                    ::std::cerr << "Unknown phase for --dump : '" << phase << "' (expected expand, resolve, hir, or mir)" << ::std::endl;
+                    exit(1);
+                }
+                this->dumps[phase] = filter;
+            }
             else {
                 ::std::cerr << "Unknown option '" << arg << "'" << ::std::endl;
                 exit(1);
@@ -173,7 +173,7 @@ namespace {
 
                 m_os.flush();
             }
-            #undef FMT
+            #undef FMT_M
         }
         void fmt_val(::std::ostream& os, const ::MIR::LValue& lval) {
             TU_MATCHA( (lval), (e),
@@ -408,16 +408,20 @@ namespace {
         ::std::ostream& m_os;
         unsigned int    m_indent_level;
         bool m_short_item_name = false;
+        const ::std::string&    m_item_filter;
 
     public:
-        TreeVisitor(::std::ostream& os):
+        TreeVisitor(::std::ostream& os, const ::std::string& item_filter):
             m_os(os),
-            m_indent_level(0)
+            m_indent_level(0),
+            m_item_filter(item_filter)
         {
         }
 
         void visit_type_impl(::HIR::TypeImpl& impl) override
         {
+            ::HIR::ItemPath    ip { impl.m_type };
+            if( !filter_item(ip) && !filter_any(ip, impl.m_methods) && !filter_any(ip, impl.m_constants) )   return ;
             m_short_item_name = true;
 
             m_os << indent() << "impl" << impl.m_params.fmt_args() << " " << impl.m_type << "\n";
@@ -435,6 +439,8 @@ namespace {
         }
         virtual void visit_trait_impl(const ::HIR::SimplePath& trait_path, ::HIR::TraitImpl& impl) override
         {
+            ::HIR::ItemPath    ip { impl.m_type, trait_path, impl.m_trait_args };
+            if( !filter_item(ip) && !filter_any(ip, impl.m_methods) && !filter_any(ip, impl.m_constants) && !filter_any(ip, impl.m_statics) )   return ;
             m_short_item_name = true;
 
             m_os << indent() << "impl" << impl.m_params.fmt_args() << " " << trait_path << impl.m_trait_args << " for " << impl.m_type << "\n";
@@ -452,6 +458,7 @@ namespace {
         }
         void visit_marker_impl(const ::HIR::SimplePath& trait_path, ::HIR::MarkerImpl& impl) override
         {
+            if( !filter_item(::HIR::ItemPath(impl.m_type, trait_path, impl.m_trait_args)) )   return ;
             m_short_item_name = true;
 
             m_os << indent() << "impl" << impl.m_params.fmt_args() << " " << (impl.is_positive ? "" : "!") << trait_path << impl.m_trait_args << " for " << impl.m_type << "\n";
@@ -485,6 +492,7 @@ namespace {
 
         void visit_function(::HIR::ItemPath p, ::HIR::Function& item) override
         {
+            if( !filter_item(p) )   return ;
             m_os << indent();
             if( item.m_const )
                 m_os << "const ";
@@ -511,7 +519,7 @@ namespace {
                 m_os << indent() << " " << item.m_params.fmt_bounds() << "\n";
             }
 
-            if( item.m_code )
+            if( item.m_code.has_body() )
             {
                 m_os << indent() << "{\n";
                 inc_indent();
@@ -526,6 +534,7 @@ namespace {
         }
         void visit_constant(::HIR::ItemPath p, ::HIR::Constant& item) override
         {
+            if( !filter_item(p) )   return ;
             m_os << indent();
             m_os << "const ";
             if( m_short_item_name )
@@ -533,7 +542,7 @@ namespace {
             else
                 m_os << p;
             m_os << ": " << item.m_type;
-            if( item.m_value )
+            if( item.m_value.has_body() )
             {
                 inc_indent();
                 m_os << " = {\n";
@@ -550,6 +559,7 @@ namespace {
         }
         void visit_static(::HIR::ItemPath p, ::HIR::Static& item) override
         {
+            if( !filter_item(p) )   return ;
             m_os << indent();
             m_os << "static ";
             if( m_short_item_name )
@@ -557,7 +567,7 @@ namespace {
             else
                 m_os << p;
             m_os << ": " << item.m_type;
-            if( item.m_value )
+            if( item.m_value.has_body() )
             {
                 inc_indent();
                 m_os << " = {\n";
@@ -574,6 +584,19 @@ namespace {
         }
 
     private:
+        bool filter_item(const ::HIR::ItemPath& p) const {
+            if( m_item_filter == "" )
+                return true;
+            return FMT(p).find(m_item_filter) != ::std::string::npos;
+        }
+        /// Check if any item in an impl's item list passes the filter (impl blocks are skipped if none do)
+        template<typename List>
+        bool filter_any(const ::HIR::ItemPath& p, const List& list) const {
+            for(const auto& ent : list)
+                if( filter_item(p + ent.first) )
+                    return true;
+            return false;
+        }
         RepeatLitStr indent() const {
             return RepeatLitStr { "   ", static_cast<int>(m_indent_level) };
         }
@@ -586,9 +609,9 @@ namespace {
     };
 }
 
-void MIR_Dump(::std::ostream& sink, const ::HIR::Crate& crate)
+void MIR_Dump(::std::ostream& sink, const ::HIR::Crate& crate, const ::std::string& item_filter)
 {
-    TreeVisitor tv { sink };
+    TreeVisitor tv { sink, item_filter };
 
     tv.visit_crate( const_cast< ::HIR::Crate&>(crate) );
 }
@@ -1769,7 +1769,7 @@ namespace {
             {
                 const auto& gpath = node.m_path.m_data.as_Generic();
                 const auto& fcn = m_builder.crate().get_function_by_path(node.span(), gpath.m_path);
-                if( fcn.m_abi == "rust-intrinsic" )
+                if( fcn.m_abi == "rust-intrinsic" || fcn.m_abi == "platform-intrinsic" )
                 {
                     m_builder.end_block(::MIR::Terminator::make_Call({
                         next_block, panic_block,
@@ -2345,3 +2345,13 @@ void HIR_GenerateMIR(::HIR::Crate& crate)
     ov.visit_crate(crate);
 }
 
+
+void HIR_FreeExpressions(::HIR::Crate& crate)
+{
+    ::MIR::OuterVisitor    ov { crate, [&](const auto& res, const auto& p, auto& expr_ptr, const auto& args, const auto& ty){
+            if( expr_ptr.m_mir ) {
+                expr_ptr.release_tree();
+            }
+        } };
+    ov.visit_crate(crate);
+}
@@ -10,6 +10,7 @@
 #include <hir/hir.hpp>
 #include <hir/type.hpp>
 #include <mir/mir.hpp>
+#include <trans/trans_list.hpp>    // Trans_KeyHash (for the cold callee cache)
 #include <algorithm>    // ::std::find
 
 void ::MIR::TypeResolve::fmt_pos(::std::ostream& os) const
@@ -1635,3 +1636,107 @@ void MIR_Helper_GetLifetimes_DetermineValueLifetime(
     return rv;
 }
 #endif
+
+namespace {
+    /// Check if a call never returns normally (calls a `-> !` function), or calls a `#[cold]` function
+    bool MIR_Helper_IsColdCall(const ::MIR::TypeResolve& state, const ::MIR::Terminator::Data_Call& te, t_cold_callee_cache* callee_cache)
+    {
+        TU_MATCHA( (te.fcn), (e),
+        (Value,
+            ::HIR::TypeRef  tmp;
+            const auto& ty = state.get_lvalue_type(tmp, e);
+            if( const auto* fe = ty.m_data.opt_Function() )
+                return fe->m_rettype->m_data.is_Diverge();
+            return false;
+            ),
+        (Path,
+            if( callee_cache )
+            {
+                auto it = callee_cache->find(e);
+                if( it != callee_cache->end() )
+                    return it->second;
+            }
+            MonomorphState  out_params;
+            auto v = state.m_resolve.get_value(state.sp, e, out_params, /*signature_only=*/true);
+            bool rv = false;
+            if( const auto* fcn = v.opt_Function() )
+                rv = (*fcn)->m_cold || (*fcn)->m_return.m_data.is_Diverge();
+            if( callee_cache )
+                callee_cache->insert(::std::make_pair( e.clone(), rv ));
+            return rv;
+            ),
+        (Intrinsic,
+            return e.name == "abort" || e.name == "unreachable";
+            )
+        )
+        throw "";
+    }
+}
+
+::std::vector<bool> MIR_Helper_GetColdBlocks(const ::MIR::TypeResolve& state, const ::MIR::Function& fcn, t_cold_callee_cache* callee_cache)
+{
+    ::std::vector<bool> rv( fcn.blocks.size() );
+
+    // Blocks that unwind, panic, or call a function that never returns (or is `#[cold]`)
+    for(unsigned int i = 0; i < fcn.blocks.size(); i ++)
+    {
+        TU_MATCH_DEF( ::MIR::Terminator, (fcn.blocks[i].terminator), (te),
+        (
+            ),
+        (Incomplete,
+            rv[i] = true;
+            ),
+        (Diverge,
+            rv[i] = true;
+            ),
+        (Panic,
+            rv[i] = true;
+            ),
+        (Call,
+            rv[i] = MIR_Helper_IsColdCall(state, te, callee_cache);
+            )
+        )
+    }
+
+    // Then any block that can only continue to a cold block
+    bool changed;
+    do
+    {
+        changed = false;
+        for(unsigned int i = fcn.blocks.size(); i --; )
+        {
+            if( rv[i] )
+                continue ;
+            bool is_cold = false;
+            TU_MATCHA( (fcn.blocks[i].terminator), (te),
+            (Incomplete, ),
+            (Return, ),
+            (Diverge, ),
+            (Panic, ),
+            (Goto,
+                is_cold = rv[te];
+                ),
+            (If,
+                is_cold = rv[te.bb0] && rv[te.bb1];
+                ),
+            (Switch,
+                is_cold = ::std::all_of(te.targets.begin(), te.targets.end(), [&](auto bb){ return rv[bb]; });
+                ),
+            (SwitchValue,
+                is_cold = rv[te.def_target] && ::std::all_of(te.targets.begin(), te.targets.end(), [&](auto bb){ return rv[bb]; });
+                ),
+            (Call,
+                // Only the normal return matters, unwinding is always cold
+                is_cold = rv[te.ret_block];
+                )
+            )
+            if( is_cold )
+            {
+                rv[i] = true;
+                changed = true;
+            }
+        }
+    } while(changed);
+
+    return rv;
+}
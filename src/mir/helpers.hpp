@@ -8,6 +8,7 @@
 #pragma once
 #include <vector>
 #include <functional>
+#include <unordered_map>
 #include <hir_typeck/static.hpp>
 
 namespace HIR {
@@ -16,6 +17,8 @@ class TypeRef;
 struct Pattern;
 struct SimplePath;
 }
+struct Trans_KeyHash;
+struct Trans_KeyEq;
 
 namespace MIR {
 
@@ -185,3 +188,9 @@ namespace visit {
 }   // namespace MIR
 
 extern ::MIR::ValueLifetimes MIR_Helper_GetLifetimes(::MIR::TypeResolve& state, const ::MIR::Function& fcn, bool dump_debug);
+/// Find the blocks that can only end in a panic, unwind, or abort (i.e. never return normally)
+/// - A call to a `#[cold]` function also counts
+/// - `callee_cache`: If non-null, memoises the lookup of called paths (only valid for monomorphised code, where the
+///   same path always refers to the same function)
+typedef ::std::unordered_map< ::HIR::Path, bool, Trans_KeyHash, Trans_KeyEq>  t_cold_callee_cache;
+extern ::std::vector<bool> MIR_Helper_GetColdBlocks(const ::MIR::TypeResolve& state, const ::MIR::Function& fcn, t_cold_callee_cache* callee_cache=nullptr);
@@ -7,15 +7,23 @@
  */
 #pragma once
 #include <iostream>
+#include <string>
 
 namespace HIR {
 class Crate;
 }
 
 extern void HIR_GenerateMIR(::HIR::Crate& crate);
-extern void MIR_Dump(::std::ostream& sink, const ::HIR::Crate& crate);
+/// Release HIR expression trees that have been lowered to MIR (only MIR is used past this point)
+extern void HIR_FreeExpressions(::HIR::Crate& crate);
+extern void MIR_Dump(::std::ostream& sink, const ::HIR::Crate& crate, const ::std::string& item_filter="");
 extern void MIR_CheckCrate(/*const*/ ::HIR::Crate& crate);
 extern void MIR_CheckCrate_Full(/*const*/ ::HIR::Crate& crate);
 
 extern void MIR_CleanupCrate(::HIR::Crate& crate);
 extern void MIR_OptimiseCrate(::HIR::Crate& crate, bool minimal_optimisations);
+
+// Function-at-a-time pipeline (see mir/per_body.cpp)
+extern void HIR_GenerateMIR_Const(::HIR::Crate& crate);
+extern void MIR_CleanupCrate_Const(::HIR::Crate& crate);
+extern void MIR_ProcessCrate_PerBody(::HIR::Crate& crate, bool minimal_optimisations, bool full_validate_early, bool full_validate);
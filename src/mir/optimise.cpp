@@ -260,6 +260,86 @@ namespace {
         visit_mir_lvalues_mut(state, const_cast<::MIR::Function&>(fcn), [&](auto& lv, auto im){ return cb(lv, im); });
     }
 
+    // Inliner cost model (units are roughly "statements")
+    const size_t    INLINE_COST_CALL = 5;   // A call (also the benefit of removing one)
+    const size_t    INLINE_COST_DROP = 2;   // Drops may call drop glue
+    const size_t    INLINE_COST_ASM = 5;
+    const size_t    INLINE_BONUS_CONST_ARG = 2; // Constant arguments can be propagated into the inlined body
+    const size_t    INLINE_THRESHOLD = 10;  // Allowed excess of cost over benefit
+    const size_t    INLINE_THRESHOLD_HINT = 40; // - Same, for `#[inline]` functions
+    const size_t    INLINE_BUDGET_MIN = 100;    // Minimum total cost that can be inlined into a caller
+    const size_t    INLINE_BUDGET_FACTOR = 2;   // - Otherwise, a caller can grow to this multiple of its initial cost
+
+    /// Approximate size of the code generated for a function
+    size_t get_inline_cost(const ::MIR::Function& fcn)
+    {
+        size_t rv = 0;
+        for(const auto& bb : fcn.blocks)
+        {
+            for(const auto& stmt : bb.statements)
+            {
+                TU_MATCHA( (stmt), (se),
+                (Assign,
+                    rv += 1;
+                    ),
+                (Asm,
+                    rv += INLINE_COST_ASM;
+                    ),
+                (SetDropFlag,
+                    rv += 1;
+                    ),
+                (Drop,
+                    rv += INLINE_COST_DROP;
+                    ),
+                (ScopeEnd,
+                    )
+                )
+            }
+            TU_MATCHA( (bb.terminator), (te),
+            (Incomplete,
+                ),
+            (Return,
+                ),
+            (Diverge,
+                ),
+            (Goto,
+                ),
+            (Panic,
+                rv += 1;
+                ),
+            (If,
+                rv += 1;
+                ),
+            (Switch,
+                rv += 1 + te.targets.size() / 2;
+                ),
+            (SwitchValue,
+                rv += 1 + te.targets.size() / 2;
+                ),
+            (Call,
+                rv += INLINE_COST_CALL + te.args.size();
+                )
+            )
+        }
+        return rv;
+    }
+    /// Total cost of callees that can be inlined into this function
+    size_t get_inline_budget(const ::MIR::Function& fcn)
+    {
+        return ::std::max(INLINE_BUDGET_MIN, get_inline_cost(fcn) * INLINE_BUDGET_FACTOR);
+    }
+
+    /// Set by `MIR::visit_crate_callee_first`, ensures that a callee's MIR is ready before it's inlined
+    /// - Returns false if the callee can't be used yet (it's part of a call cycle that's being processed)
+    ::std::function<bool(const ::HIR::ExprPtr&)>    g_prepare_callee;
+    const ::MIR::Function* get_callee_mir(const ::HIR::Function& fcn, const ::HIR::Function*& out_fcn)
+    {
+        if( g_prepare_callee && !g_prepare_callee(fcn.m_code) )
+            return nullptr;
+        out_fcn = &fcn;
+        return fcn.m_code.m_mir ? &*fcn.m_code.m_mir : nullptr;
+    }
+
     struct ParamsSet {
         ::HIR::PathParams   impl_params;
         const ::HIR::PathParams*  fcn_params;
@@ -270,19 +350,20 @@ namespace {
             self_ty(nullptr)
         {}
 
-        t_cb_generic get_cb(const Span& sp) const {
+        ::std::function<const ::HIR::TypeRef&(const ::HIR::TypeRef&)> get_cb(const Span& sp) const {
             return monomorphise_type_get_cb(sp, self_ty, &impl_params, fcn_params, nullptr);
         }
     };
-    const ::MIR::Function* get_called_mir(const ::MIR::TypeResolve& state, const ::HIR::Path& path, ParamsSet& params)
+    /// Locate the MIR for the target of a call (and the function that contains it), returns nullptr if it's not known
+    const ::MIR::Function* get_called_mir(const ::MIR::TypeResolve& state, const ::HIR::Path& path, ParamsSet& params, const ::HIR::Function*& out_fcn)
     {
         TU_MATCHA( (path.m_data), (pe),
         (Generic,
             const auto& fcn = state.m_crate.get_function_by_path(state.sp, pe.m_path);
-            if( fcn.m_code.m_mir )
+            if( const auto* mir = get_callee_mir(fcn, out_fcn) )
             {
                 params.fcn_params = &pe.m_params;
-                return &*fcn.m_code.m_mir;
+                return mir;
             }
             ),
         (UfcsKnown,
@@ -354,14 +435,12 @@ namespace {
             {
                 params.impl_params.m_types = mv$(best_impl_params);
                 DEBUG("Found impl" << impl.m_params.fmt_args() << " " << impl.m_type);
-                if( fit->second.data.m_code.m_mir )
-                    return &*fit->second.data.m_code.m_mir;
+                return get_callee_mir(fit->second.data, out_fcn);
             }
             else
             {
                 params.impl_params = pe.trait.m_params.clone();
-                if( ve.m_code.m_mir )
-                    return &*ve.m_code.m_mir;
+                return get_callee_mir(ve, out_fcn);
             }
             return nullptr;
             ),
@@ -381,12 +460,12 @@ namespace {
             MIR_ASSERT(state, best_impl, "Couldn't find an impl for " << path);
             auto fit = best_impl->m_methods.find(pe.item);
             MIR_ASSERT(state, fit != best_impl->m_methods.end(), "Couldn't find method in best inherent impl");
-            if( fit->second.data.m_code.m_mir )
+            if( const auto* mir = get_callee_mir(fit->second.data, out_fcn) )
             {
                 params.self_ty = &*pe.type;
                 params.fcn_params = &pe.params;
                 params.impl_params = pe.impl_params.clone();
-                return &*fit->second.data.m_code.m_mir;
+                return mir;
             }
             return nullptr;
             ),
@@ -458,6 +537,37 @@ namespace {
         visit_blocks_mut(state, const_cast<::MIR::Function&>(fcn), [cb](auto id, auto& blk){ cb(id, blk); });
     }
 
+    /// Determine the (single) predecessor of each block, `SIZE_MAX` if there's more than one (or none)
+    /// - Allows searching backwards through the block tree
+    ::std::vector<size_t> get_block_origins(const ::MIR::Function& fcn)
+    {
+        ::std::vector<size_t>   block_origins( fcn.blocks.size(), SIZE_MAX );
+        ::std::vector<unsigned int> block_uses( fcn.blocks.size() );
+        ::std::vector<bool> visited( fcn.blocks.size() );
+        ::std::vector< ::MIR::BasicBlockId> to_visit;
+        to_visit.push_back( 0 );
+        block_uses[0] ++;
+        while( to_visit.size() > 0 )
+        {
+            auto bb = to_visit.back(); to_visit.pop_back();
+            if( visited[bb] )
+                continue ;
+            visited[bb] = true;
+            const auto& block = fcn.blocks[bb];
+
+            visit_terminator_target(block.terminator, [&](const auto& idx) {
+                if( !visited[idx] )
+                    to_visit.push_back(idx);
+                if(block_uses[idx] == 0)
+                    block_origins[idx] = bb;
+                else
+                    block_origins[idx] = SIZE_MAX;
+                block_uses[idx] ++;
+                });
+        }
+        return block_origins;
+    }
+
     bool statement_invalidates_lvalue(const ::MIR::Statement& stmt, const ::MIR::LValue& lv)
     {
         return visit_mir_lvalues(stmt, [&](const auto& v, auto vu) {
@@ -486,12 +596,13 @@ namespace {
 }
 
 bool MIR_Optimise_BlockSimplify(::MIR::TypeResolve& state, ::MIR::Function& fcn);
-bool MIR_Optimise_Inlining(::MIR::TypeResolve& state, ::MIR::Function& fcn, bool minimal);
+bool MIR_Optimise_Inlining(::MIR::TypeResolve& state, ::MIR::Function& fcn, bool minimal, size_t& budget);
 bool MIR_Optimise_PropagateSingleAssignments(::MIR::TypeResolve& state, ::MIR::Function& fcn);
 bool MIR_Optimise_PropagateKnownValues(::MIR::TypeResolve& state, ::MIR::Function& fcn);
 bool MIR_Optimise_UnifyTemporaries(::MIR::TypeResolve& state, ::MIR::Function& fcn);
 bool MIR_Optimise_UnifyBlocks(::MIR::TypeResolve& state, ::MIR::Function& fcn);
 bool MIR_Optimise_ConstPropagte(::MIR::TypeResolve& state, ::MIR::Function& fcn);
+bool MIR_Optimise_Devirtualise(::MIR::TypeResolve& state, ::MIR::Function& fcn);
 bool MIR_Optimise_DeadDropFlags(::MIR::TypeResolve& state, ::MIR::Function& fcn);
 bool MIR_Optimise_GarbageCollect_Partial(::MIR::TypeResolve& state, ::MIR::Function& fcn);
 bool MIR_Optimise_GarbageCollect(::MIR::TypeResolve& state, ::MIR::Function& fcn);
@@ -506,7 +617,8 @@ void MIR_OptimiseMin(const StaticTraitResolve& resolve, const ::HIR::ItemPath& p
     TRACE_FUNCTION_F(path);
     ::MIR::TypeResolve   state { sp, resolve, FMT_CB(ss, ss << path;), ret_type, args, fcn };
 
-    while( MIR_Optimise_Inlining(state, fcn, true) )
+    size_t  inline_budget = get_inline_budget(fcn);
+    while( MIR_Optimise_Inlining(state, fcn, true, inline_budget) )
     {
         MIR_Cleanup(resolve, path, fcn, args, ret_type);
         //MIR_Dump_Fcn(::std::cout, fcn);
@@ -535,6 +647,7 @@ void MIR_Optimise(const StaticTraitResolve& resolve, const ::HIR::ItemPath& path
     TRACE_FUNCTION_F(path);
     ::MIR::TypeResolve   state { sp, resolve, FMT_CB(ss, ss << path;), ret_type, args, fcn };
 
+    size_t  inline_budget = get_inline_budget(fcn);
     bool change_happened;
     unsigned int pass_num = 0;
     do
@@ -558,6 +671,13 @@ void MIR_Optimise(const StaticTraitResolve& resolve, const ::HIR::ItemPath& path
         MIR_Validate(resolve, path, fcn, args, ret_type);
 #endif
 
+        // >> Call methods directly if the vtable they're loaded from is known
+        //   - Undoes the vtable lookups from `MIR_Cleanup` after a trait object was created in this function (exposing them to inlining)
+        change_happened |= MIR_Optimise_Devirtualise(state, fcn);
+#if CHECK_AFTER_ALL
+        MIR_Validate(resolve, path, fcn, args, ret_type);
+#endif
+
         // TODO: Convert `&mut *mut_foo` into `mut_foo` if the source is movable and not used afterwards
 
 #if DUMP_BEFORE_ALL || DUMP_BEFORE_PSA
@@ -592,7 +712,7 @@ void MIR_Optimise(const StaticTraitResolve& resolve, const ::HIR::ItemPath& path
         // >> Inline short functions
         if( !change_happened )
         {
-            bool inline_happened = MIR_Optimise_Inlining(state, fcn, false);
+            bool inline_happened = MIR_Optimise_Inlining(state, fcn, false, inline_budget);
             if( inline_happened )
             {
                 // Apply cleanup again (as monomorpisation in inlining may have exposed a vtable call)
@@ -738,46 +858,70 @@ bool MIR_Optimise_BlockSimplify(::MIR::TypeResolve& state, ::MIR::Function& fcn)
 // --------------------------------------------------------------------
 // If two temporaries don't overlap in lifetime (blocks in which they're valid), unify the two
 // --------------------------------------------------------------------
-bool MIR_Optimise_Inlining(::MIR::TypeResolve& state, ::MIR::Function& fcn, bool minimal)
+bool MIR_Optimise_Inlining(::MIR::TypeResolve& state, ::MIR::Function& fcn, bool minimal, size_t& budget)
 {
-    TRACE_FUNCTION;
+    TRACE_FUNCTION_F("budget=" << budget);
 
     struct H
     {
-        static bool can_inline(const ::HIR::Path& path, const ::MIR::Function& fcn, bool minimal)
+        /// Returns true if the function body contains a direct call to `path`
+        static bool calls_path(const ::MIR::Function& fcn, const ::HIR::Path& path)
         {
-            // TODO: If the function is marked as `inline(always)`, then inline it regardless of the contents
-
-            if( minimal ) {
+            for(const auto& bb : fcn.blocks)
+            {
+                if( const auto* te = bb.terminator.opt_Call() )
+                {
+                    if( te->fcn.is_Path() && te->fcn.as_Path() == path )
+                        return true;
+                }
+            }
+            return false;
+        }
+        /// Cost model: inline if the size of the callee doesn't exceed the benefit of removing the call by more than a
+        /// threshold (larger for `#[inline]` functions), and the caller's growth budget allows it.
+        static bool can_inline(const ::HIR::Path& path, const ::MIR::Function& fcn, ::HIR::Function::InlineHint hint, bool minimal, const ::MIR::Terminator::Data_Call& te, size_t& budget)
+        {
+            if( hint == ::HIR::Function::InlineHint::Never ) {
+                DEBUG("- #[inline(never)]");
+                return false;
+            }
+            // Detect and avoid simple recursion.
+            // - Mutual recursion is prevented by `get_called_mir` (functions that are still being optimised aren't returned)
+            if( calls_path(fcn, path) ) {
+                DEBUG("- Recursive");
                 return false;
             }
 
-            // TODO: If the function is marked as `inline(never)`, then don't inline
-
-            // TODO: Allow functions that are just a switch on an input.
-            if( fcn.blocks.size() == 1 )
-            {
-                return fcn.blocks[0].statements.size() < 10 && ! fcn.blocks[0].terminator.is_Goto();
+            auto cost = get_inline_cost(fcn);
+            // NOTE: The budget applies to `#[inline(always)]` too, it's what ensures that inlining terminates
+            if( cost > budget ) {
+                DEBUG("- Cost " << cost << " exceeds remaining budget " << budget);
+                return false;
             }
-            else if( fcn.blocks.size() == 3 && fcn.blocks[0].terminator.is_Call() )
+
+            if( hint != ::HIR::Function::InlineHint::Always )
             {
-                const auto& blk0_te = fcn.blocks[0].terminator.as_Call();
-                if( !(fcn.blocks[1].terminator.is_Diverge() || fcn.blocks[1].terminator.is_Return()) )
+                // Minimal optimisation only inlines `#[inline(always)]` functions
+                if( minimal ) {
                     return false;
-                if( !(fcn.blocks[2].terminator.is_Diverge() || fcn.blocks[2].terminator.is_Return()) )
-                    return false;
-                if( fcn.blocks[0].statements.size() + fcn.blocks[1].statements.size() + fcn.blocks[2].statements.size() > 10 )
-                    return false;
-                // Detect and avoid simple recursion.
-                // - This won't detect mutual recursion - that also needs prevention.
-                if( blk0_te.fcn.is_Path() && blk0_te.fcn.as_Path() == path )
+                }
+
+                // Benefit: The call (and the argument moves) go away, and constant arguments can be propagated into the body
+                size_t benefit = INLINE_COST_CALL + te.args.size();
+                for(const auto& a : te.args)
+                {
+                    if( a.is_Constant() )
+                        benefit += INLINE_BONUS_CONST_ARG;
+                }
+                size_t threshold = (hint == ::HIR::Function::InlineHint::Hint ? INLINE_THRESHOLD_HINT : INLINE_THRESHOLD);
+                if( cost > benefit + threshold ) {
+                    DEBUG("- Cost " << cost << " > benefit " << benefit << " + threshold " << threshold);
                     return false;
-                return true;
-            }
-            else
-            {
-                return false;
+                }
             }
+
+            budget -= cost;
+            return true;
         }
     };
     struct Cloner
@@ -1134,15 +1278,19 @@ bool MIR_Optimise_Inlining(::MIR::TypeResolve& state, ::MIR::Function& fcn, bool
             const auto& path = te->fcn.as_Path();
 
             Cloner  cloner { state.sp, state.m_resolve, *te };
-            const auto* called_mir = get_called_mir(state, path,  cloner.params);
+            const ::HIR::Function*  called_fcn = nullptr;
+            const auto* called_mir = get_called_mir(state, path,  cloner.params, called_fcn);
             if( !called_mir )
                 continue ;
+            // Never inline a function into itself (the source would be modified while it's being copied)
+            if( called_mir == &fcn )
+                continue ;
 
-            // Check the size of the target function.
-            // Inline IF:
-            // - First BB ends with a call and total count is 3
-            // - Statement count smaller than 10
-            if( ! H::can_inline(path, *called_mir, minimal) )
+            // `#[cold]` functions stay out of line (unless inlining is forced)
+            auto hint = called_fcn->m_inline;
+            if( called_fcn->m_cold && hint != ::HIR::Function::InlineHint::Always )
+                hint = ::HIR::Function::InlineHint::Never;
+            if( ! H::can_inline(path, *called_mir, hint, minimal, *te, budget) )
             {
                 DEBUG("Can't inline " << path);
                 continue ;
@@ -1511,32 +1659,7 @@ bool MIR_Optimise_PropagateKnownValues(::MIR::TypeResolve& state, ::MIR::Functio
 {
     TRACE_FUNCTION;
     // 1. Determine reference counts for blocks (allows reversing up BB tree)
-    ::std::vector<size_t>   block_origins( fcn.blocks.size(), SIZE_MAX );
-    {
-        ::std::vector<unsigned int> block_uses( fcn.blocks.size() );
-        ::std::vector<bool> visited( fcn.blocks.size() );
-        ::std::vector< ::MIR::BasicBlockId> to_visit;
-        to_visit.push_back( 0 );
-        block_uses[0] ++;
-        while( to_visit.size() > 0 )
-        {
-            auto bb = to_visit.back(); to_visit.pop_back();
-            if( visited[bb] )
-                continue ;
-            visited[bb] = true;
-            const auto& block = fcn.blocks[bb];
-
-            visit_terminator_target(block.terminator, [&](const auto& idx) {
-                if( !visited[idx] )
-                    to_visit.push_back(idx);
-                if(block_uses[idx] == 0)
-                    block_origins[idx] = bb;
-                else
-                    block_origins[idx] = SIZE_MAX;
-                block_uses[idx] ++;
-                });
-        }
-    }
+    auto block_origins = get_block_origins(fcn);
 
     // 2. Find any assignments (or function uses?) of the form FIELD(LOCAL, _)
     //  > Restricted to simplify logic (and because that's the inefficient pattern observed)
@@ -1664,6 +1787,206 @@ bool MIR_Optimise_PropagateKnownValues(::MIR::TypeResolve& state, ::MIR::Functio
     return change_happend;
 }
 
+// --------------------------------------------------------------------
+// Replace calls through a vtable with direct calls when the vtable is known
+// - `MIR_Cleanup` turns `<dyn Trait as Trait>::method(ptr, ...)` into a call through `(*DstMeta(ptr)).N`
+// - If the trait object was created in this function (e.g. `&T` to `&dyn Trait`, possibly after inlining), the
+//   `MakeDst` gives the vtable, and so the concrete method.
+// --------------------------------------------------------------------
+bool MIR_Optimise_Devirtualise(::MIR::TypeResolve& state, ::MIR::Function& fcn)
+{
+    TRACE_FUNCTION;
+
+    // Locals that are borrowed can be modified via the borrow, so their value can't be tracked
+    ::std::vector<bool> borrowed_locals( fcn.locals.size() );
+    bool has_vtable_calls = false;
+    for(const auto& block : fcn.blocks)
+    {
+        for(const auto& stmt : block.statements)
+        {
+            visit_mir_lvalues(stmt, [&](const auto& lv, auto vu) {
+                if( vu == ValUsage::Borrow && lv.is_Local() )
+                    borrowed_locals[lv.as_Local()] = true;
+                return false;
+                });
+        }
+        if( const auto* te = block.terminator.opt_Call() )
+        {
+            if( te->fcn.is_Value() )
+                has_vtable_calls = true;
+        }
+    }
+    if( !has_vtable_calls )
+        return false;
+
+    auto block_origins = get_block_origins(fcn);
+
+    // Search backwards from the end of a block for the vtable stored in `vtable_ptr_lv` (a `&Trait#vtable`)
+    // - Returns the `<Type as Trait>::#vtable` path
+    auto get_vtable = [&](const ::MIR::LValue& vtable_ptr_lv, size_t start_bb_idx)->const ::HIR::Path* {
+        TRACE_FUNCTION_F(vtable_ptr_lv << " BB" << start_bb_idx);
+        ::MIR::LValue   cur_lv = vtable_ptr_lv.clone();
+        // If true, `cur_lv` is the fat pointer (instead of the vtable pointer)
+        bool is_fat = false;
+
+        auto bb_idx = start_bb_idx;
+        auto stmt_idx = fcn.blocks[bb_idx].statements.size();
+        for(;;)
+        {
+            const auto& bb = fcn.blocks[bb_idx];
+            while(stmt_idx --)
+            {
+                if( !cur_lv.is_Local() || borrowed_locals[cur_lv.as_Local()] )
+                    return nullptr;
+                if( stmt_idx == bb.statements.size() )
+                {
+                    DEBUG("BB" << bb_idx << "/TERM - " << bb.terminator);
+                    if( terminator_invalidates_lvalue(bb.terminator, cur_lv) ) {
+                        return nullptr;
+                    }
+                    continue ;
+                }
+                const auto& stmt = bb.statements[stmt_idx];
+                if( const auto* se = stmt.opt_Assign() )
+                {
+                    if( se->dst == cur_lv )
+                    {
+                        DEBUG("BB" << bb_idx << "/" << stmt_idx << " - " << stmt);
+                        const ::MIR::Param* meta_param = nullptr;
+                        TU_MATCH_DEF( ::MIR::RValue, (se->src), (re),
+                        (
+                            return nullptr;
+                            ),
+                        (Use,
+                            cur_lv = re.clone();
+                            ),
+                        (Constant,
+                            if( is_fat )
+                                return nullptr;
+                            if( !re.is_ItemAddr() )
+                                return nullptr;
+                            return &re.as_ItemAddr();
+                            ),
+                        (Borrow,
+                            // Re-borrow of a trait object (same vtable)
+                            if( !is_fat || !re.val.is_Deref() )
+                                return nullptr;
+                            cur_lv = re.val.as_Deref().val->clone();
+                            ),
+                        (DstMeta,
+                            if( is_fat )
+                                return nullptr;
+                            cur_lv = re.val.clone();
+                            is_fat = true;
+                            ),
+                        (MakeDst,
+                            if( !is_fat )
+                                return nullptr;
+                            meta_param = &re.meta_val;
+                            )
+                        )
+                        if( meta_param )
+                        {
+                            if( const auto* c = meta_param->opt_Constant() )
+                            {
+                                if( !c->is_ItemAddr() )
+                                    return nullptr;
+                                return &c->as_ItemAddr();
+                            }
+                            cur_lv = meta_param->as_LValue().clone();
+                            is_fat = false;
+                        }
+                        continue ;
+                    }
+                }
+                if( statement_invalidates_lvalue(stmt, cur_lv) ) {
+                    return nullptr;
+                }
+            }
+            if( block_origins[bb_idx] == SIZE_MAX )
+                break;
+            bb_idx = block_origins[bb_idx];
+            stmt_idx = fcn.blocks[bb_idx].statements.size() + 1;
+        }
+        return nullptr;
+        };
+
+    bool changed = false;
+    for(auto& block : fcn.blocks)
+    {
+        size_t bb_idx = &block - &fcn.blocks.front();
+        auto* te = block.terminator.opt_Call();
+        if( !te || !te->fcn.is_Value() )
+            continue ;
+        // Only handle `(*vtable).N(ptr, ...)` as emitted by `MIR_Cleanup_Virtualize`
+        const auto& fcn_lv = te->fcn.as_Value();
+        if( !fcn_lv.is_Field() || !fcn_lv.as_Field().val->is_Deref() )
+            continue ;
+        const auto& vtable_ptr_lv = *fcn_lv.as_Field().val->as_Deref().val;
+        unsigned int vtable_idx = fcn_lv.as_Field().field_index;
+        if( te->args.empty() || !te->args[0].is_LValue() )
+            continue ;
+        state.set_cur_stmt_term(bb_idx);
+
+        const auto* vtable_path = get_vtable(vtable_ptr_lv, bb_idx);
+        if( !vtable_path )
+            continue ;
+        if( !vtable_path->m_data.is_UfcsKnown() || vtable_path->m_data.as_UfcsKnown().item != "#vtable" )
+            continue ;
+        const auto& vpe = vtable_path->m_data.as_UfcsKnown();
+        DEBUG(state << "Vtable is " << *vtable_path);
+
+        // Get the method at this index (the method may be from a supertrait)
+        const auto& trait = state.m_resolve.m_crate.get_trait_by_path(state.sp, vpe.trait.m_path);
+        const ::std::pair< const ::std::string, ::std::pair<unsigned int, ::HIR::GenericPath> >* method = nullptr;
+        for(const auto& m : trait.m_value_indexes)
+        {
+            if( m.second.first == vtable_idx )
+            {
+                method = &m;
+                break;
+            }
+        }
+        MIR_ASSERT(state, method, "Vtable index " << vtable_idx << " not found in " << vpe.trait);
+
+        // Receiver must be a borrow of `Self` (`Box` receivers are restructured by cleanup)
+        const auto& method_trait_def = state.m_resolve.m_crate.get_trait_by_path(state.sp, method->second.second.m_path);
+        const auto& method_def = method_trait_def.m_values.at(method->first).as_Function();
+        ::HIR::BorrowType   receiver_bt;
+        switch( method_def.m_receiver )
+        {
+        case ::HIR::Function::Receiver::BorrowShared:   receiver_bt = ::HIR::BorrowType::Shared;    break;
+        case ::HIR::Function::Receiver::BorrowUnique:   receiver_bt = ::HIR::BorrowType::Unique;    break;
+        case ::HIR::Function::Receiver::BorrowOwned:    receiver_bt = ::HIR::BorrowType::Owned;     break;
+        default:
+            DEBUG(state << "- Unsupported receiver type for " << method->first);
+            continue ;
+        }
+        auto monomorph_cb = monomorphise_type_get_cb(state.sp, &*vpe.type, &vpe.trait.m_params, nullptr);
+        auto method_trait = monomorphise_genericpath_with(state.sp, method->second.second, monomorph_cb, false);
+        auto method_path = ::HIR::Path( vpe.type->clone(), mv$(method_trait), method->first );
+        DEBUG(state << "- " << fcn_lv << " => " << method_path);
+
+        // Cast the erased receiver back to a pointer to the concrete type, and re-borrow it
+        auto ptr_lv = ::MIR::LValue::make_Local( static_cast<unsigned>(fcn.locals.size()) );
+        fcn.locals.push_back( ::HIR::TypeRef::new_pointer(receiver_bt, vpe.type->clone()) );
+        auto receiver_lv = ::MIR::LValue::make_Local( static_cast<unsigned>(fcn.locals.size()) );
+        fcn.locals.push_back( ::HIR::TypeRef::new_borrow(receiver_bt, vpe.type->clone()) );
+        block.statements.push_back(::MIR::Statement::make_Assign({
+            ptr_lv.clone(),
+            ::MIR::RValue::make_Cast({ mv$(te->args[0].as_LValue()), fcn.locals[ptr_lv.as_Local()].clone() })
+            }));
+        block.statements.push_back(::MIR::Statement::make_Assign({
+            receiver_lv.clone(),
+            ::MIR::RValue::make_Borrow({ 0, receiver_bt, ::MIR::LValue::make_Deref({ box$(ptr_lv) }) })
+            }));
+        te->args[0] = mv$(receiver_lv);
+        te->fcn = ::MIR::CallTarget::make_Path( mv$(method_path) );
+        changed = true;
+    }
+    return changed;
+}
+
 // --------------------------------------------------------------------
 // Propagate constants and eliminate known paths
 // --------------------------------------------------------------------
@@ -1687,7 +2010,7 @@ bool MIR_Optimise_ConstPropagte(::MIR::TypeResolve& state, ::MIR::Function& fcn)
         if( tef.name == "size_of" )
         {
             size_t size_val = 0;
-            if( Target_GetSizeOf(state.sp, tef.params.m_types.at(0), size_val) )
+            if( Target_GetSizeOf(state.sp, state.m_resolve, tef.params.m_types.at(0), size_val) && size_val != SIZE_MAX )
             {
                 auto val = ::MIR::Constant::make_Uint({ size_val, ::HIR::CoreType::Usize });
                 bb.statements.push_back(::MIR::Statement::make_Assign({ mv$(te.ret_val), mv$(val) }));
@@ -1695,10 +2018,10 @@ bool MIR_Optimise_ConstPropagte(::MIR::TypeResolve& state, ::MIR::Function& fcn)
                 changed = true;
             }
         }
-        else if( tef.name == "align_of" )
+        else if( tef.name == "min_align_of" )
         {
             size_t align_val = 0;
-            if( Target_GetAlignOf(state.sp, tef.params.m_types.at(0), align_val) )
+            if( Target_GetAlignOf(state.sp, state.m_resolve, tef.params.m_types.at(0), align_val) && align_val != 0 )
             {
                 auto val = ::MIR::Constant::make_Uint({ align_val, ::HIR::CoreType::Usize });
                 bb.statements.push_back(::MIR::Statement::make_Assign({ mv$(te.ret_val), mv$(val) }));
@@ -2938,9 +3261,139 @@ void MIR_SortBlocks(const StaticTraitResolve& resolve, const ::HIR::ItemPath& pa
 }
 
 
+namespace {
+    /// Owned copy of an `ItemPath` (the visitor's path nodes, and some of the data they point to, are temporaries)
+    class OwnedItemPath
+    {
+        // NOTE: Reserved up front, as the nodes point into these
+        ::std::vector< ::HIR::ItemPath> m_nodes;    // Root first, each node's parent is the one before it
+        ::std::vector< ::std::string>   m_strings;
+        ::std::vector< ::HIR::TypeRef>  m_types;
+        ::std::vector< ::HIR::SimplePath>   m_traits;
+        ::std::vector< ::HIR::PathParams>   m_params;
+    public:
+        OwnedItemPath(const ::HIR::ItemPath& p)
+        {
+            ::std::vector<const ::HIR::ItemPath*>   chain;
+            for(const auto* n = &p; n; n = n->parent)
+                chain.push_back(n);
+            m_nodes.reserve(chain.size());
+            m_strings.reserve(chain.size() * 2);
+            m_types.reserve(chain.size());
+            m_traits.reserve(chain.size());
+            m_params.reserve(chain.size());
+            for(auto it = chain.rbegin(); it != chain.rend(); ++it)
+            {
+                const auto& n = **it;
+                ::HIR::ItemPath node = n;
+                node.parent = m_nodes.empty() ? nullptr : &m_nodes.back();
+                if( n.ty ) {
+                    m_types.push_back( n.ty->clone() );
+                    node.ty = &m_types.back();
+                }
+                if( n.trait ) {
+                    m_traits.push_back( n.trait->clone() );
+                    node.trait = &m_traits.back();
+                }
+                if( n.trait_params ) {
+                    m_params.push_back( n.trait_params->clone() );
+                    node.trait_params = &m_params.back();
+                }
+                if( n.name ) {
+                    m_strings.push_back( n.name );
+                    node.name = m_strings.back().c_str();
+                }
+                if( n.crate_name ) {
+                    m_strings.push_back( n.crate_name );
+                    node.crate_name = m_strings.back().c_str();
+                }
+                m_nodes.push_back( node );
+            }
+        }
+        OwnedItemPath(const OwnedItemPath&) = delete;
+        OwnedItemPath(OwnedItemPath&&) = default;
+
+        const ::HIR::ItemPath& get() const { return m_nodes.back(); }
+    };
+}
+
+void MIR::visit_crate_callee_first(::HIR::Crate& crate, ::MIR::OuterVisitor::cb_t cb)
+{
+    static const ::HIR::Function::args_t    s_empty_args;
+    // Limit on nested callee visits (each is a full optimisation pass on the stack), deeper callees are visited later
+    // and aren't available to the inliner until then
+    const unsigned  MAX_DEPTH = 32;
+    struct Body
+    {
+        ::HIR::GenericParams*   impl_generics;
+        ::HIR::GenericParams*   item_generics;
+        OwnedItemPath   path;
+        ::HIR::ExprPtr* expr;
+        const ::HIR::Function::args_t*  args;
+        ::HIR::TypeRef  ret_type;
+        enum { Pending, Active, Done }  state;
+    };
+    ::std::vector<Body> bodies;
+    ::std::map<const ::HIR::ExprPtr*, size_t>   body_indexes;
+
+    // 1. Enumerate all bodies (and the generics they need)
+    {
+        ::MIR::OuterVisitor ov { crate, [&](const auto& res, const auto& p, auto& expr_ptr, const auto& args, const auto& ty){
+                body_indexes.insert(::std::make_pair( &expr_ptr, bodies.size() ));
+                bodies.push_back(Body {
+                    res.m_impl_generics, res.m_item_generics,
+                    OwnedItemPath(p),
+                    &expr_ptr,
+                    args.empty() ? &s_empty_args : &args,
+                    ty.clone(),
+                    Body::Pending
+                    });
+            } };
+        ov.visit_crate(crate);
+    }
+
+    // 2. Visit each body, visiting callees first when the inliner asks for them (depth-first, so the visit order is a
+    //    post-order over the call graph)
+    unsigned    depth = 0;
+    ::std::function<void(Body&)>    process_body;
+    process_body = [&](Body& b) {
+        if( b.state != Body::Pending )
+            return ;
+        b.state = Body::Active;
+        depth ++;
+
+        StaticTraitResolve  res { crate };
+        auto _ig = b.impl_generics ? res.set_impl_generics(*b.impl_generics) : StaticTraitResolve::NullOnDrop< ::HIR::GenericParams>(res.m_impl_generics);
+        auto _fg = b.item_generics ? res.set_item_generics(*b.item_generics) : StaticTraitResolve::NullOnDrop< ::HIR::GenericParams>(res.m_item_generics);
+        cb(res, b.path.get(), *b.expr, *b.args, b.ret_type);
+        b.state = Body::Done;
+        depth --;
+        };
+
+    // NOTE: A callee that's still active is part of a call cycle with the current body, so isn't available for inlining
+    g_prepare_callee = [&](const ::HIR::ExprPtr& code)->bool {
+        auto it = body_indexes.find(&code);
+        if( it == body_indexes.end() )
+            return true;
+        auto& b = bodies[it->second];
+        if( b.state == Body::Pending && depth >= MAX_DEPTH ) {
+            DEBUG("Callee " << b.path.get() << " not visited, depth limit reached");
+            return false;
+        }
+        process_body(b);
+        return b.state == Body::Done;
+        };
+    for(auto& b : bodies)
+    {
+        process_body(b);
+    }
+    g_prepare_callee = nullptr;
+}
+
 void MIR_OptimiseCrate(::HIR::Crate& crate, bool do_minimal_optimisation)
 {
-    ::MIR::OuterVisitor ov { crate, [do_minimal_optimisation](const auto& res, const auto& p, auto& expr, const auto& args, const auto& ty)
+    // Optimise callees before their callers, so the inliner sees (and estimates the cost of) optimised bodies
+    ::MIR::visit_crate_callee_first(crate, [do_minimal_optimisation](const auto& res, const auto& p, auto& expr, const auto& args, const auto& ty)
         {
             if( ! dynamic_cast<::HIR::ExprNode_Block*>(expr.get()) ) {
                 return ;
@@ -2951,8 +3404,6 @@ void MIR_OptimiseCrate(::HIR::Crate& crate, bool do_minimal_optimisation)
             else {
                 MIR_Optimise(res, p, *expr.m_mir, args, ty);
             }
-        }
-        };
-    ov.visit_crate(crate);
+        });
 }
 
@@ -0,0 +1,99 @@
+/*
+ * MRustC - Rust Compiler
+ * - By John Hodge (Mutabah/thePowersGang)
+ *
+ * mir/per_body.cpp
+ * - Function-at-a-time MIR pipeline
+ *
+ * Instead of running each MIR pass over the whole crate, this takes each body
+ * through lowering, cleanup, optimisation, and validation before moving on to
+ * the next one (so only one unoptimised body is alive at a time).
+ *
+ * Bodies reachable from constant evaluation (constants, statics, enum values,
+ * array sizes and `const fn`s) are lowered and cleaned up up-front, so that
+ * every body with MIR attached is always in a state suitable for inlining.
+ * Other bodies are processed on demand when the inliner looks at them, so
+ * callees are optimised before their callers (as far as recursion allows).
+ * Each body's HIR expression tree is released as soon as it's done.
+ */
+#include "main_bindings.hpp"
+#include "mir.hpp"
+#include <hir/visitor.hpp>
+#include <hir_typeck/static.hpp>
+#include <mir/operations.hpp>
+#include <mir/visit_crate_mir.hpp>
+
+#include <hir/expr.hpp> // ExprNode_Block
+
+namespace {
+    /// Visits only the bodies that constant evaluation can call into
+    class ConstOuterVisitor:
+        public ::MIR::OuterVisitor
+    {
+    public:
+        ConstOuterVisitor(const ::HIR::Crate& crate, cb_t cb):
+            ::MIR::OuterVisitor(crate, mv$(cb))
+        {}
+
+        void visit_function(::HIR::ItemPath p, ::HIR::Function& item) override
+        {
+            if( item.m_const )
+            {
+                ::MIR::OuterVisitor::visit_function(p, item);
+            }
+        }
+    };
+}
+
+void HIR_GenerateMIR_Const(::HIR::Crate& crate)
+{
+    ConstOuterVisitor   ov { crate, [&](const auto& res, const auto& p, auto& expr_ptr, const auto& args, const auto& ty){
+            expr_ptr.m_mir = LowerMIR(res, p, expr_ptr, args);
+        } };
+    ov.visit_crate(crate);
+}
+
+void MIR_CleanupCrate_Const(::HIR::Crate& crate)
+{
+    ConstOuterVisitor   ov { crate, [&](const auto& res, const auto& p, auto& expr_ptr, const auto& args, const auto& ty){
+            MIR_Cleanup(res, p, *expr_ptr.m_mir, args, ty);
+        } };
+    ov.visit_crate(crate);
+}
+
+void MIR_ProcessCrate_PerBody(::HIR::Crate& crate, bool minimal_optimisations, bool full_validate_early, bool full_validate)
+{
+    // Take each body through the pipeline, callees that are considered for inlining are processed first
+    ::MIR::visit_crate_callee_first(crate, [&](const auto& res, const auto& p, auto& expr_ptr, const auto& args, const auto& ty) {
+        // Constant bodies were lowered and cleaned up before constant evaluation
+        if( !expr_ptr.m_mir )
+        {
+            // NOTE: LowerMIR validates the generated MIR
+            expr_ptr.m_mir = LowerMIR(res, p, expr_ptr, args);
+            MIR_Cleanup(res, p, *expr_ptr.m_mir, args, ty);
+        }
+        auto& fcn = *expr_ptr.m_mir;
+        if( full_validate_early )
+        {
+            MIR_Validate_Full(res, p, fcn, args, ty);
+        }
+
+        if( dynamic_cast<::HIR::ExprNode_Block*>(expr_ptr.get()) )
+        {
+            if( minimal_optimisations ) {
+                MIR_OptimiseMin(res, p, fcn, args, ty);
+            }
+            else {
+                MIR_Optimise(res, p, fcn, args, ty);
+            }
+        }
+
+        MIR_Validate(res, p, fcn, args, ty);
+        if( full_validate )
+        {
+            MIR_Validate_Full(res, p, fcn, args, ty);
+        }
+        // The expression tree is no longer needed (the inliner only looks at MIR)
+        expr_ptr.release_tree();
+        });
+}
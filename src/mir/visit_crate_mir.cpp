@@ -31,7 +31,7 @@ void MIR::OuterVisitor::visit_type(::HIR::TypeRef& ty)
 void MIR::OuterVisitor::visit_function(::HIR::ItemPath p, ::HIR::Function& item)
 {
     auto _ = this->m_resolve.set_item_generics(item.m_params);
-    if( item.m_code )
+    if( item.m_code.has_body() )
     {
         DEBUG("Function code " << p);
         // TODO: Get span without needing hir/expr.hpp
@@ -56,14 +56,14 @@ void MIR::OuterVisitor::visit_function(::HIR::ItemPath p, ::HIR::Function& item)
 }
 void MIR::OuterVisitor::visit_static(::HIR::ItemPath p, ::HIR::Static& item)
 {
-    if( item.m_value ) {
+    if( item.m_value.has_body() ) {
         DEBUG("`static` value " << p);
         m_cb(m_resolve, p, item.m_value, {}, item.m_type);
     }
 }
 void MIR::OuterVisitor::visit_constant(::HIR::ItemPath p, ::HIR::Constant& item)
 {
-    if( item.m_value ) {
+    if( item.m_value.has_body() ) {
         DEBUG("`const` value " << p);
         m_cb(m_resolve, p, item.m_value, {}, item.m_type);
     }
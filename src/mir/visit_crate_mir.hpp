@@ -43,5 +43,11 @@ public:
     void visit_trait_impl(const ::HIR::SimplePath& trait_path, ::HIR::TraitImpl& impl) override;
 };
 
+/// Visit every body in the crate in callee-first order (bottom-up over the call graph)
+/// - A callee that the inliner looks at is visited before the caller that looked at it
+/// - Bodies that are part of a call cycle are not handed to the inliner while they're being visited
+/// NOTE: Defined in optimise.cpp (it hooks the inliner's callee lookup)
+extern void visit_crate_callee_first(::HIR::Crate& crate, OuterVisitor::cb_t cb);
+
 
 }   // namespace MIR
@@ -0,0 +1,113 @@
+/*
+ * MRustC - Rust Compiler
+ * - By John Hodge (Mutabah/thePowersGang)
+ *
+ * node_pool.cpp
+ * - Pooled allocation for expression tree nodes
+ */
+#include <node_pool.hpp>
+#include <new>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#ifdef _WIN32
+# include <malloc.h>
+#endif
+
+namespace {
+    /// Allocation granularity (and alignment of every pooled allocation)
+    const size_t    GRANULE = alignof(::std::max_align_t);
+    /// Allocations larger than this go directly to the global allocator
+    const size_t    MAX_POOLED_SIZE = 512;
+    /// Size (and alignment) of a chunk, the owning chunk of a node is found by masking the node's address
+    const size_t    CHUNK_SIZE = 256 * 1024;
+
+    struct Chunk
+    {
+        /// Count of live nodes in this chunk, plus one while it's a pool's current chunk
+        ::std::atomic<size_t>   refcount;
+    };
+    const size_t    HEADER_SIZE = (sizeof(Chunk) + GRANULE - 1) / GRANULE * GRANULE;
+
+    Chunk* chunk_alloc()
+    {
+        void*   mem;
+#ifdef _WIN32
+        mem = _aligned_malloc(CHUNK_SIZE, CHUNK_SIZE);
+        if( !mem )
+            throw ::std::bad_alloc();
+#else
+        if( posix_memalign(&mem, CHUNK_SIZE, CHUNK_SIZE) != 0 )
+            throw ::std::bad_alloc();
+#endif
+        auto* rv = static_cast<Chunk*>(mem);
+        new(&rv->refcount) ::std::atomic<size_t>(1);
+        return rv;
+    }
+    void chunk_release(Chunk* c)
+    {
+        if( c->refcount.fetch_sub(1) == 1 )
+        {
+            c->refcount.~atomic();
+#ifdef _WIN32
+            _aligned_free(c);
+#else
+            free(c);
+#endif
+        }
+    }
+
+    /// Per-thread bump allocator, only the current chunk is referenced (filled chunks are freed by their last node)
+    struct Pool
+    {
+        Chunk*  cur = nullptr;
+        uint8_t*    bump_cur = nullptr;
+        uint8_t*    bump_end = nullptr;
+
+        ~Pool()
+        {
+            if( cur )
+                chunk_release(cur);
+        }
+    };
+    thread_local Pool   t_pool;
+}
+
+void* NodePool::allocate(size_t size)
+{
+    if( size == 0 || size > MAX_POOLED_SIZE )
+        return ::operator new(size);
+
+    auto& pool = t_pool;
+    size_t alloc_size = (size + GRANULE - 1) / GRANULE * GRANULE;
+    if( pool.cur == nullptr || static_cast<size_t>(pool.bump_end - pool.bump_cur) < alloc_size )
+    {
+        // If every node in the current chunk has been freed, start again from the beginning of it
+        // - Other threads only ever decrement the count, so seeing just the pool's reference is stable
+        if( pool.cur == nullptr || pool.cur->refcount.load() != 1 )
+        {
+            if( pool.cur != nullptr )
+                chunk_release(pool.cur);
+            pool.cur = chunk_alloc();
+            pool.bump_end = reinterpret_cast<uint8_t*>(pool.cur) + CHUNK_SIZE;
+        }
+        pool.bump_cur = reinterpret_cast<uint8_t*>(pool.cur) + HEADER_SIZE;
+    }
+    pool.cur->refcount.fetch_add(1);
+    void* rv = pool.bump_cur;
+    pool.bump_cur += alloc_size;
+    return rv;
+}
+
+void NodePool::deallocate(void* ptr, size_t size)
+{
+    if( ptr == nullptr )
+        return ;
+    if( size == 0 || size > MAX_POOLED_SIZE )
+    {
+        ::operator delete(ptr);
+        return ;
+    }
+
+    chunk_release( reinterpret_cast<Chunk*>(reinterpret_cast<uintptr_t>(ptr) & ~static_cast<uintptr_t>(CHUNK_SIZE - 1)) );
+}
@@ -1310,56 +1310,63 @@ ExprNodeP Parse_ExprMacro(TokenStream& lex, AST::Path path)
 }
 
 // Token Tree Parsing
-TokenTree Parse_TT(TokenStream& lex, bool unwrapped)
-{
-    TokenTree   rv;
-    TRACE_FUNCTION_FR("", rv);
-
-    Token tok = lex.getToken();
-    eTokenType  closer = TOK_PAREN_CLOSE;
-    switch(tok.type())
+namespace {
+    /// Parse a token tree, appending it to the flattened tree `rv`
+    void Parse_TT_Inner(TokenStream& lex, bool unwrapped, TokenTree& rv)
     {
-    case TOK_PAREN_OPEN:
-        closer = TOK_PAREN_CLOSE;
-        break;
-    case TOK_SQUARE_OPEN:
-        closer = TOK_SQUARE_CLOSE;
-        break;
-    case TOK_BRACE_OPEN:
-        closer = TOK_BRACE_CLOSE;
-        break;
-    // HACK! mrustc parses #[ and #![ as composite tokens
-    // TODO: Split these into their component tokens.
-    case TOK_ATTR_OPEN:
-    case TOK_CATTR_OPEN:
-        if( unwrapped )
+        Token tok = lex.getToken();
+        eTokenType  closer = TOK_PAREN_CLOSE;
+        switch(tok.type())
+        {
+        case TOK_PAREN_OPEN:
+            closer = TOK_PAREN_CLOSE;
+            break;
+        case TOK_SQUARE_OPEN:
+            closer = TOK_SQUARE_CLOSE;
+            break;
+        case TOK_BRACE_OPEN:
+            closer = TOK_BRACE_CLOSE;
+            break;
+        // HACK! mrustc parses #[ and #![ as composite tokens
+        // TODO: Split these into their component tokens.
+        case TOK_ATTR_OPEN:
+        case TOK_CATTR_OPEN:
+            if( unwrapped )
+                throw ParseError::Unexpected(lex, tok);
+            closer = TOK_SQUARE_CLOSE;
+            break;
+
+        case TOK_EOF:
+        case TOK_NULL:
+        case TOK_PAREN_CLOSE:
+        case TOK_SQUARE_CLOSE:
+        case TOK_BRACE_CLOSE:
             throw ParseError::Unexpected(lex, tok);
-        closer = TOK_SQUARE_CLOSE;
-        break;
+        default:
+            rv.push_token( lex.getHygiene(), mv$(tok) );
+            return ;
+        }
 
-    case TOK_EOF:
-    case TOK_NULL:
-    case TOK_PAREN_CLOSE:
-    case TOK_SQUARE_CLOSE:
-    case TOK_BRACE_CLOSE:
-        throw ParseError::Unexpected(lex, tok);
-    default:
-        rv = TokenTree(lex.getHygiene(), mv$(tok) );
-        return rv;
+        auto group = rv.start_group();
+        if( !unwrapped )
+            rv.push_token( lex.getHygiene(), mv$(tok) );
+        while(GET_TOK(tok, lex) != closer && tok.type() != TOK_EOF)
+        {
+            if( tok.type() == TOK_NULL )
+                throw ParseError::Unexpected(lex, tok);
+            PUTBACK(tok, lex);
+            Parse_TT_Inner(lex, false, rv);
+        }
+        if( !unwrapped )
+            rv.push_token( lex.getHygiene(), mv$(tok) );
+        rv.end_group( group, lex.getHygiene() );
     }
+}
+TokenTree Parse_TT(TokenStream& lex, bool unwrapped)
+{
+    TokenTree   rv;
+    TRACE_FUNCTION_FR("", rv);
 
-    ::std::vector<TokenTree>   items;
-    if( !unwrapped )
-        items.push_back( TokenTree(lex.getHygiene(), mv$(tok)) );
-    while(GET_TOK(tok, lex) != closer && tok.type() != TOK_EOF)
-    {
-        if( tok.type() == TOK_NULL )
-            throw ParseError::Unexpected(lex, tok);
-        PUTBACK(tok, lex);
-        items.push_back(Parse_TT(lex, false));
-    }
-    if( !unwrapped )
-        items.push_back( TokenTree(lex.getHygiene(), mv$(tok)) );
-    rv = TokenTree(lex.getHygiene(), mv$(items));
+    Parse_TT_Inner(lex, unwrapped, rv);
     return rv;
 }
@@ -8,48 +8,89 @@
 #include "tokentree.hpp"
 #include <common.hpp>
 
-TokenTree TokenTree::clone() const
+TokenTree::TokenTree(Ident::Hygiene hygiene, ::std::vector<TokenTree> subtrees)
 {
-    if( m_subtrees.size() == 0 ) {
-        return TokenTree(m_hygiene, m_tok.clone());
-    }
-    else {
-        ::std::vector< TokenTree>   ents;
-        ents.reserve( m_subtrees.size() );
-        for(const auto& sub : m_subtrees)
-            ents.push_back( sub.clone() );
-        return TokenTree( m_hygiene, mv$(ents) );
+    size_t count = 1;
+    for(const auto& sub : subtrees)
+        count += ::std::max<size_t>(sub.m_ents.size(), 1);
+    m_ents.reserve(count);
+
+    auto grp = this->start_group();
+    for(auto& sub : subtrees)
+    {
+        if( sub.m_ents.empty() ) {
+            // Empty subtree, keep as an empty group
+            this->end_group( this->start_group(), Ident::Hygiene() );
+        }
+        else {
+            for(auto& e : sub.m_ents)
+                m_ents.push_back( mv$(e) );
+        }
     }
+    this->end_group(grp, mv$(hygiene));
 }
 
-::std::ostream& operator<<(::std::ostream& os, const TokenTree& tt)
+TokenTree TokenTree::clone() const
+{
+    TokenTree   rv;
+    rv.m_ents.reserve( m_ents.size() );
+    for(const auto& e : m_ents)
+        rv.m_ents.push_back( Ent { e.hygiene, e.size, e.tok.clone() } );
+    return rv;
+}
+
+const Token& TokenTree::tok() const
 {
-    if( tt.m_subtrees.size() == 0 )
+    static Token    null_token;
+    return m_ents.empty() ? null_token : m_ents[0].tok;
+}
+const Ident::Hygiene& TokenTree::hygiene() const
+{
+    static Ident::Hygiene   null_hygiene;
+    return m_ents.empty() ? null_hygiene : m_ents[0].hygiene;
+}
+
+namespace {
+    void print_ent(::std::ostream& os, const ::std::vector<TokenTree::Ent>& ents, size_t idx)
     {
-        switch(tt.m_tok.type())
+        const auto& e = ents[idx];
+        if( e.tok.type() != TOK_NULL )
         {
-        case TOK_IDENT:
-        case TOK_LIFETIME:
-            os << "/*" << tt.m_hygiene << "*/";
-            break;
-        default:
-            if( TOK_INTERPOLATED_IDENT <= tt.m_tok.type() && tt.m_tok.type() <= TOK_INTERPOLATED_ITEM ) {
-                os << "/*int*/";
+            switch(e.tok.type())
+            {
+            case TOK_IDENT:
+            case TOK_LIFETIME:
+                os << "/*" << e.hygiene << "*/";
+                break;
+            default:
+                if( TOK_INTERPOLATED_IDENT <= e.tok.type() && e.tok.type() <= TOK_INTERPOLATED_ITEM ) {
+                    os << "/*int*/";
+                }
+                break;
             }
-            break;
+            os << e.tok.to_str();
         }
-        return os << tt.m_tok.to_str();
-    }
-    else {
-        os << "/*" << tt.m_hygiene << " TT*/";
-        // NOTE: All TTs (except the outer tt on a macro invocation) include the grouping
-        bool first = true;
-        for(const auto& i : tt.m_subtrees) {
-            if(!first)
-                os << " ";
-            os << i;
-            first = false;
+        else
+        {
+            os << "/*" << e.hygiene << " TT*/";
+            // NOTE: All TTs (except the outer tt on a macro invocation) include the grouping
+            bool first = true;
+            for(size_t i = idx + 1; i < idx + e.size; i += ents[i].size)
+            {
+                if(!first)
+                    os << " ";
+                print_ent(os, ents, i);
+                first = false;
+            }
         }
-        return os;
     }
 }
+
+::std::ostream& operator<<(::std::ostream& os, const TokenTree& tt)
+{
+    if( tt.m_ents.empty() ) {
+        return os << "/*" << Ident::Hygiene() << " TT*/";
+    }
+    print_ent(os, tt.m_ents, 0);
+    return os;
+}
@@ -12,48 +12,69 @@
 #include <ident.hpp>
 #include <vector>
 
+/// A tree of tokens (e.g. the input to a macro invocation)
+/// - Stored as a flat array: a group is a header entry (with a TOK_NULL token) followed by its contents, and the
+///   header records the number of entries it covers so the group can be skipped in one step.
+/// - An empty tree (no entries) is an empty group
 class TokenTree
 {
-    Ident::Hygiene m_hygiene;
-    Token   m_tok;
-    ::std::vector<TokenTree>    m_subtrees;
 public:
-    virtual ~TokenTree() {}
+    struct Ent
+    {
+        Ident::Hygiene  hygiene;
+        /// Number of entries covered by this entry (1 for a token, 1 + contents for a group)
+        unsigned int    size;
+        Token   tok;
+    };
+private:
+    ::std::vector<Ent>  m_ents;
+public:
     TokenTree() {}
     TokenTree(TokenTree&&) = default;
     TokenTree& operator=(TokenTree&&) = default;
-    TokenTree(enum eTokenType ty):
-        m_tok( Token(ty) )
+    TokenTree(enum eTokenType ty)
     {
+        push_token( Ident::Hygiene(), Token(ty) );
     }
-    TokenTree(Token tok):
-        m_tok( ::std::move(tok) )
+    TokenTree(Token tok)
     {
+        push_token( Ident::Hygiene(), ::std::move(tok) );
     }
-    TokenTree(Ident::Hygiene hygiene, Token tok):
-        m_hygiene( ::std::move(hygiene) ),
-        m_tok( ::std::move(tok) )
-    {
-    }
-    TokenTree(Ident::Hygiene hygiene, ::std::vector<TokenTree> subtrees):
-        m_hygiene( ::std::move(hygiene) ),
-        m_subtrees( ::std::move(subtrees) )
+    TokenTree(Ident::Hygiene hygiene, Token tok)
     {
+        push_token( ::std::move(hygiene), ::std::move(tok) );
     }
+    TokenTree(Ident::Hygiene hygiene, ::std::vector<TokenTree> subtrees);
 
     TokenTree clone() const;
 
-    bool is_token() const {
-        return m_tok.type() != TOK_NULL;
+    // --- Incremental construction (avoids re-flattening nested groups) ---
+    /// Append a token (to the innermost open group)
+    void push_token(Ident::Hygiene hygiene, Token tok) {
+        m_ents.push_back( Ent { ::std::move(hygiene), 1, ::std::move(tok) } );
     }
-    unsigned int size() const {
-        return m_subtrees.size();
+    /// Open a new group, returns a handle to pass to `end_group`
+    size_t start_group() {
+        m_ents.push_back( Ent { Ident::Hygiene(), 1, Token() } );
+        return m_ents.size() - 1;
     }
-    const TokenTree& operator[](unsigned int idx) const { assert(idx < m_subtrees.size()); return m_subtrees[idx]; }
-          TokenTree& operator[](unsigned int idx)       { assert(idx < m_subtrees.size()); return m_subtrees[idx]; }
-    const Token& tok() const { return m_tok; }
-          Token& tok()       { return m_tok; }
-    const Ident::Hygiene& hygiene() const { return m_hygiene; }
+    /// Close a group opened by `start_group`
+    void end_group(size_t group, Ident::Hygiene hygiene) {
+        assert(group < m_ents.size());
+        m_ents[group].hygiene = ::std::move(hygiene);
+        m_ents[group].size = m_ents.size() - group;
+    }
+
+    bool is_token() const {
+        return !m_ents.empty() && m_ents[0].tok.type() != TOK_NULL;
+    }
+    /// Token at the root of the tree (TOK_NULL if this is a group)
+    const Token& tok() const;
+    const Ident::Hygiene& hygiene() const;
+
+    /// Flattened entries, in stream order
+    const ::std::vector<Ent>& ents() const { return m_ents; }
+          ::std::vector<Ent>& ents()       { return m_ents; }
 
     friend ::std::ostream& operator<<(::std::ostream& os, const TokenTree& tt);
 };
@@ -8,43 +8,25 @@
 #include "ttstream.hpp"
 #include <common.hpp>
 
-TTStream::TTStream(const TokenTree& input_tt)
+TTStream::TTStream(const TokenTree& input_tt):
+    m_input_tt(&input_tt),
+    m_pos(0)
 {
     DEBUG("input_tt = [" << input_tt << "]");
-    m_stack.push_back( ::std::make_pair(0, &input_tt) );
 }
 TTStream::~TTStream()
 {
 }
 Token TTStream::realGetToken()
 {
-    while(m_stack.size() > 0)
+    // Group headers are skipped, their contents (including the delimiters) follow them in the flattened tree
+    const auto& ents = m_input_tt->ents();
+    while(m_pos < ents.size())
     {
-        // If current index is above TT size, go up
-        unsigned int& idx = m_stack.back().first;
-        assert( m_stack.back().second );
-        const TokenTree& tree = *m_stack.back().second;
-
-        if(idx == 0 && tree.is_token()) {
-            idx ++;
-            m_hygiene_ptr = &tree.hygiene();
-            return tree.tok();
-        }
-
-        if(idx < tree.size())
-        {
-            const TokenTree&    subtree = tree[idx];
-            idx ++;
-            if( subtree.size() == 0 ) {
-                m_hygiene_ptr = &subtree.hygiene();
-                return subtree.tok().clone();
-            }
-            else {
-                m_stack.push_back( ::std::make_pair(0, &subtree) );
-            }
-        }
-        else {
-            m_stack.pop_back();
+        const auto& ent = ents[m_pos++];
+        if( ent.tok.type() != TOK_NULL ) {
+            m_hygiene_ptr = &ent.hygiene;
+            return ent.tok.clone();
         }
     }
     //m_hygiene = nullptr;
@@ -64,43 +46,23 @@ Ident::Hygiene TTStream::realGetHygiene() const
 
 
 TTStreamO::TTStreamO(TokenTree input_tt):
-    m_input_tt( mv$(input_tt) )
+    m_input_tt( mv$(input_tt) ),
+    m_pos(0)
 {
-    m_stack.push_back( ::std::make_pair(0, nullptr) );
 }
 TTStreamO::~TTStreamO()
 {
 }
 Token TTStreamO::realGetToken()
 {
-    while(m_stack.size() > 0)
+    auto& ents = m_input_tt.ents();
+    while(m_pos < ents.size())
     {
-        // If current index is above TT size, go up
-        unsigned int& idx = m_stack.back().first;
-        TokenTree& tree = (m_stack.back().second ? *m_stack.back().second : m_input_tt);
-
-        if(idx == 0 && tree.is_token()) {
-            idx ++;
-            m_last_pos = tree.tok().get_pos();
-            m_hygiene_ptr = &tree.hygiene();
-            return mv$(tree.tok());
-        }
-
-        if(idx < tree.size())
-        {
-            TokenTree& subtree = tree[idx];
-            idx ++;
-            if( subtree.size() == 0 ) {
-                m_last_pos = subtree.tok().get_pos();
-                m_hygiene_ptr = &subtree.hygiene();
-                return mv$( subtree.tok() );
-            }
-            else {
-                m_stack.push_back( ::std::make_pair(0, &subtree) );
-            }
-        }
-        else {
-            m_stack.pop_back();
+        auto& ent = ents[m_pos++];
+        if( ent.tok.type() != TOK_NULL ) {
+            m_last_pos = ent.tok.get_pos();
+            m_hygiene_ptr = &ent.hygiene;
+            return mv$(ent.tok);
         }
     }
     return Token(TOK_EOF);
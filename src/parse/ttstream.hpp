@@ -14,13 +14,15 @@
 class TTStream:
     public TokenStream
 {
-    ::std::vector< ::std::pair<unsigned int, const TokenTree*> > m_stack;
+    const TokenTree*    m_input_tt;
+    /// Index of the next entry in the flattened tree
+    size_t  m_pos;
     const Ident::Hygiene*   m_hygiene_ptr = nullptr;
 public:
     TTStream(const TokenTree& input_tt);
     ~TTStream();
 
-    TTStream& operator=(const TTStream& x) { m_stack = x.m_stack; return *this; }
+    TTStream& operator=(const TTStream& x) { m_input_tt = x.m_input_tt; m_pos = x.m_pos; return *this; }
 
     Position getPosition() const override;
 
@@ -35,14 +37,14 @@ class TTStreamO:
 {
     Position    m_last_pos;
     TokenTree   m_input_tt;
-    ::std::vector< ::std::pair<unsigned int, TokenTree*> > m_stack;
+    /// Index of the next entry in the flattened tree
+    size_t  m_pos;
     const Ident::Hygiene*   m_hygiene_ptr = nullptr;
 public:
     TTStreamO(TokenTree input_tt);
     TTStreamO(TTStreamO&& x) = default;
     ~TTStreamO();
 
-    TTStreamO& operator=(const TTStreamO& x) { m_stack = x.m_stack; return *this; }
     TTStreamO& operator=(TTStreamO&& x) = default;
 
     Position getPosition() const override;
@@ -282,19 +282,13 @@ namespace
             switch(mode)
             {
             case LookupMode::Namespace:
-                {
-                    auto v = mod.m_namespace_items.find(name);
-                    if( v != mod.m_namespace_items.end() ) {
-                        path = ::AST::Path( v->second.path );
-                        return true;
-                    }
+                if( auto v = mod.find_index_ent(::AST::Module::IndexName::Namespace, name) ) {
+                    path = ::AST::Path( v->path );
+                    return true;
                 }
-                {
-                    auto v = mod.m_type_items.find(name);
-                    if( v != mod.m_type_items.end() ) {
-                        path = ::AST::Path( v->second.path );
-                        return true;
-                    }
+                if( auto v = mod.find_index_ent(::AST::Module::IndexName::Type, name) ) {
+                    path = ::AST::Path( v->path );
+                    return true;
                 }
                 break;
 
@@ -305,54 +299,42 @@ namespace
                 //        DEBUG("- " << v.first << " = " << (v.second.is_pub ? "pub " : "") << v.second.path);
                 //    }
                 //}
-                {
-                    auto v = mod.m_type_items.find(name);
-                    if( v != mod.m_type_items.end() ) {
-                        path = ::AST::Path( v->second.path );
-                        return true;
-                    }
+                if( auto v = mod.find_index_ent(::AST::Module::IndexName::Type, name) ) {
+                    path = ::AST::Path( v->path );
+                    return true;
                 }
                 break;
             case LookupMode::Pattern:
-                {
-                    auto v = mod.m_type_items.find(name);
-                    if( v != mod.m_type_items.end() ) {
-                        const auto& b = v->second.path.binding();
-                        switch( b.tag() )
-                        {
-                        case ::AST::PathBinding::TAG_Struct:
-                            path = ::AST::Path( v->second.path );
-                            return true;
-                        default:
-                            break;
-                        }
+                if( auto v = mod.find_index_ent(::AST::Module::IndexName::Type, name) ) {
+                    const auto& b = v->path.binding();
+                    switch( b.tag() )
+                    {
+                    case ::AST::PathBinding::TAG_Struct:
+                        path = ::AST::Path( v->path );
+                        return true;
+                    default:
+                        break;
                     }
                 }
             case LookupMode::PatternValue:
-                {
-                    auto v = mod.m_value_items.find(name);
-                    if( v != mod.m_value_items.end() ) {
-                        const auto& b = v->second.path.binding();
-                        switch( b.tag() )
-                        {
-                        case ::AST::PathBinding::TAG_EnumVar:
-                        case ::AST::PathBinding::TAG_Static:
-                            path = ::AST::Path( v->second.path );
-                            return true;
-                        default:
-                            break;
-                        }
+                if( auto v = mod.find_index_ent(::AST::Module::IndexName::Value, name) ) {
+                    const auto& b = v->path.binding();
+                    switch( b.tag() )
+                    {
+                    case ::AST::PathBinding::TAG_EnumVar:
+                    case ::AST::PathBinding::TAG_Static:
+                        path = ::AST::Path( v->path );
+                        return true;
+                    default:
+                        break;
                     }
                 }
                 break;
             case LookupMode::Constant:
             case LookupMode::Variable:
-                {
-                    auto v = mod.m_value_items.find(name);
-                    if( v != mod.m_value_items.end() ) {
-                        path = ::AST::Path( v->second.path );
-                        return true;
-                    }
+                if( auto v = mod.find_index_ent(::AST::Module::IndexName::Value, name) ) {
+                    path = ::AST::Path( v->path );
+                    return true;
                 }
                 break;
             }
@@ -1071,19 +1053,18 @@ void Resolve_Absolute_Path_BindAbsolute(Context& context, const Span& sp, Contex
         }
         else
         {
-            auto it = mod->m_namespace_items.find( n.name() );
-            if( it == mod->m_namespace_items.end() ) {
+            auto name_ref = mod->find_index_ent(::AST::Module::IndexName::Namespace, n.name());
+            if( !name_ref ) {
                 ERROR(sp, E0000, "Couldn't find path component '" << n.name() << "' of " << path);
             }
-            const auto& name_ref = it->second;
-            DEBUG("#" << i << " \"" << n.name() << "\" = " << name_ref.path << (name_ref.is_import ? " (import)" : "") );
+            DEBUG("#" << i << " \"" << n.name() << "\" = " << name_ref->path << (name_ref.is_import ? " (import)" : "") );
 
-            TU_MATCH_DEF(::AST::PathBinding, (name_ref.path.binding()), (e),
+            TU_MATCH_DEF(::AST::PathBinding, (name_ref->path.binding()), (e),
             (
-                ERROR(sp, E0000, "Encountered non-namespace item '" << n.name() << "' ("<<name_ref.path<<") in path " << path);
+                ERROR(sp, E0000, "Encountered non-namespace item '" << n.name() << "' ("<<name_ref->path<<") in path " << path);
                 ),
             (TypeAlias,
-                path = split_replace_into_ufcs_path(sp, mv$(path), i,  name_ref.path);
+                path = split_replace_into_ufcs_path(sp, mv$(path), i,  name_ref->path);
                 return Resolve_Absolute_Path_BindUFCS(context, sp, mode,  path);
                 ),
             (Crate,
@@ -1092,7 +1073,7 @@ void Resolve_Absolute_Path_BindAbsolute(Context& context, const Span& sp, Contex
                 ),
             (Trait,
                 assert( e.trait_ || e.hir );
-                auto trait_path = ::AST::Path(name_ref.path);
+                auto trait_path = ::AST::Path(name_ref->path);
                 // HACK! If this was an import, recurse on it to fix paths. (Ideally, all index entries should have the canonical path, but don't currently)
                 if( name_ref.is_import ) {
                     auto lm = Context::LookupMode::Type;
@@ -1160,7 +1141,7 @@ void Resolve_Absolute_Path_BindAbsolute(Context& context, const Span& sp, Contex
                 ),
             (Enum,
                 if( name_ref.is_import ) {
-                    auto newpath = name_ref.path;
+                    auto newpath = name_ref->path;
                     for(unsigned int j = i+1; j < path_abs.nodes.size(); j ++)
                     {
                         newpath.nodes().push_back( mv$(path_abs.nodes[j]) );
@@ -1189,22 +1170,22 @@ void Resolve_Absolute_Path_BindAbsolute(Context& context, const Span& sp, Contex
                         }
                     }
 
-                    path = split_replace_into_ufcs_path(sp, mv$(path), i,  name_ref.path);
+                    path = split_replace_into_ufcs_path(sp, mv$(path), i,  name_ref->path);
                     return Resolve_Absolute_Path_BindUFCS(context, sp, mode,  path);
                 }
                 ),
             (Struct,
-                path = split_replace_into_ufcs_path(sp, mv$(path), i,  name_ref.path);
+                path = split_replace_into_ufcs_path(sp, mv$(path), i,  name_ref->path);
                 return Resolve_Absolute_Path_BindUFCS(context, sp, mode,  path);
                 ),
             (Union,
-                path = split_replace_into_ufcs_path(sp, mv$(path), i,  name_ref.path);
+                path = split_replace_into_ufcs_path(sp, mv$(path), i,  name_ref->path);
                 return Resolve_Absolute_Path_BindUFCS(context, sp, mode,  path);
                 ),
             (Module,
                 if( name_ref.is_import ) {
-                    //TODO(sp, "Replace path component with new path - " << path << "[.."<<i+1<<"] with " << name_ref.path);
-                    auto newpath = name_ref.path;
+                    //TODO(sp, "Replace path component with new path - " << path << "[.."<<i+1<<"] with " << name_ref->path);
+                    auto newpath = name_ref->path;
                     for(unsigned int j = i+1; j < path_abs.nodes.size(); j ++)
                     {
                         newpath.nodes().push_back( mv$(path_abs.nodes[j]) );
@@ -1308,11 +1289,11 @@ void Resolve_Absolute_Path(/*const*/ Context& context, const Span& sp, Context::
                         switch( e.nodes.size() == 2 ? mode : Context::LookupMode::Namespace )
                         {
                         case Context::LookupMode::Namespace:
-                            if( mod.m_namespace_items.find(name) != mod.m_namespace_items.end() ) {
+                            if( mod.find_index_ent(::AST::Module::IndexName::Namespace, name) ) {
                                 found = true;
                             }
                         case Context::LookupMode::Type:
-                            if( mod.m_namespace_items.find(name) != mod.m_namespace_items.end() ) {
+                            if( mod.find_index_ent(::AST::Module::IndexName::Namespace, name) ) {
                                 found = true;
                             }
                             break;
@@ -1321,7 +1302,7 @@ void Resolve_Absolute_Path(/*const*/ Context& context, const Span& sp, Context::
                             TODO(sp, "Check " << p << " for an item named " << name << " (Pattern)");
                         case Context::LookupMode::Constant:
                         case Context::LookupMode::Variable:
-                            if( mod.m_value_items.find(name) != mod.m_value_items.end() ) {
+                            if( mod.find_index_ent(::AST::Module::IndexName::Value, name) ) {
                                 found = true;
                             }
                             break;
@@ -2201,8 +2182,41 @@ void Resolve_Absolute_Mod( Context item_context, ::AST::Module& mod )
     }
 }
 
+// Fix up the paths in the glob indexes shared between modules (each is only visited once)
+void Resolve_Absolute_GlobIndexes(Context& context, const ::AST::Module& mod, ::std::set<const ::AST::Module::GlobIndex*>& visited)
+{
+    static Span sp;
+    for(const auto& gi : mod.m_glob_imports)
+    {
+        if( gi.index && visited.insert(gi.index.get()).second )
+        {
+            for(auto& i : gi.index->namespace_items)
+                Resolve_Absolute_Path(context, sp, Context::LookupMode::Namespace, i.second.path);
+            for(auto& i : gi.index->type_items)
+                Resolve_Absolute_Path(context, sp, Context::LookupMode::Type, i.second.path);
+            for(auto& i : gi.index->value_items)
+                Resolve_Absolute_Path(context, sp, Context::LookupMode::Constant, i.second.path);
+        }
+    }
+    for(const auto& i : mod.items())
+    {
+        if( const auto* e = i.data.opt_Module() )
+            Resolve_Absolute_GlobIndexes(context, *e, visited);
+    }
+    for(const auto& mp : mod.anon_mods())
+    {
+        if( mp )
+            Resolve_Absolute_GlobIndexes(context, *mp, visited);
+    }
+}
+
 void Resolve_Absolutise(AST::Crate& crate)
 {
+    {
+        Context context { crate, crate.root_module() };
+        ::std::set<const ::AST::Module::GlobIndex*>   visited;
+        Resolve_Absolute_GlobIndexes(context, crate.root_module(), visited);
+    }
     Resolve_Absolute_Mod(crate, crate.root_module());
 }
 
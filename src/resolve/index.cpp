@@ -6,14 +6,7 @@
 #include <main_bindings.hpp>
 #include <hir/hir.hpp>
 
-enum class IndexName
-{
-    Namespace,
-    Type,
-    Value,
-};
-
-void Resolve_Index_Module_Wildcard__use_stmt(AST::Crate& crate, AST::Module& dst_mod, const AST::UseStmt& i_data, bool is_pub);
+typedef ::AST::Module::IndexName IndexName;
 
 ::std::ostream& operator<<(::std::ostream& os, const IndexName& loc)
 {
@@ -28,19 +21,6 @@ void Resolve_Index_Module_Wildcard__use_stmt(AST::Crate& crate, AST::Module& dst
     }
     throw "";
 }
-::std::unordered_map< ::std::string, ::AST::Module::IndexEnt >& get_mod_index(::AST::Module& mod, IndexName location) {
-    switch(location)
-    {
-    case IndexName::Namespace:
-        return mod.m_namespace_items;
-    case IndexName::Type:
-        return mod.m_type_items;
-    case IndexName::Value:
-        return mod.m_value_items;
-    }
-    throw "";
-}
-
 namespace {
     AST::Path hir_to_ast(const HIR::SimplePath& p) {
         // The crate name here has to be non-empty, because it's external.
@@ -55,7 +35,7 @@ namespace {
 
 void _add_item(const Span& sp, AST::Module& mod, IndexName location, const ::std::string& name, bool is_pub, ::AST::Path ir, bool error_on_collision=true)
 {
-    auto& list = get_mod_index(mod, location);
+    auto& list = mod.get_index(location);
 
     bool was_import = (ir != mod.path() + name);
     if( list.count(name) > 0 )
@@ -95,6 +75,47 @@ void _add_item_value(const Span& sp, AST::Module& mod, const ::std::string& name
     _add_item(sp, mod, IndexName::Value, name, is_pub, mv$(ir), error_on_collision);
 }
 
+// Glob indexes only ever hold public items, the publicity of the import is stored by the importing module
+void _add_glob_item(::AST::Module::GlobIndex& idx, IndexName location, const ::std::string& name, ::AST::Path ir)
+{
+    auto& list = idx.get(location);
+    if( list.count(name) == 0 )
+    {
+        DEBUG("### Glob " << location << " item " << name << " = " << ir);
+        list.insert(::std::make_pair(name, ::AST::Module::IndexEnt { true, true, mv$(ir) } ));
+    }
+}
+void _add_glob_item_type(::AST::Module::GlobIndex& idx, const ::std::string& name, ::AST::Path ir)
+{
+    _add_glob_item(idx, IndexName::Namespace, name, ::AST::Path(ir));
+    _add_glob_item(idx, IndexName::Type, name, mv$(ir));
+}
+void _add_glob_item_value(::AST::Module::GlobIndex& idx, const ::std::string& name, ::AST::Path ir)
+{
+    _add_glob_item(idx, IndexName::Value, name, mv$(ir));
+}
+
+namespace {
+    // Glob indexes for enums and HIR modules, keyed by the source item (and the path used to import it)
+    ::std::unordered_map< const void*, ::std::vector< ::std::pair< ::AST::Path, ::std::shared_ptr< ::AST::Module::GlobIndex> > > >   s_glob_indexes;
+
+    /// Obtain the shared glob index for the given source, returns `true` if it was newly created (and needs populating)
+    bool get_glob_index(const void* src, const ::AST::Path& path, ::std::shared_ptr< ::AST::Module::GlobIndex>& out)
+    {
+        auto& ents = s_glob_indexes[src];
+        for(const auto& e : ents)
+        {
+            if( e.first == path ) {
+                out = e.second;
+                return false;
+            }
+        }
+        out = ::std::make_shared< ::AST::Module::GlobIndex>();
+        ents.push_back( ::std::make_pair(path, out) );
+        return true;
+    }
+}
+
 void Resolve_Index_Module_Base(const AST::Crate& crate, AST::Module& mod)
 {
     TRACE_FUNCTION_F("mod = " << mod.path());
@@ -166,7 +187,6 @@ void Resolve_Index_Module_Base(const AST::Crate& crate, AST::Module& mod)
         )
     }
 
-    bool has_pub_wildcard = false;
     // Named imports
     for( const auto& i : mod.items() )
     {
@@ -247,17 +267,8 @@ void Resolve_Index_Module_Base(const AST::Crate& crate, AST::Module& mod)
                 H::handle_pb(sp, mod, i, i_data.alt_binding, true);
             }
         }
-        else
-        {
-            if( i.is_pub )
-            {
-                has_pub_wildcard = true;
-            }
-        }
     }
 
-    mod.m_index_populated = (has_pub_wildcard ? 1 : 2);
-
     // Handle child modules
     for( auto& i : mod.items() )
     {
@@ -277,7 +288,7 @@ void Resolve_Index_Module_Base(const AST::Crate& crate, AST::Module& mod)
     }
 }
 
-void Resolve_Index_Module_Wildcard__glob_in_hir_mod(const Span& sp, const AST::Crate& crate, AST::Module& dst_mod,  const ::HIR::Module& hmod, const ::AST::Path& path, bool is_pub)
+void Resolve_Index_Module_Wildcard__glob_in_hir_mod(const Span& sp, const AST::Crate& crate, ::AST::Module::GlobIndex& dst_idx,  const ::HIR::Module& hmod, const ::AST::Path& path)
 {
     for(const auto& it : hmod.m_mod_items) {
         const auto& ve = *it.second;
@@ -312,7 +323,7 @@ void Resolve_Index_Module_Wildcard__glob_in_hir_mod(const Span& sp, const AST::C
                 p.bind( ::AST::PathBinding::make_TypeAlias({nullptr}) );
                 )
             )
-            _add_item_type( sp, dst_mod, it.first, is_pub, mv$(p), false );
+            _add_glob_item_type( dst_idx, it.first, mv$(p) );
         }
     }
     for(const auto& it : hmod.m_value_items) {
@@ -368,58 +379,22 @@ void Resolve_Index_Module_Wildcard__glob_in_hir_mod(const Span& sp, const AST::C
                     )
                 )
             }
-            _add_item_value( sp, dst_mod, it.first, is_pub, mv$(p), false );
+            _add_glob_item_value( dst_idx, it.first, mv$(p) );
         }
     }
 }
 
-void Resolve_Index_Module_Wildcard__submod(AST::Crate& crate, AST::Module& dst_mod, const AST::Module& src_mod, bool import_as_pub)
-{
-    static Span sp;
-    TRACE_FUNCTION_F(src_mod.path());
-    static ::std::set<const AST::Module*>   stack;
-    if( ! stack.insert( &src_mod ).second )
-    {
-        DEBUG("- Avoided recursion");
-        return ;
-    }
-
-    // TODO: Publicity of the source item shouldn't matter.
-    // - Publicity should be a path, not a boolean.
-    for(const auto& vi : src_mod.m_namespace_items) {
-        _add_item( sp, dst_mod, IndexName::Namespace, vi.first, vi.second.is_pub && import_as_pub, vi.second.path, false );
-    }
-    for(const auto& vi : src_mod.m_type_items) {
-        _add_item( sp, dst_mod, IndexName::Type     , vi.first, vi.second.is_pub && import_as_pub, vi.second.path, false );
-    }
-    for(const auto& vi : src_mod.m_value_items) {
-        _add_item( sp, dst_mod, IndexName::Value    , vi.first, vi.second.is_pub && import_as_pub, vi.second.path, false );
-    }
-
-    if( src_mod.m_index_populated != 2 )
-    {
-        for( const auto& i : src_mod.items() )
-        {
-            if( ! i.data.is_Use() )
-                continue ;
-            if( i.name != "" )
-                continue ;
-            Resolve_Index_Module_Wildcard__use_stmt(crate, dst_mod, i.data.as_Use(), import_as_pub);
-        }
-    }
-
-    stack.erase(&src_mod);
-}
-
 void Resolve_Index_Module_Wildcard__use_stmt(AST::Crate& crate, AST::Module& dst_mod, const AST::UseStmt& i_data, bool is_pub)
 {
     const auto& sp = i_data.sp;
     const auto& b = i_data.path.binding();
 
+    ::std::shared_ptr< ::AST::Module::GlobIndex>    idx;
     TU_IFLET(::AST::PathBinding, b, Crate, e,
         DEBUG("Glob crate " << i_data.path);
         const auto& hmod = e.crate_->m_hir->m_root_module;
-        Resolve_Index_Module_Wildcard__glob_in_hir_mod(sp, crate, dst_mod, hmod, i_data.path, is_pub);
+        if( get_glob_index(&hmod, i_data.path, idx) )
+            Resolve_Index_Module_Wildcard__glob_in_hir_mod(sp, crate, *idx, hmod, i_data.path);
     )
     else TU_IFLET(::AST::PathBinding, b, Module, e,
         DEBUG("Glob mod " << i_data.path);
@@ -427,11 +402,14 @@ void Resolve_Index_Module_Wildcard__use_stmt(AST::Crate& crate, AST::Module& dst
         {
             ASSERT_BUG(sp, e.hir, "Glob import where HIR module pointer not set - " << i_data.path);
             const auto& hmod = *e.hir;
-            Resolve_Index_Module_Wildcard__glob_in_hir_mod(sp, crate, dst_mod, hmod, i_data.path, is_pub);
+            if( get_glob_index(&hmod, i_data.path, idx) )
+                Resolve_Index_Module_Wildcard__glob_in_hir_mod(sp, crate, *idx, hmod, i_data.path);
         }
         else
         {
-            Resolve_Index_Module_Wildcard__submod(crate, dst_mod, *e.module_, is_pub);
+            // Local modules are consulted directly (their index can still be gaining glob imports)
+            dst_mod.m_glob_imports.push_back(::AST::Module::GlobImport { is_pub, nullptr, e.module_ });
+            return ;
         }
     )
     else TU_IFLET(::AST::PathBinding, b, Enum, e,
@@ -439,37 +417,43 @@ void Resolve_Index_Module_Wildcard__use_stmt(AST::Crate& crate, AST::Module& dst
         if( e.enum_ )
         {
             DEBUG("Glob enum " << i_data.path << " (AST)");
-            unsigned int idx = 0;
-            for( const auto& ev : e.enum_->variants() ) {
-                ::AST::Path p = i_data.path + ev.m_name;
-                p.bind( ::AST::PathBinding::make_EnumVar({e.enum_, idx}) );
-                if( ev.m_data.is_Struct() ) {
-                    _add_item_type ( sp, dst_mod, ev.m_name, is_pub, mv$(p), false );
-                }
-                else {
-                    _add_item_value( sp, dst_mod, ev.m_name, is_pub, mv$(p), false );
-                }
+            if( get_glob_index(e.enum_, i_data.path, idx) )
+            {
+                unsigned int idx_v = 0;
+                for( const auto& ev : e.enum_->variants() ) {
+                    ::AST::Path p = i_data.path + ev.m_name;
+                    p.bind( ::AST::PathBinding::make_EnumVar({e.enum_, idx_v}) );
+                    if( ev.m_data.is_Struct() ) {
+                        _add_glob_item_type ( *idx, ev.m_name, mv$(p) );
+                    }
+                    else {
+                        _add_glob_item_value( *idx, ev.m_name, mv$(p) );
+                    }
 
-                idx += 1;
+                    idx_v += 1;
+                }
             }
         }
         else
         {
             DEBUG("Glob enum " << i_data.path << " (HIR)");
-            unsigned int idx = 0;
-            for( const auto& ev : e.hir->m_variants )
+            if( get_glob_index(e.hir, i_data.path, idx) )
             {
-                ::AST::Path p = i_data.path + ev.first;
-                p.bind( ::AST::PathBinding::make_EnumVar({nullptr, idx, e.hir}) );
+                unsigned int idx_v = 0;
+                for( const auto& ev : e.hir->m_variants )
+                {
+                    ::AST::Path p = i_data.path + ev.first;
+                    p.bind( ::AST::PathBinding::make_EnumVar({nullptr, idx_v, e.hir}) );
 
-                if( ev.second.is_Struct() ) {
-                    _add_item_type ( sp, dst_mod, ev.first, is_pub, mv$(p), false );
-                }
-                else {
-                    _add_item_value( sp, dst_mod, ev.first, is_pub, mv$(p), false );
-                }
+                    if( ev.second.is_Struct() ) {
+                        _add_glob_item_type ( *idx, ev.first, mv$(p) );
+                    }
+                    else {
+                        _add_glob_item_value( *idx, ev.first, mv$(p) );
+                    }
 
-                idx += 1;
+                    idx_v += 1;
+                }
             }
         }
     )
@@ -477,16 +461,16 @@ void Resolve_Index_Module_Wildcard__use_stmt(AST::Crate& crate, AST::Module& dst
     {
         BUG(sp, "Invalid path binding for glob import: " << b.tag_str() << " - "<<i_data.path);
     }
+    dst_mod.m_glob_imports.push_back(::AST::Module::GlobImport { is_pub, mv$(idx), nullptr });
 }
 
 // Wildcard (aka glob) import resolution
 //
 // Strategy:
-// - HIR just imports the items
-// - Enums import all variants
-// - AST modules: (See Resolve_Index_Module_Wildcard__submod)
-//  - Clone index in (marked as publicity and weak)
-//  - Recurse into globs
+// - Nothing is copied into the importing module, instead a reference to the source is added to `m_glob_imports`
+//  - Lookups fall through to these (in order) if the name isn't in the module's own index
+// - HIR modules and Enums: A shared index of public items/variants is built on first import
+// - AST modules: The module itself is referenced (so its own globs are also visible)
 void Resolve_Index_Module_Wildcard(AST::Crate& crate, AST::Module& mod)
 {
     TRACE_FUNCTION_F("mod = " << mod.path());
@@ -499,9 +483,6 @@ void Resolve_Index_Module_Wildcard(AST::Crate& crate, AST::Module& mod)
         Resolve_Index_Module_Wildcard__use_stmt(crate, mod, i.data.as_Use(), i.is_pub);
     }
 
-    // Mark this as having all the items it ever will.
-    mod.m_index_populated = 2;
-
     // Handle child modules
     for( auto& i : mod.items() )
     {
@@ -617,12 +598,12 @@ bool Resolve_Index_Module_Normalise_Path(const ::AST::Crate& crate, const Span&
     {
         const auto& node = info.nodes[i];
 
-        auto it = mod->m_namespace_items.find( node.name() );
-        if( it == mod->m_namespace_items.end() )
+        auto ie_r = mod->find_index_ent(IndexName::Namespace, node.name());
+        if( !ie_r )
             ERROR(sp, E0000,  "Couldn't find node " << i << " of path " << path);
-        const auto& ie = it->second;
+        const auto& ie = *ie_r.ent;
 
-        if( ie.is_import ) {
+        if( ie_r.is_import ) {
             // Need to replace all nodes up to and including the current with the import path
             auto new_path = ie.path;
             for(unsigned int j = i+1; j < info.nodes.size(); j ++)
@@ -654,31 +635,12 @@ bool Resolve_Index_Module_Normalise_Path(const ::AST::Crate& crate, const Span&
     const auto& node = info.nodes.back();
 
 
-    // TODO: Use get_mod_index instead.
-    const ::AST::Module::IndexEnt* ie_p = nullptr;
-    switch(loc)
-    {
-    case IndexName::Namespace: {
-        auto it = mod->m_namespace_items.find( node.name() );
-        if( it != mod->m_namespace_items.end() )
-            ie_p = &it->second;
-        } break;
-    case IndexName::Value: {
-        auto it = mod->m_value_items.find( node.name() );
-        if( it != mod->m_value_items.end() )
-            ie_p = &it->second;
-        } break;
-    case IndexName::Type: {
-        auto it = mod->m_type_items.find( node.name() );
-        if( it != mod->m_type_items.end() )
-            ie_p = &it->second;
-        } break;
-    }
-    if( !ie_p )
+    auto ie_r = mod->find_index_ent(loc, node.name());
+    if( !ie_r )
         ERROR(sp, E0000,  "Couldn't find final node of path " << path);
-    const auto& ie = *ie_p;
+    const auto& ie = *ie_r.ent;
 
-    if( ie.is_import ) {
+    if( ie_r.is_import ) {
         // TODO: Prevent infinite recursion if the user does something dumb
         path = ::AST::Path(ie.path);
         Resolve_Index_Module_Normalise_Path(crate, sp, path, loc);
@@ -723,4 +685,19 @@ void Resolve_Index(AST::Crate& crate)
 
     // - Normalise the index (ensuring all paths point directly to the item)
     Resolve_Index_Module_Normalise(crate, Span(), crate.m_root_module);
+    // - Normalise the shared glob indexes (once each)
+    for(auto& src_ents : s_glob_indexes)
+    {
+        for(auto& e : src_ents.second)
+        {
+            DEBUG("Glob index for " << e.first);
+            for(auto& ent : e.second->namespace_items)
+                Resolve_Index_Module_Normalise_Path(crate, Span(), ent.second.path, IndexName::Namespace);
+            for(auto& ent : e.second->type_items)
+                Resolve_Index_Module_Normalise_Path(crate, Span(), ent.second.path, IndexName::Type);
+            for(auto& ent : e.second->value_items)
+                Resolve_Index_Module_Normalise_Path(crate, Span(), ent.second.path, IndexName::Value);
+        }
+    }
+    s_glob_indexes.clear();
 }
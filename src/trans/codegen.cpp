@@ -18,7 +18,35 @@
 void Trans_Codegen(const ::std::string& outfile, const TransOptions& opt, const ::HIR::Crate& crate, const TransList& list, bool is_executable)
 {
     static Span sp;
-    auto codegen = Trans_Codegen_GetGeneratorC(crate, outfile);
+    auto codegen = Trans_Codegen_GetGeneratorC(crate, outfile, opt);
+
+    const bool whole_program = is_executable && opt.whole_program;
+    auto is_mir_only_item = [&](const ::HIR::Path& path)->bool {
+        if( !path.m_data.is_Generic() )
+            return false;
+        auto it = crate.m_ext_crates.find( path.m_data.as_Generic().m_path.m_crate_name );
+        return it != crate.m_ext_crates.end() && it->second.m_data->m_is_mir_only;
+        };
+    // Functions from other crates (with MIR) are emitted as local copies, as the library has its own definition
+    // - Except for functions exported by name, other code refers to them by that name.
+    //   > MIR-only libraries: This is the only definition (only emitted in the executable)
+    //   > Whole-program executables: The copy is weak, the definition in the library's object is used if there is one
+    auto is_extern_def = [&](const ::HIR::Path& path, const ::HIR::Function& fcn)->bool {
+        if( fcn.m_code.has_body() )
+            return false;
+        if( fcn.m_linkage.name != "" && (whole_program || is_mir_only_item(path)) )
+            return false;
+        return true;
+        };
+    auto is_weak_def = [&](const ::HIR::Path& path, const ::HIR::Function& fcn)->bool {
+        return whole_program && !fcn.m_code.has_body() && fcn.m_linkage.name != "" && !is_mir_only_item(path);
+        };
+    // Statics from MIR-only libraries (which have their values) are only defined by the executable
+    auto is_static_defined = [&](const ::HIR::Path& path, const ::HIR::Static& stat)->bool {
+        if( stat.m_value_res.is_Invalid() )
+            return false;
+        return is_executable || !is_mir_only_item(path);
+        };
 
     // 1. Emit structure/type definitions.
     // - Emit in the order they're needed.
@@ -48,13 +76,14 @@ void Trans_Codegen(const ::std::string& outfile, const TransOptions& opt, const
             codegen->emit_type(ty.first);
         }
     }
-    for(const auto& ty : list.m_typeids)
+    for(const auto* ty : TransList::sorted(list.m_typeids))
     {
-        codegen->emit_type_id(ty);
+        codegen->emit_type_id(*ty);
     }
     // Emit required constructor methods (and other wrappers)
-    for(const auto& path : list.m_constructors)
+    for(const auto* path_p : TransList::sorted(list.m_constructors))
     {
+        const auto& path = *path_p;
         // Get the item type
         // - Function (must be an intrinsic)
         // - Struct (must be a tuple struct)
@@ -83,19 +112,21 @@ void Trans_Codegen(const ::std::string& outfile, const TransOptions& opt, const
     }
 
     // 2. Emit function prototypes
-    for(const auto& ent : list.m_functions)
+    const auto functions = TransList::sorted(list.m_functions);
+    for(const auto* ent_p : functions)
     {
+        const auto& ent = *ent_p;
         DEBUG("FUNCTION " << ent.first);
         assert( ent.second->ptr );
         const auto& fcn = *ent.second->ptr;
-        bool is_extern = ! static_cast<bool>(fcn.m_code);
-        if( fcn.m_code.m_mir ) {
-            codegen->emit_function_proto(ent.first, fcn, ent.second->pp, is_extern);
+        bool is_extern = is_extern_def(ent.first, fcn);
+        if( ent.second->emit_code ) {
+            codegen->emit_function_proto(ent.first, fcn, ent.second->pp, is_extern, is_weak_def(ent.first, fcn));
         }
         else {
             // TODO: Why would an intrinsic be in the queue?
             // - If it's exported it does.
-            if( fcn.m_abi == "rust-intrinsic" ) {
+            if( fcn.m_abi == "rust-intrinsic" || fcn.m_abi == "platform-intrinsic" ) {
             }
             else {
                 codegen->emit_function_ext(ent.first, fcn, ent.second->pp);
@@ -103,8 +134,9 @@ void Trans_Codegen(const ::std::string& outfile, const TransOptions& opt, const
         }
     }
     // VTables (may be needed by statics)
-    for(const auto& ent : list.m_vtables)
+    for(const auto* ent_p : TransList::sorted(list.m_vtables))
     {
+        const auto& ent = *ent_p;
         const auto& trait = ent.first.m_data.as_UfcsKnown().trait;
         const auto& type = *ent.first.m_data.as_UfcsKnown().type;
         DEBUG("VTABLE " << trait << " for " << type);
@@ -112,13 +144,15 @@ void Trans_Codegen(const ::std::string& outfile, const TransOptions& opt, const
         codegen->emit_vtable(ent.first, crate.get_trait_by_path(Span(), trait.m_path));
     }
     // 3. Emit statics
-    for(const auto& ent : list.m_statics)
+    const auto statics = TransList::sorted(list.m_statics);
+    for(const auto* ent_p : statics)
     {
+        const auto& ent = *ent_p;
         DEBUG("STATIC proto " << ent.first);
         assert(ent.second->ptr);
         const auto& stat = *ent.second->ptr;
 
-        if( ! stat.m_value_res.is_Invalid() )
+        if( is_static_defined(ent.first, stat) )
         {
             codegen->emit_static_proto(ent.first, stat, ent.second->pp);
         }
@@ -127,13 +161,14 @@ void Trans_Codegen(const ::std::string& outfile, const TransOptions& opt, const
             codegen->emit_static_ext(ent.first, stat, ent.second->pp);
         }
     }
-    for(const auto& ent : list.m_statics)
+    for(const auto* ent_p : statics)
     {
+        const auto& ent = *ent_p;
         DEBUG("STATIC " << ent.first);
         assert(ent.second->ptr);
         const auto& stat = *ent.second->ptr;
 
-        if( ! stat.m_value_res.is_Invalid() )
+        if( is_static_defined(ent.first, stat) )
         {
             codegen->emit_static_local(ent.first, stat, ent.second->pp);
         }
@@ -141,16 +176,18 @@ void Trans_Codegen(const ::std::string& outfile, const TransOptions& opt, const
 
 
     // 4. Emit function code
-    for(const auto& ent : list.m_functions)
+    for(const auto* ent_p : functions)
     {
-        if( ent.second->ptr && ent.second->ptr->m_code.m_mir )
+        const auto& ent = *ent_p;
+        if( ent.second->emit_code )
         {
             const auto& path = ent.first;
             const auto& fcn = *ent.second->ptr;
             const auto& pp = ent.second->pp;
             TRACE_FUNCTION_F(path);
             DEBUG("FUNCTION CODE " << path);
-            bool is_extern = ! static_cast<bool>(fcn.m_code);
+            bool is_extern = is_extern_def(path, fcn);
+            bool is_weak = is_weak_def(path, fcn);
             // If this is a provided trait method, it needs to be monomorphised too.
             bool is_method = ( fcn.m_args.size() > 0 && visit_ty_with(fcn.m_args[0].second, [&](const auto& x){return x == ::HIR::TypeRef("Self",0xFFFF);}) );
             if( pp.has_types() || is_method )
@@ -169,12 +206,12 @@ void Trans_Codegen(const ::std::string& outfile, const TransOptions& opt, const
                 MIR_Validate(resolve, ip, *mir, args, ret_type);
                 // TODO: Flag that this should be a weak (or weak-er) symbol?
                 // - If it's from an external crate, it should be weak
-                codegen->emit_function_code(path, fcn, ent.second->pp, is_extern,  mir);
+                codegen->emit_function_code(path, fcn, ent.second->pp, is_extern, is_weak, mir);
             }
             // TODO: Detect if the function was a #[inline] function from another crate, and don't emit if that is the case?
             // - Emiting is nice, but it should be emitted as a weak symbol
             else {
-                codegen->emit_function_code(path, fcn, pp, is_extern,  fcn.m_code.m_mir);
+                codegen->emit_function_code(path, fcn, pp, is_extern, is_weak, fcn.m_code.m_mir);
             }
         }
     }
@@ -10,6 +10,7 @@
 #include <fstream>
 #include <algorithm>
 #include <cmath>
+#include <list>
 #include <hir/hir.hpp>
 #include <mir/mir.hpp>
 #include <hir_typeck/static.hpp>
@@ -130,13 +131,21 @@ namespace {
         struct {
             bool emulated_i128 = false;
             bool disallow_empty_structs = false;
+            /// Don't emit comments (MIR statements, type names, item paths)
+            bool compact = false;
         } m_options;
 
-        ::std::map<::HIR::GenericPath, ::std::vector<unsigned>> m_enum_repr_cache;
-
         ::std::vector< ::std::pair< ::HIR::GenericPath, const ::HIR::Struct*> >   m_box_glue_todo;
+
+        // Caches of the mangled names and C type names (the same paths and types are emitted many times)
+        ::std::unordered_map< ::HIR::Path, ::std::string, Trans_KeyHash, Trans_KeyEq>  m_mangled_paths;
+        ::std::unordered_map< ::HIR::GenericPath, ::std::string, Trans_KeyHash, Trans_KeyEq>   m_mangled_gpaths;
+        ::std::unordered_map< ::HIR::TypeRef, ::std::string, Trans_KeyHash, Trans_KeyEq>   m_mangled_types;
+        ::std::unordered_map< ::HIR::TypeRef, ::std::string, Trans_KeyHash, Trans_KeyEq>   m_ctype_cache;
+        /// Called paths that are cold (`#[cold]` or diverging), filled by `MIR_Helper_GetColdBlocks`
+        ::std::unordered_map< ::HIR::Path, bool, Trans_KeyHash, Trans_KeyEq>  m_cold_callees;
     public:
-        CodeGenerator_C(const ::HIR::Crate& crate, const ::std::string& outfile):
+        CodeGenerator_C(const ::HIR::Crate& crate, const ::std::string& outfile, const TransOptions& opt):
             m_crate(crate),
             m_resolve(crate),
             m_outfile_path(outfile),
@@ -155,6 +164,7 @@ namespace {
                 m_options.disallow_empty_structs = true;
                 break;
             }
+            m_options.compact = opt.compact_c;
 
             m_of
                 << "/*\n"
@@ -173,6 +183,10 @@ namespace {
                 m_of
                     << "#include <stdatomic.h>\n"   // atomic_*
                     ;
+                if( Target_GetCurSpec().m_arch.m_name == "x86" || Target_GetCurSpec().m_arch.m_name == "x86_64" )
+                {
+                    m_of << "#include <immintrin.h>\n";    // _mm_* (`x86_*` platform intrinsics)
+                }
                 break;
             case Compiler::Msvc:
                 m_of
@@ -332,13 +346,13 @@ namespace {
                 auto c_start_path = m_resolve.m_crate.get_lang_item_path_opt("mrustc-start");
                 if( c_start_path == ::HIR::SimplePath() )
                 {
-                    m_of << "\treturn " << Trans_Mangle( ::HIR::GenericPath(m_resolve.m_crate.get_lang_item_path(Span(), "start")) ) << "("
-                            << "(uint8_t*)" << Trans_Mangle( ::HIR::GenericPath(m_resolve.m_crate.get_lang_item_path(Span(), "mrustc-main")) ) << ", argc, (uint8_t**)argv"
+                    m_of << "\treturn " << mangle( ::HIR::GenericPath(m_resolve.m_crate.get_lang_item_path(Span(), "start")) ) << "("
+                            << "(uint8_t*)" << mangle( ::HIR::GenericPath(m_resolve.m_crate.get_lang_item_path(Span(), "mrustc-main")) ) << ", argc, (uint8_t**)argv"
                             << ");\n";
                 }
                 else
                 {
-                    m_of << "\treturn " << Trans_Mangle(::HIR::GenericPath(c_start_path)) << "(argc, argv);\n";
+                    m_of << "\treturn " << mangle(::HIR::GenericPath(c_start_path)) << "(argc, argv);\n";
                 }
                 m_of << "}\n";
 
@@ -456,7 +470,8 @@ namespace {
             }
 
             // Execute $CC with the required libraries
-            ::std::vector<::std::string>    tmp;
+            // NOTE: A list, as the returned pointers have to stay valid (a vector would move short strings when it grows)
+            ::std::list<::std::string>    tmp;
             auto cache_str = [&](::std::string s){ tmp.push_back(::std::move(s)); return tmp.back().c_str(); };
             ::std::vector<const char*>  args;
             bool is_windows = false;
@@ -480,6 +495,10 @@ namespace {
                 {
                     args.push_back("-g");
                 }
+                for(const auto& f : Target_GetCurSpec().m_arch.m_features)
+                {
+                    args.push_back(cache_str( "-m" + f ));
+                }
                 args.push_back("-o");
                 args.push_back(m_outfile_path.c_str());
                 args.push_back(m_outfile_path_c.c_str());
@@ -487,6 +506,9 @@ namespace {
                 {
                     for( const auto& crate : m_crate.m_ext_crates )
                     {
+                        // MIR-only libraries don't have an object, their code is in this file
+                        if( crate.second.m_data->m_is_mir_only )
+                            continue ;
                         args.push_back(cache_str( crate.second.m_path + ".o" ));
                     }
                     for(const auto& path : link_dirs )
@@ -544,6 +566,8 @@ namespace {
 
                     for( const auto& crate : m_crate.m_ext_crates )
                     {
+                        if( crate.second.m_data->m_is_mir_only )
+                            continue ;
                         args.push_back(cache_str( crate.second.m_path + ".o" ));
                     }
                     // Crate-specified libraries
@@ -621,7 +645,7 @@ namespace {
 
             ::MIR::TypeResolve  mir_res { sp, m_resolve, FMT_CB(ss, ss << drop_glue_path;), struct_ty_ptr, args, *(::MIR::Function*)nullptr };
             m_mir_res = &mir_res;
-            m_of << "static void " << Trans_Mangle(drop_glue_path) << "(struct s_" << Trans_Mangle(p) << "* rv) {\n";
+            m_of << "static void " << mangle(drop_glue_path) << "(struct s_" << mangle(p) << "* rv) {\n";
 
             // Obtain inner pointer
             // TODO: This is very specific to the structure of the official liballoc's Box.
@@ -629,7 +653,7 @@ namespace {
             // Call destructor of inner data
             emit_destructor_call( ::MIR::LValue::make_Deref({ box$(::MIR::LValue::make_Argument({0})) }), *ity, true, 1);
             // Emit a call to box_free for the type
-            m_of << "\t" << Trans_Mangle(box_free) << "(arg0);\n";
+            m_of << "\t" << mangle(box_free) << "(arg0);\n";
 
             m_of << "}\n";
             m_mir_res = nullptr;
@@ -640,10 +664,10 @@ namespace {
             switch(m_compiler)
             {
             case Compiler::Gcc:
-                m_of << "tTYPEID __typeid_" << Trans_Mangle(ty) << " __attribute__((weak));\n";
+                m_of << "tTYPEID __typeid_" << mangle(ty) << " __attribute__((weak));\n";
                 break;
             case Compiler::Msvc:
-                m_of << "__declspec(selectany) tTYPEID __typeid_" << Trans_Mangle(ty) << ";\n";
+                m_of << "__declspec(selectany) tTYPEID __typeid_" << mangle(ty) << ";\n";
                 break;
             }
         }
@@ -667,13 +691,13 @@ namespace {
                 (Unbound,  throw ""; ),
                 (Opaque,  throw ""; ),
                 (Struct,
-                    m_of << "struct s_" << Trans_Mangle(te.path) << ";\n";
+                    m_of << "struct s_" << mangle(te.path) << ";\n";
                     ),
                 (Union,
-                    m_of << "union u_" << Trans_Mangle(te.path) << ";\n";
+                    m_of << "union u_" << mangle(te.path) << ";\n";
                     ),
                 (Enum,
-                    m_of << "struct e_" << Trans_Mangle(te.path) << ";\n";
+                    m_of << "struct e_" << mangle(te.path) << ";\n";
                     )
                 )
             )
@@ -684,6 +708,20 @@ namespace {
             else {
             }
         }
+        /// Check (at C compile time) that the C compiler's layout of a type matches the layout engine's
+        /// - `size_of`/`min_align_of` are replaced by the engine's values (by MIR optimisation, constant evaluation and
+        ///   codegen), so a mismatch would silently break unsafe code.
+        void emit_layout_assert(const Span& sp, const ::HIR::TypeRef& ty)
+        {
+            if( m_compiler != Compiler::Gcc )
+                return ;
+            size_t  size, align;
+            if( !Target_GetSizeOf(sp, m_resolve, ty, size) || size == SIZE_MAX )
+                return ;
+            if( !Target_GetAlignOf(sp, m_resolve, ty, align) || align == 0 )
+                return ;
+            m_of << "_Static_assert(sizeof("; emit_ctype(ty); m_of << ") == " << size << " && _Alignof("; emit_ctype(ty); m_of << ") == " << align << ", \"layout mismatch\");\n";
+        }
         void emit_type_fn(const ::HIR::TypeRef& ty)
         {
             const auto& te = ty.m_data.as_Function();
@@ -730,14 +768,17 @@ namespace {
             TU_IFLET( ::HIR::TypeRef::Data, ty.m_data, Tuple, te,
                 if( te.size() > 0 )
                 {
+                    const auto* repr = Target_GetTypeRepr(sp, m_resolve, ty);
+                    MIR_ASSERT(*m_mir_res, repr, "No layout for " << ty);
                     m_of << "typedef struct "; emit_ctype(ty); m_of << " {\n";
-                    for(unsigned int i = 0; i < te.size(); i++)
+                    for(auto i : repr->field_order)
                     {
                         m_of << "\t";
                         emit_ctype(te[i], FMT_CB(ss, ss << "_" << i;));
                         m_of << ";\n";
                     }
                     m_of << "} "; emit_ctype(ty); m_of << ";\n";
+                    emit_layout_assert(sp, ty);
                 }
 
                 auto drop_glue_path = ::HIR::Path(ty.clone(), "#drop_glue");
@@ -745,7 +786,7 @@ namespace {
                 auto ty_ptr = ::HIR::TypeRef::new_pointer(::HIR::BorrowType::Owned, ty.clone());
                 ::MIR::TypeResolve  mir_res { sp, m_resolve, FMT_CB(ss, ss << drop_glue_path;), ty_ptr, args, *(::MIR::Function*)nullptr };
                 m_mir_res = &mir_res;
-                m_of << "static void " << Trans_Mangle(drop_glue_path) << "("; emit_ctype(ty); m_of << "* rv) {";
+                m_of << "static void " << mangle(drop_glue_path) << "("; emit_ctype(ty); m_of << "* rv) {";
                 auto self = ::MIR::LValue::make_Deref({ box$(::MIR::LValue::make_Return({})) });
                 auto fld_lv = ::MIR::LValue::make_Field({ box$(self), 0 });
                 for(const auto& ity : te)
@@ -757,7 +798,9 @@ namespace {
             )
             else TU_IFLET( ::HIR::TypeRef::Data, ty.m_data, Function, te,
                 emit_type_fn(ty);
-                m_of << " // " << ty << "\n";
+                if( !m_options.compact )
+                    m_of << " // " << ty;
+                m_of << "\n";
             )
             else TU_IFLET( ::HIR::TypeRef::Data, ty.m_data, Array, te,
                 m_of << "typedef struct "; emit_ctype(ty); m_of << " { "; emit_ctype(*te.inner); m_of << " DATA[" << te.size_val << "]; } "; emit_ctype(ty); m_of << ";\n";
@@ -808,8 +851,25 @@ namespace {
                     emit_ctype( ty, inner );
                 }
                 };
-            m_of << "// struct " << p << "\n";
-            m_of << "struct s_" << Trans_Mangle(p) << " {\n";
+            auto struct_ty = ::HIR::TypeRef(p.clone(), &item);
+            // Fields are emitted in the order chosen by the layout engine (they're always accessed by name)
+            ::std::vector<unsigned int> field_order;
+            if( const auto* repr = Target_GetTypeRepr(sp, m_resolve, struct_ty) )
+            {
+                field_order = repr->field_order;
+            }
+            else
+            {
+                MIR_BUG(*m_mir_res, "No layout for " << struct_ty);
+            }
+            bool is_packed = item.m_repr == ::HIR::Struct::Repr::Packed;
+            if( !m_options.compact )
+                m_of << "// struct " << p << "\n";
+            if( is_packed && m_compiler == Compiler::Msvc )
+            {
+                m_of << "#pragma pack(push, 1)\n";
+            }
+            m_of << "struct s_" << mangle(p) << " {\n";
 
             // HACK: For vtables, insert the alignment and size at the start
             {
@@ -834,9 +894,23 @@ namespace {
                         m_of << "\tchar _d;\n";
                     }
                 }
+                else if( item.m_repr == ::HIR::Struct::Repr::Simd && m_compiler == Compiler::Gcc )
+                {
+                    // The lanes overlay a GCC vector (`.v`), which is what the `simd_*` intrinsics operate on
+                    const auto& repr = *Target_GetTypeRepr(sp, m_resolve, struct_ty);
+                    m_of << "\tunion {\n";
+                    m_of << "\t\tstruct {";
+                    for(unsigned int i = 0; i < repr.fields.size(); i ++)
+                    {
+                        m_of << " "; emit_ctype(repr.fields[i].ty, FMT_CB(ss, ss << "_" << i;)); m_of << ";";
+                    }
+                    m_of << " };\n";
+                    m_of << "\t\t"; emit_ctype(repr.fields[0].ty, FMT_CB(ss, ss << "__attribute__((vector_size(" << repr.size << "))) v";)); m_of << ";\n";
+                    m_of << "\t};\n";
+                }
                 else
                 {
-                    for(unsigned int i = 0; i < e.size(); i ++)
+                    for(auto i : field_order)
                     {
                         const auto& fld = e[i];
                         m_of << "\t";
@@ -855,7 +929,7 @@ namespace {
                 }
                 else
                 {
-                    for(unsigned int i = 0; i < e.size(); i ++)
+                    for(auto i : field_order)
                     {
                         const auto& fld = e[i].second;
                         m_of << "\t";
@@ -865,9 +939,23 @@ namespace {
                 }
                 )
             )
-            m_of << "};\n";
+            if( is_packed && m_compiler == Compiler::Gcc )
+            {
+                m_of << "} __attribute__((packed));\n";
+            }
+            else
+            {
+                m_of << "};\n";
+            }
+            if( is_packed && m_compiler == Compiler::Msvc )
+            {
+                m_of << "#pragma pack(pop)\n";
+            }
+            if( !has_unsized )
+            {
+                emit_layout_assert(sp, struct_ty);
+            }
 
-            auto struct_ty = ::HIR::TypeRef(p.clone(), &item);
             auto drop_glue_path = ::HIR::Path(struct_ty.clone(), "#drop_glue");
             auto struct_ty_ptr = ::HIR::TypeRef::new_borrow(::HIR::BorrowType::Owned, struct_ty.clone());
             // - Drop Glue
@@ -884,22 +972,22 @@ namespace {
                         m_of << "extern ";
                     }
                 }
-                m_of << "tUNIT " << Trans_Mangle( ::HIR::Path(struct_ty.clone(), m_resolve.m_lang_Drop, "drop") ) << "("; emit_ctype(struct_ty_ptr, FMT_CB(ss, ss << "rv";)); m_of << ");\n";
+                m_of << "tUNIT " << mangle( ::HIR::Path(struct_ty.clone(), m_resolve.m_lang_Drop, "drop") ) << "("; emit_ctype(struct_ty_ptr, FMT_CB(ss, ss << "rv";)); m_of << ");\n";
             }
             else if( m_resolve.is_type_owned_box(struct_ty) )
             {
                 m_box_glue_todo.push_back( ::std::make_pair( mv$(struct_ty.m_data.as_Path().path.m_data.as_Generic()), &item ) );
-                m_of << "static void " << Trans_Mangle(drop_glue_path) << "("; emit_ctype(struct_ty_ptr, FMT_CB(ss, ss << "rv";)); m_of << ");\n";
+                m_of << "static void " << mangle(drop_glue_path) << "("; emit_ctype(struct_ty_ptr, FMT_CB(ss, ss << "rv";)); m_of << ");\n";
                 return ;
             }
 
             ::MIR::TypeResolve  mir_res { sp, m_resolve, FMT_CB(ss, ss << drop_glue_path;), struct_ty_ptr, args, *(::MIR::Function*)nullptr };
             m_mir_res = &mir_res;
-            m_of << "static void " << Trans_Mangle(drop_glue_path) << "("; emit_ctype(struct_ty_ptr, FMT_CB(ss, ss << "rv";)); m_of << ") {\n";
+            m_of << "static void " << mangle(drop_glue_path) << "("; emit_ctype(struct_ty_ptr, FMT_CB(ss, ss << "rv";)); m_of << ") {\n";
 
             // If this type has an impl of Drop, call that impl
             if( item.m_markings.has_drop_impl ) {
-                m_of << "\t" << Trans_Mangle( ::HIR::Path(struct_ty.clone(), m_resolve.m_lang_Drop, "drop") ) << "(rv);\n";
+                m_of << "\t" << mangle( ::HIR::Path(struct_ty.clone(), m_resolve.m_lang_Drop, "drop") ) << "(rv);\n";
             }
 
             auto self = ::MIR::LValue::make_Deref({ box$(::MIR::LValue::make_Return({})) });
@@ -947,7 +1035,7 @@ namespace {
                     return x;
                 }
                 };
-            m_of << "union u_" << Trans_Mangle(p) << " {\n";
+            m_of << "union u_" << mangle(p) << " {\n";
             for(unsigned int i = 0; i < item.m_variants.size(); i ++)
             {
                 m_of << "\t"; emit_ctype( monomorph(item.m_variants[i].second.ent), FMT_CB(ss, ss << "var_" << i;) ); m_of << ";\n";
@@ -956,6 +1044,7 @@ namespace {
 
             // Drop glue (calls destructor if there is one)
             auto item_ty = ::HIR::TypeRef(p.clone(), &item);
+            emit_layout_assert(sp, item_ty);
             auto drop_glue_path = ::HIR::Path(item_ty.clone(), "#drop_glue");
             auto item_ptr_ty = ::HIR::TypeRef::new_borrow(::HIR::BorrowType::Owned, item_ty.clone());
             auto drop_impl_path = (item.m_markings.has_drop_impl ? ::HIR::Path(item_ty.clone(), m_resolve.m_lang_Drop, "drop") : ::HIR::Path(::HIR::SimplePath()));
@@ -964,49 +1053,55 @@ namespace {
 
             if( item.m_markings.has_drop_impl )
             {
-                m_of << "tUNIT " << Trans_Mangle(drop_impl_path) << "(union u_" << Trans_Mangle(p) << "*rv);\n";
+                m_of << "tUNIT " << mangle(drop_impl_path) << "(union u_" << mangle(p) << "*rv);\n";
             }
 
-            m_of << "static void " << Trans_Mangle(drop_glue_path) << "(union u_" << Trans_Mangle(p) << "* rv) {\n";
+            m_of << "static void " << mangle(drop_glue_path) << "(union u_" << mangle(p) << "* rv) {\n";
             if( item.m_markings.has_drop_impl )
             {
-                m_of << "\t" << Trans_Mangle(drop_impl_path) << "(rv);\n";
+                m_of << "\t" << mangle(drop_impl_path) << "(rv);\n";
             }
             m_of << "}\n";
         }
 
-        // TODO: Move this to codegen.cpp?
-        bool get_nonzero_path(const Span& sp, const ::HIR::TypeRef& ty, ::std::vector<unsigned int>& out) const
+        /// Obtain the layout of a niche-filled enum (nullptr if the enum has an explicit tag)
+        const TypeRepr* get_niche_enum_repr(const Span& sp, const ::HIR::TypeRef& ty) const
         {
-            TU_MATCH_DEF( ::HIR::TypeRef::Data, (ty.m_data), (te),
-            (
-                return false;
-                ),
-            (Borrow,
-                if( metadata_type(*te.inner) != MetadataType::None )
-                {
-                    // HACK: If the inner is a DST, emit ~0 as a marker
-                    out.push_back(~0u);
-                }
-                return true;
-                ),
-            (Function,
-                return true;
-                )
-            )
+            const auto* repr = Target_GetTypeRepr(sp, m_resolve, ty);
+            return repr && repr->is_niche_enum() ? repr : nullptr;
         }
-        void emit_nonzero_path(const ::std::vector<unsigned int>& nonzero_path) {
-            for(const auto v : nonzero_path)
+        /// Emit the integer type used to access an enum niche
+        void emit_niche_ctype(const TypeRepr::Niche& niche)
+        {
+            switch(niche.size)
             {
-                if(v == ~0u) {
-                    // NOTE: Should only ever be the last
-                    m_of << ".PTR";
-                }
-                else {
-                    m_of << "._" << v;
-                }
+            case 1: m_of << "uint8_t";  break;
+            case 2: m_of << "uint16_t"; break;
+            case 4: m_of << "uint32_t"; break;
+            case 8: m_of << "uint64_t"; break;
+            default:
+                BUG(Span(), "Unexpected niche size " << niche.size);
             }
         }
+        /// Emit a `switch` over the variant of a niche-filled enum (`emit_val` emits the enum value)
+        /// - The dataless variants are matched by their niche value, the variant with data is the `default`
+        void emit_niche_enum_switch(const TypeRepr& repr, size_t n_variants, unsigned indent_level, ::std::function<void()> emit_val, ::std::function<void(size_t)> cb)
+        {
+            auto indent = RepeatLitStr { "\t", static_cast<int>(indent_level) };
+            m_of << indent << "switch("; emit_val(); m_of << ".DATA.NICHE.v) {\n";
+            for(size_t var_idx = 0; var_idx < n_variants; var_idx ++)
+            {
+                if( var_idx == repr.niche_variant )
+                    continue ;
+                m_of << indent << "case " << repr.get_niche_value(var_idx) << ": ";
+                cb(var_idx);
+                m_of << "\n";
+            }
+            m_of << indent << "default: ";
+            cb(repr.niche_variant);
+            m_of << "\n";
+            m_of << indent << "}\n";
+        }
 
         void emit_enum(const Span& sp, const ::HIR::GenericPath& p, const ::HIR::Enum& item) override
         {
@@ -1026,70 +1121,12 @@ namespace {
                 }
                 };
 
-            // TODO: Cache repr info elsewhere (and have core codegen be responsible instead)
-            // TODO: Do more complex nonzero relations.
-            ::std::vector<unsigned> nonzero_path;
-            {
-                // Detect Option (and similar enums)
-                if( item.m_variants.size() == 2 && item.m_variants[0].second.is_Unit() && item.m_variants[1].second.is_Tuple() )
-                {
-                    const auto& data_ents = item.m_variants[1].second.as_Tuple();
-                    if( data_ents.size() == 1 )
-                    {
-                        const auto& data_type = monomorph(data_ents[0].ent);
-                        if( get_nonzero_path(sp, data_type, nonzero_path) )
-                        {
-                            nonzero_path.push_back(0);
-                            ::std::reverse( nonzero_path.begin(), nonzero_path.end() );
-                        }
-                        else
-                        {
-                            assert(nonzero_path.size() == 0);
-                        }
-                    }
-                }
-            }
+            auto struct_ty = ::HIR::TypeRef(p.clone(), &item);
+            // Niche-filled enums don't have a tag (the layout is chosen by `Target_GetTypeRepr`)
+            const auto* niche_repr = get_niche_enum_repr(sp, struct_ty);
 
-            m_of << "// enum " << p << "\n";
-            if( nonzero_path.size() > 0 )
-            {
-                MIR_ASSERT(*m_mir_res, nonzero_path[0] == 0, "");
-                MIR_ASSERT(*m_mir_res, item.m_variants.size() == 2, "");
-                MIR_ASSERT(*m_mir_res, item.m_variants[0].second.is_Unit(), "");
-                const auto& data_var = item.m_variants[1];
-                MIR_ASSERT(*m_mir_res, data_var.second.is_Tuple(), "");
-                MIR_ASSERT(*m_mir_res, data_var.second.as_Tuple().size() == 1, "");
-                const auto& data_type = monomorph(data_var.second.as_Tuple()[0].ent);
-                m_of << "struct e_" << Trans_Mangle(p) << " {\n";
-                m_of << "\t"; emit_ctype(data_type, FMT_CB(s, s << "_0";)); m_of << ";\n";
-                m_of << "};\n";
-            }
-            else if( item.m_repr != ::HIR::Enum::Repr::Rust || ::std::all_of(item.m_variants.begin(), item.m_variants.end(), [](const auto& x){return x.second.is_Unit() || x.second.is_Value();}) )
-            {
-                m_of << "struct e_" << Trans_Mangle(p) << " {\n";
-                switch(item.m_repr)
-                {
-                case ::HIR::Enum::Repr::Rust:
-                case ::HIR::Enum::Repr::C:
-                    m_of << "\tunsigned int TAG;\n";
-                    break;
-                case ::HIR::Enum::Repr::U8:
-                    m_of << "\tuint8_t TAG;\n";
-                    break;
-                case ::HIR::Enum::Repr::U16:
-                    m_of << "\tuint16_t TAG;\n";
-                    break;
-                case ::HIR::Enum::Repr::U32:
-                    m_of << "\tuint32_t TAG;\n";
-                    break;
-                }
-                m_of << "};\n";
-            }
-            else
-            {
-                m_of << "struct e_" << Trans_Mangle(p) << " {\n";
-                m_of << "\tunsigned int TAG;\n";
-                m_of << "\tunion {\n";
+            // Union of the variants with fields, each a struct of its fields
+            auto emit_variant_structs = [&]() {
                 for(unsigned int i = 0; i < item.m_variants.size(); i ++)
                 {
                     TU_MATCHA( (item.m_variants[i].second), (e),
@@ -1123,14 +1160,59 @@ namespace {
                         )
                     )
                 }
+                };
+
+            if( !m_options.compact )
+                m_of << "// enum " << p << "\n";
+            if( niche_repr )
+            {
+                const auto& niche = niche_repr->enum_niche;
+                m_of << "struct e_" << mangle(p) << " {\n";
+                m_of << "\tunion {\n";
+                emit_variant_structs();
+                // The niche is accessed as a raw integer (so out-of-range values aren't normalised, e.g. for `bool`)
+                m_of << "\t\tstruct { ";
+                if( niche.offset > 0 )
+                    m_of << "uint8_t _pad[" << niche.offset << "]; ";
+                emit_niche_ctype(niche); m_of << " v; } NICHE;\n";
+                m_of << "\t} DATA;\n";
+                m_of << "};\n";
+            }
+            else if( item.m_repr != ::HIR::Enum::Repr::Rust || ::std::all_of(item.m_variants.begin(), item.m_variants.end(), [](const auto& x){return x.second.is_Unit() || x.second.is_Value();}) )
+            {
+                m_of << "struct e_" << mangle(p) << " {\n";
+                switch(item.m_repr)
+                {
+                case ::HIR::Enum::Repr::Rust:
+                case ::HIR::Enum::Repr::C:
+                    m_of << "\tunsigned int TAG;\n";
+                    break;
+                case ::HIR::Enum::Repr::U8:
+                    m_of << "\tuint8_t TAG;\n";
+                    break;
+                case ::HIR::Enum::Repr::U16:
+                    m_of << "\tuint16_t TAG;\n";
+                    break;
+                case ::HIR::Enum::Repr::U32:
+                    m_of << "\tuint32_t TAG;\n";
+                    break;
+                }
+                m_of << "};\n";
+            }
+            else
+            {
+                m_of << "struct e_" << mangle(p) << " {\n";
+                m_of << "\tunsigned int TAG;\n";
+                m_of << "\tunion {\n";
+                emit_variant_structs();
                 m_of << "\t} DATA;\n";
                 m_of << "};\n";
             }
+            emit_layout_assert(sp, struct_ty);
 
             // ---
             // - Drop Glue
             // ---
-            auto struct_ty = ::HIR::TypeRef(p.clone(), &item);
             auto drop_glue_path = ::HIR::Path(struct_ty.clone(), "#drop_glue");
             auto struct_ty_ptr = ::HIR::TypeRef::new_borrow(::HIR::BorrowType::Owned, struct_ty.clone());
             auto drop_impl_path = (item.m_markings.has_drop_impl ? ::HIR::Path(struct_ty.clone(), m_resolve.m_lang_Drop, "drop") : ::HIR::Path(::HIR::SimplePath()));
@@ -1139,29 +1221,55 @@ namespace {
 
             if( item.m_markings.has_drop_impl )
             {
-                m_of << "tUNIT " << Trans_Mangle(drop_impl_path) << "(struct e_" << Trans_Mangle(p) << "*rv);\n";
+                m_of << "tUNIT " << mangle(drop_impl_path) << "(struct e_" << mangle(p) << "*rv);\n";
             }
 
-            m_of << "static void " << Trans_Mangle(drop_glue_path) << "(struct e_" << Trans_Mangle(p) << "* rv) {\n";
+            m_of << "static void " << mangle(drop_glue_path) << "(struct e_" << mangle(p) << "* rv) {\n";
 
             // If this type has an impl of Drop, call that impl
             if( item.m_markings.has_drop_impl )
             {
-                m_of << "\t" << Trans_Mangle(drop_impl_path) << "(rv);\n";
+                m_of << "\t" << mangle(drop_impl_path) << "(rv);\n";
             }
             auto self = ::MIR::LValue::make_Deref({ box$(::MIR::LValue::make_Return({})) });
+            auto fld_lv = ::MIR::LValue::make_Field({ box$(::MIR::LValue::make_Downcast({ box$(self), 0 })), 0 });
+            // Drop the fields of a variant (as a `switch` case)
+            auto emit_variant_drop = [&](size_t var_idx) {
+                fld_lv.as_Field().val->as_Downcast().variant_index = var_idx;
+                TU_MATCHA( (item.m_variants[var_idx].second), (e),
+                (Unit,
+                    m_of << "break;";
+                    ),
+                (Value,
+                    m_of << "break;";
+                    ),
+                (Tuple,
+                    m_of << "{\n";
+                    for(unsigned int i = 0; i < e.size(); i ++)
+                    {
+                        fld_lv.as_Field().field_index = i;
+                        const auto& fld = e[i];
 
-            if( nonzero_path.size() > 0 )
+                        emit_destructor_call(fld_lv, monomorph(fld.ent), false, 2);
+                    }
+                    m_of << "\t} break;";
+                    ),
+                (Struct,
+                    m_of << "{\n";
+                    for(unsigned int i = 0; i < e.size(); i ++)
+                    {
+                        fld_lv.as_Field().field_index = i;
+                        const auto& fld = e[i];
+                        emit_destructor_call(fld_lv, monomorph(fld.second.ent), false, 2);
+                    }
+                    m_of << "\t} break;";
+                    )
+                )
+                };
+
+            if( niche_repr )
             {
-                auto fld_lv = ::MIR::LValue::make_Field({ box$(self), 0 });
-                // TODO: Fat pointers?
-                m_of << "\tif( ! (*rv)"; emit_nonzero_path(nonzero_path); m_of << " ) {\n";
-                for(const auto& fld : item.m_variants[1].second.as_Tuple())
-                {
-                    emit_destructor_call(fld_lv, monomorph(fld.ent), false, 2);
-                    fld_lv.as_Field().field_index ++;
-                }
-                m_of << "\t}\n";
+                emit_niche_enum_switch(*niche_repr, item.m_variants.size(), 1, [&](){ m_of << "(*rv)"; }, emit_variant_drop);
             }
             else if( item.m_repr != ::HIR::Enum::Repr::Rust || ::std::all_of(item.m_variants.begin(), item.m_variants.end(), [](const auto& x){return x.second.is_Unit() || x.second.is_Value();}) )
             {
@@ -1169,51 +1277,17 @@ namespace {
             }
             else
             {
-                auto fld_lv = ::MIR::LValue::make_Field({ box$(::MIR::LValue::make_Downcast({ box$(self), 0 })), 0 });
-
                 m_of << "\tswitch(rv->TAG) {\n";
                 for(unsigned int var_idx = 0; var_idx < item.m_variants.size(); var_idx ++)
                 {
-                    fld_lv.as_Field().val->as_Downcast().variant_index = var_idx;
-                    TU_MATCHA( (item.m_variants[var_idx].second), (e),
-                    (Unit,
-                        m_of << "\tcase " << var_idx << ": break;\n";
-                        ),
-                    (Value,
-                        m_of << "\tcase " << var_idx << ": break;\n";
-                        ),
-                    (Tuple,
-                        m_of << "\tcase " << var_idx << ":\n";
-                        for(unsigned int i = 0; i < e.size(); i ++)
-                        {
-                            fld_lv.as_Field().field_index = i;
-                            const auto& fld = e[i];
-
-                            emit_destructor_call(fld_lv, monomorph(fld.ent), false, 2);
-                        }
-                        m_of << "\tbreak;\n";
-                        ),
-                    (Struct,
-                        m_of << "\tcase " << var_idx << ":\n";
-                        for(unsigned int i = 0; i < e.size(); i ++)
-                        {
-                            fld_lv.as_Field().field_index = i;
-                            const auto& fld = e[i];
-                            emit_destructor_call(fld_lv, monomorph(fld.second.ent), false, 2);
-                        }
-                        m_of << "\tbreak;\n";
-                        )
-                    )
+                    m_of << "\tcase " << var_idx << ": ";
+                    emit_variant_drop(var_idx);
+                    m_of << "\n";
                 }
                 m_of << "\t}\n";
             }
             m_of << "}\n";
             m_mir_res = nullptr;
-
-            if( nonzero_path.size() )
-            {
-                m_enum_repr_cache.insert( ::std::make_pair( p.clone(), mv$(nonzero_path) ) );
-            }
         }
 
         void emit_constructor_enum(const Span& sp, const ::HIR::GenericPath& path, const ::HIR::Enum& item, size_t var_idx) override
@@ -1238,7 +1312,7 @@ namespace {
             const auto& e = var.second.as_Tuple();
 
 
-            m_of << "struct e_" << Trans_Mangle(p) << " " << Trans_Mangle(path) << "(";
+            m_of << "struct e_" << mangle(p) << " " << mangle(path) << "(";
             for(unsigned int i = 0; i < e.size(); i ++)
             {
                 if(i != 0)
@@ -1246,14 +1320,26 @@ namespace {
                 emit_ctype( monomorph(e[i].ent), FMT_CB(ss, ss << "_" << i;) );
             }
             m_of << ") {\n";
-            auto it = m_enum_repr_cache.find(p);
-            if( it != m_enum_repr_cache.end() )
+            const auto* niche_repr = get_niche_enum_repr(sp, ::HIR::TypeRef(p.clone(), &item));
+            if( niche_repr && var_idx != niche_repr->niche_variant )
             {
-                m_of << "\tstruct e_" << Trans_Mangle(p) << " rv = { ._0 = _0 };\n";
+                // NOTE: Dataless variants only have zero-sized fields, so just set the niche
+                m_of << "\tstruct e_" << mangle(p) << " rv = { .DATA = { .NICHE = { .v = " << niche_repr->get_niche_value(var_idx) << " } } };\n";
+            }
+            else if( niche_repr )
+            {
+                m_of << "\tstruct e_" << mangle(p) << " rv = { .DATA = { .var_" << var_idx << " = {";
+                for(unsigned int i = 0; i < e.size(); i ++)
+                {
+                    if(i != 0)
+                    m_of << ",";
+                    m_of << "\n\t\t_" << i;
+                }
+                m_of << "\n\t\t} }};\n";
             }
             else
             {
-                m_of << "\tstruct e_" << Trans_Mangle(p) << " rv = { .TAG = " << var_idx;
+                m_of << "\tstruct e_" << mangle(p) << " rv = { .TAG = " << var_idx;
 
                 if( e.empty() )
                 {
@@ -1298,7 +1384,7 @@ namespace {
                 };
             // Crate constructor function
             const auto& e = item.m_data.as_Tuple();
-            m_of << "struct s_" << Trans_Mangle(p) << " " << Trans_Mangle(p) << "(";
+            m_of << "struct s_" << mangle(p) << " " << mangle(p) << "(";
             for(unsigned int i = 0; i < e.size(); i ++)
             {
                 if(i != 0)
@@ -1306,7 +1392,7 @@ namespace {
                 emit_ctype( monomorph(e[i].ent), FMT_CB(ss, ss << "_" << i;) );
             }
             m_of << ") {\n";
-            m_of << "\tstruct s_" << Trans_Mangle(p) << " rv = {";
+            m_of << "\tstruct s_" << mangle(p) << " rv = {";
             for(unsigned int i = 0; i < e.size(); i ++)
             {
                 if(i != 0)
@@ -1332,23 +1418,24 @@ namespace {
                     // Handled with asm() later
                     break;
                 case Compiler::Msvc:
-                    m_of << "#pragma comment(linker, \"/alternatename:" << Trans_Mangle(p) << "=" << item.m_linkage.name << "\")\n";
+                    m_of << "#pragma comment(linker, \"/alternatename:" << mangle(p) << "=" << item.m_linkage.name << "\")\n";
                     break;
                 //case Compiler::Std11:
-                //    m_of << "#define " << Trans_Mangle(p) << " " << item.m_linkage.name << "\n";
+                //    m_of << "#define " << mangle(p) << " " << item.m_linkage.name << "\n";
                 //    break;
                 }
             }
 
             auto type = params.monomorph(m_resolve, item.m_type);
             m_of << "extern ";
-            emit_ctype( type, FMT_CB(ss, ss << Trans_Mangle(p);) );
+            emit_ctype( type, FMT_CB(ss, ss << mangle(p);) );
             if( item.m_linkage.name != "" && m_compiler == Compiler::Gcc)
             {
                 m_of << " asm(\"" << item.m_linkage.name << "\")";
             }
             m_of << ";";
-            m_of << "\t// static " << p << " : " << type;
+            if( !m_options.compact )
+                m_of << "\t// static " << p << " : " << type;
             m_of << "\n";
 
             m_mir_res = nullptr;
@@ -1360,9 +1447,10 @@ namespace {
 
             TRACE_FUNCTION_F(p);
             auto type = params.monomorph(m_resolve, item.m_type);
-            emit_ctype( type, FMT_CB(ss, ss << Trans_Mangle(p);) );
+            emit_ctype( type, FMT_CB(ss, ss << mangle(p);) );
             m_of << ";";
-            m_of << "\t// static " << p << " : " << type;
+            if( !m_options.compact )
+                m_of << "\t// static " << p << " : " << type;
             m_of << "\n";
 
             m_mir_res = nullptr;
@@ -1375,11 +1463,12 @@ namespace {
             TRACE_FUNCTION_F(p);
 
             auto type = params.monomorph(m_resolve, item.m_type);
-            emit_ctype( type, FMT_CB(ss, ss << Trans_Mangle(p);) );
+            emit_ctype( type, FMT_CB(ss, ss << mangle(p);) );
             m_of << " = ";
             emit_literal(type, item.m_value_res, params);
             m_of << ";";
-            m_of << "\t// static " << p << " : " << type;
+            if( !m_options.compact )
+                m_of << "\t// static " << p << " : " << type;
             m_of << "\n";
 
             m_mir_res = nullptr;
@@ -1467,8 +1556,11 @@ namespace {
                 if( ty.m_data.is_Array() )
                     m_of << "{";
                 m_of << "{";
-                for(unsigned int i = 0; i < e.size(); i ++) {
-                    if(i != 0)  m_of << ",";
+                // Struct and tuple fields are initialised in memory order
+                const auto* repr = (ty.m_data.is_Array() ? nullptr : Target_GetTypeRepr(sp, m_resolve, ty));
+                for(unsigned int j = 0; j < e.size(); j ++) {
+                    auto i = (repr && !repr->field_order.empty() ? repr->field_order.at(j) : j);
+                    if(j != 0)  m_of << ",";
                     m_of << " ";
                     emit_literal(get_inner_type(0, i), e[i], params);
                 }
@@ -1482,16 +1574,19 @@ namespace {
                 MIR_ASSERT(*m_mir_res, ty.m_data.is_Path(), "");
                 MIR_ASSERT(*m_mir_res, ty.m_data.as_Path().binding.is_Enum(), "");
                 const auto& enm = *ty.m_data.as_Path().binding.as_Enum();
-                auto it = m_enum_repr_cache.find(ty.m_data.as_Path().path.m_data.as_Generic());
-                if( it != m_enum_repr_cache.end() )
+                if( const auto* niche_repr = get_niche_enum_repr(m_mir_res->sp, ty) )
                 {
-                    if( e.idx == 0 ) {
-                        m_of << "{0}";
+                    if( e.idx != niche_repr->niche_variant ) {
+                        m_of << "{ { .NICHE = { .v = " << niche_repr->get_niche_value(e.idx) << " } } }";
                     }
                     else {
-                        m_of << "{";
-                        emit_literal(get_inner_type(e.idx, 0), e.vals[0], params);
-                        m_of << "}";
+                        m_of << "{ { .var_" << e.idx << " = {";
+                        for(unsigned int i = 0; i < e.vals.size(); i ++) {
+                            if(i != 0)  m_of << ",";
+                            m_of << " ";
+                            emit_literal(get_inner_type(e.idx, i), e.vals[i], params);
+                        }
+                        m_of << "} } }";
                     }
                 }
                 else if( enm.is_value() )
@@ -1605,7 +1700,7 @@ namespace {
                             const auto& stat = vi.as_Static();
                             MIR_ASSERT(*m_mir_res, stat.m_type.m_data.is_Array(), "BorrowOf : &[T] of non-array static, " << pe.m_path << " - " << stat.m_type);
                             unsigned int size = stat.m_type.m_data.as_Array().size_val;
-                            m_of << "{ &" << Trans_Mangle( params.monomorph(m_resolve, e)) << ", " << size << "}";
+                            m_of << "{ &" << mangle( params.monomorph(m_resolve, e)) << ", " << size << "}";
                             return ;
                         }
                         else if( TU_TEST1(ty.m_data, Borrow, .inner->m_data.is_TraitObject()) || TU_TEST1(ty.m_data, Pointer, .inner->m_data.is_TraitObject()) )
@@ -1615,7 +1710,7 @@ namespace {
                             MIR_ASSERT(*m_mir_res, vi.is_Static(), "BorrowOf returning &TraitObject not of a static - " << pe.m_path << " is " << vi.tag_str());
                             const auto& stat = vi.as_Static();
                             auto vtable_path = ::HIR::Path(stat.m_type.clone(), trait_path.clone(), "#vtable");
-                            m_of << "{ &" << Trans_Mangle( params.monomorph(m_resolve, e)) << ", &" << Trans_Mangle(vtable_path) << "}";
+                            m_of << "{ &" << mangle( params.monomorph(m_resolve, e)) << ", &" << mangle(vtable_path) << "}";
                             return ;
                         }
                         else
@@ -1634,7 +1729,7 @@ namespace {
                     m_of << "&";
                     )
                 )
-                m_of << Trans_Mangle( params.monomorph(m_resolve, e));
+                m_of << mangle( params.monomorph(m_resolve, e));
                 ),
             (BorrowData,
                 MIR_TODO(*m_mir_res, "Handle BorrowData (emit_literal) - " << *e);
@@ -1705,7 +1800,7 @@ namespace {
                     auto  arg_ty = ::HIR::TypeRef::new_unit();
                     for(const auto& ty : te->m_arg_types)
                         arg_ty.m_data.as_Tuple().push_back( ty.clone() );
-                    m_of << " " << Trans_Mangle(fcn_p) << "("; emit_ctype(type, FMT_CB(ss, ss << "*ptr";)); m_of << ", "; emit_ctype(arg_ty, FMT_CB(ss, ss << "args";)); m_of << ") {\n";
+                    m_of << " " << mangle(fcn_p) << "("; emit_ctype(type, FMT_CB(ss, ss << "*ptr";)); m_of << ", "; emit_ctype(arg_ty, FMT_CB(ss, ss << "args";)); m_of << ") {\n";
                     m_of << "\treturn (*ptr)(";
                         for(unsigned int i = 0; i < te->m_arg_types.size(); i++)
                         {
@@ -1736,7 +1831,7 @@ namespace {
                 }
 
                 emit_ctype(vtable_ty);
-                m_of << " " << Trans_Mangle(p) << " = {\n";
+                m_of << " " << mangle(p) << " = {\n";
             }
 
             auto monomorph_cb_trait = monomorphise_type_get_cb(sp, &type, &trait_path.m_params, nullptr);
@@ -1751,7 +1846,7 @@ namespace {
             }
             else
             {
-                m_of << "(void*)" << Trans_Mangle(::HIR::Path(type.clone(), "#drop_glue")) << ",";
+                m_of << "(void*)" << mangle(::HIR::Path(type.clone(), "#drop_glue")) << ",";
             }
             m_of << "}";    // No newline, added below
 
@@ -1768,7 +1863,7 @@ namespace {
 
                     auto gpath = monomorphise_genericpath_with(sp, m.second.second, monomorph_cb_trait, false);
                     // NOTE: `void*` cast avoids mismatched pointer type errors due to the receiver being &mut()/&() in the vtable
-                    m_of << "\t(void*)" << Trans_Mangle( ::HIR::Path(type.clone(), mv$(gpath), m.first) );
+                    m_of << "\t(void*)" << mangle( ::HIR::Path(type.clone(), mv$(gpath), m.first) );
                 }
             }
             m_of << "\n";
@@ -1791,15 +1886,16 @@ namespace {
                     // Handled with asm() later
                     break;
                 case Compiler::Msvc:
-                    m_of << "#pragma comment(linker, \"/alternatename:" << Trans_Mangle(p) << "=" << item.m_linkage.name << "\")\n";
+                    m_of << "#pragma comment(linker, \"/alternatename:" << mangle(p) << "=" << item.m_linkage.name << "\")\n";
                     break;
                 //case Compiler::Std11:
-                //    m_of << "#define " << Trans_Mangle(p) << " " << item.m_linkage.name << "\n";
+                //    m_of << "#define " << mangle(p) << " " << item.m_linkage.name << "\n";
                 //    break;
                 }
             }
 
-            m_of << "// EXTERN extern \"" << item.m_abi << "\" " << p << "\n";
+            if( !m_options.compact )
+                m_of << "// EXTERN extern \"" << item.m_abi << "\" " << p << "\n";
             m_of << "extern ";
             emit_function_header(p, item, params);
             if( item.m_linkage.name != "" && m_compiler == Compiler::Gcc)
@@ -1810,29 +1906,37 @@ namespace {
 
             m_mir_res = nullptr;
         }
-        void emit_function_proto(const ::HIR::Path& p, const ::HIR::Function& item, const Trans_Params& params, bool is_extern_def) override
+        void emit_function_proto(const ::HIR::Path& p, const ::HIR::Function& item, const Trans_Params& params, bool is_extern_def, bool is_weak_def) override
         {
             ::MIR::TypeResolve  top_mir_res { sp, m_resolve, FMT_CB(ss, ss << "/*proto*/ fn " << p;), ::HIR::TypeRef(), {}, *(::MIR::Function*)nullptr };
             m_mir_res = &top_mir_res;
 
             TRACE_FUNCTION_F(p);
-            m_of << "// PROTO extern \"" << item.m_abi << "\" " << p << "\n";
+            if( !m_options.compact )
+                m_of << "// PROTO extern \"" << item.m_abi << "\" " << p << "\n";
             if( item.m_linkage.name != "" )
             {
-                m_of << "#define " << Trans_Mangle(p) << " " << item.m_linkage.name << "\n";
+                m_of << "#define " << mangle(p) << " " << item.m_linkage.name << "\n";
             }
             if( is_extern_def )
             {
                 m_of << "static ";
             }
+            if( is_weak_def && m_compiler == Compiler::Gcc )
+            {
+                m_of << "__attribute__((weak)) ";
+            }
             emit_function_header(p, item, params);
             m_of << ";\n";
 
             m_mir_res = nullptr;
         }
-        void emit_function_code(const ::HIR::Path& p, const ::HIR::Function& item, const Trans_Params& params, bool is_extern_def, const ::MIR::FunctionPointer& code) override
+        void emit_function_code(const ::HIR::Path& p, const ::HIR::Function& item, const Trans_Params& params, bool is_extern_def, bool is_weak_def, const ::MIR::FunctionPointer& code) override
         {
             TRACE_FUNCTION_F(p);
+            // MSVC has no weak functions, use the other crate's definition (the prototype is a plain declaration)
+            if( is_weak_def && m_compiler == Compiler::Msvc )
+                return ;
 
             ::MIR::TypeResolve::args_t  arg_types;
             for(const auto& ent : item.m_args)
@@ -1844,7 +1948,8 @@ namespace {
             ::MIR::TypeResolve  mir_res { sp, m_resolve, FMT_CB(ss, ss << p;), ret_type, arg_types, *code };
             m_mir_res = &mir_res;
 
-            m_of << "// " << p << "\n";
+            if( !m_options.compact )
+                m_of << "// " << p << "\n";
             if( is_extern_def ) {
                 m_of << "static ";
             }
@@ -1856,17 +1961,25 @@ namespace {
             for(unsigned int i = 0; i < code->locals.size(); i ++) {
                 DEBUG("var" << i << " : " << code->locals[i]);
                 m_of << "\t"; emit_ctype(code->locals[i], FMT_CB(ss, ss << "var" << i;)); m_of << ";";
-                m_of << "\t// " << code->locals[i];
+                if( !m_options.compact )
+                    m_of << "\t// " << code->locals[i];
                 m_of << "\n";
             }
             for(unsigned int i = 0; i < code->drop_flags.size(); i ++) {
                 m_of << "\tbool df" << i << " = " << code->drop_flags[i] << ";\n";
             }
 
+            // Blocks that are only reached by falling through from the previous block don't need a label
             ::std::vector<unsigned> bb_use_counts( code->blocks.size() );
-            for(const auto& blk : code->blocks)
+            ::std::vector<bool> bb_needs_label( code->blocks.size() );
+            for(unsigned int i = 0; i < code->blocks.size(); i ++)
             {
-                TU_MATCHA( (blk.terminator), (te),
+                auto add_use = [&](unsigned int bb, bool can_fall_through) {
+                    bb_use_counts[bb] ++;
+                    if( !(can_fall_through && bb == i+1) )
+                        bb_needs_label[bb] = true;
+                    };
+                TU_MATCHA( (code->blocks[i].terminator), (te),
                 (Incomplete,
                     ),
                 (Return,
@@ -1874,28 +1987,35 @@ namespace {
                 (Diverge,
                     ),
                 (Goto,
-                    bb_use_counts[te] ++;
+                    add_use(te, true);
                     ),
                 (Panic,
-                    bb_use_counts[te.dst] ++;
+                    add_use(te.dst, false);
                     ),
                 (If,
-                    bb_use_counts[te.bb0] ++;
-                    bb_use_counts[te.bb1] ++;
+                    add_use(te.bb0, false);
+                    add_use(te.bb1, false);
                     ),
                 (Switch,
                     for(const auto& t : te.targets)
-                        bb_use_counts[t] ++;
+                        add_use(t, false);
                     ),
                 (SwitchValue,
                     MIR_TODO(mir_res, "SwitchValue in C codegen");
                     ),
                 (Call,
-                    bb_use_counts[te.ret_block] ++;
+                    add_use(te.ret_block, true);
                     )
                 )
             }
 
+            // Branches to blocks that only panic/abort are marked as unlikely
+            ::std::vector<bool> cold_blocks;
+            if( m_compiler == Compiler::Gcc )
+            {
+                cold_blocks = MIR_Helper_GetColdBlocks(mir_res, *code, &m_cold_callees);
+            }
+
             if( false )
             {
                 m_of << "#if 0\n";
@@ -1911,47 +2031,29 @@ namespace {
             {
                 TRACE_FUNCTION_F(p << " bb" << i);
 
+                if( bb_use_counts.at(i) == 0 && i > 0 )
+                {
+                    // Unused BB (likely part of unsupported panic path)
+                    continue ;
+                }
+
                 // HACK: Ignore any blocks that only contain `diverge;`
                 if( code->blocks[i].statements.size() == 0 && code->blocks[i].terminator.is_Diverge() ) {
                     DEBUG("- Diverge only, omitting");
-                    m_of << "bb" << i << ": _Unwind_Resume(); // Diverge\n";
+                    if( bb_needs_label[i] )
+                        m_of << "bb" << i << ":";
+                    m_of << "\t_Unwind_Resume();";
+                    if( !m_options.compact )
+                        m_of << " // Diverge";
+                    m_of << "\n";
                     continue ;
                 }
 
-                // If the previous block is a goto/function call to this
-                // block, AND this block only has a single reference, omit the
-                // label.
-                #if 1
-                if( bb_use_counts.at(i) == 0 )
-                {
-                    if( i == 0 )
-                    {
-                        // First BB, don't print label
-                    }
-                    else
-                    {
-                        // Unused BB (likely part of unsupported panic path)
-                        continue ;
-                    }
-                }
-                else if( bb_use_counts.at(i) == 1 )
-                {
-                    if( i > 0 && (TU_TEST1(code->blocks[i-1].terminator, Goto, == i) || TU_TEST1(code->blocks[i-1].terminator, Call, .ret_block == i)) )
-                    {
-                        // Don't print the label, only use is previous block
-                    }
-                    else
-                    {
-                        m_of << "bb" << i << ":\n";
-                    }
-                }
-                else
+                // Only emit a label if there's a `goto` to this block (i.e. it's not only reached by fall-through)
+                if( bb_needs_label[i] )
                 {
                     m_of << "bb" << i << ":\n";
                 }
-                #else
-                m_of << "bb" << i << ":\n";
-                #endif
 
                 for(const auto& stmt : code->blocks[i].statements)
                 {
@@ -1985,7 +2087,16 @@ namespace {
                     m_of << "\tgoto bb" << e << "; /* panic */\n";
                     ),
                 (If,
-                    m_of << "\tif("; emit_lvalue(e.cond); m_of << ") goto bb" << e.bb0 << "; else goto bb" << e.bb1 << ";\n";
+                    m_of << "\tif(";
+                    if( !cold_blocks.empty() && cold_blocks[e.bb0] != cold_blocks[e.bb1] )
+                    {
+                        m_of << "__builtin_expect("; emit_lvalue(e.cond); m_of << ", " << (cold_blocks[e.bb0] ? 0 : 1) << ")";
+                    }
+                    else
+                    {
+                        emit_lvalue(e.cond);
+                    }
+                    m_of << ") goto bb" << e.bb0 << "; else goto bb" << e.bb1 << ";\n";
                     ),
                 (Switch,
                     ::HIR::TypeRef  tmp;
@@ -1993,14 +2104,9 @@ namespace {
                     MIR_ASSERT(mir_res, ty.m_data.is_Path(), "");
                     MIR_ASSERT(mir_res, ty.m_data.as_Path().binding.is_Enum(), "");
                     const auto* enm = ty.m_data.as_Path().binding.as_Enum();
-                    auto it = m_enum_repr_cache.find( ty.m_data.as_Path().path.m_data.as_Generic() );
-                    if( it != m_enum_repr_cache.end() )
+                    if( const auto* niche_repr = get_niche_enum_repr(mir_res.sp, ty) )
                     {
-                        MIR_ASSERT(mir_res, e.targets.size() == 2, "Non-zero optimised type a variant count that isn't 2");
-                        m_of << "\tif("; emit_lvalue(e.val); emit_nonzero_path(it->second); m_of << ")\n";
-                        m_of << "\t\tgoto bb" << e.targets[1] << ";\n";
-                        m_of << "\telse\n";
-                        m_of << "\t\tgoto bb" << e.targets[0] << ";\n";
+                        emit_niche_enum_switch(*niche_repr, e.targets.size(), 1, [&](){ emit_lvalue(e.val); }, [&](size_t j){ m_of << "goto bb" << e.targets[j] << ";"; });
                     }
                     else if( enm->is_value() )
                     {
@@ -2036,7 +2142,8 @@ namespace {
                     }
                     )
                 )
-                m_of << "\t// ^ " << code->blocks[i].terminator << "\n";
+                if( !m_options.compact )
+                    m_of << "\t// ^ " << code->blocks[i].terminator << "\n";
             }
             m_of << "}\n";
             m_of.flush();
@@ -2153,7 +2260,8 @@ namespace {
             {
             case ::MIR::Statement::TAGDEAD: throw "";
             case ::MIR::Statement::TAG_ScopeEnd:
-                m_of << indent << "// " << stmt << "\n";
+                if( !m_options.compact )
+                    m_of << indent << "// " << stmt << "\n";
                 break;
             case ::MIR::Statement::TAG_SetDropFlag: {
                 const auto& e = stmt.as_SetDropFlag();
@@ -2181,7 +2289,7 @@ namespace {
                         // Emit a call to box_free for the type
                         ::HIR::GenericPath  box_free { m_crate.get_lang_item_path(sp, "box_free"), { ity->clone() } };
                         // TODO: This is specific to the official liballoc's owned_box
-                        m_of << indent << Trans_Mangle(box_free) << "("; emit_lvalue(e.slot); m_of << "._0._0._0);\n";
+                        m_of << indent << mangle(box_free) << "("; emit_lvalue(e.slot); m_of << "._0._0._0);\n";
                     }
                     else
                     {
@@ -2542,21 +2650,17 @@ namespace {
                         const auto& ty = mir_res.get_lvalue_type(tmp, e.dst);
                         const auto* enm_p = ty.m_data.as_Path().binding.as_Enum();
 
-                        auto it = m_enum_repr_cache.find(ty.m_data.as_Path().path.m_data.as_Generic());
-                        if( it != m_enum_repr_cache.end() )
+                        bool set_tag = true;
+                        if( const auto* niche_repr = get_niche_enum_repr(mir_res.sp, ty) )
                         {
-                            if( ve.variant_idx == 0 ) {
-                                // TODO: Use nonzero_path
-                                m_of << "memset(&"; emit_lvalue(e.dst); m_of << ", 0, sizeof("; emit_ctype(ty); m_of << "))";
-                            }
-                            else if( ve.variant_idx == 1 ) {
+                            is_val_enum = enm_p->m_variants.at(ve.variant_idx).second.is_Unit();
+                            // The variant with data is identified by its fields (the niche holds a valid value)
+                            set_tag = (ve.variant_idx != niche_repr->niche_variant);
+                            if( set_tag )
+                            {
                                 emit_lvalue(e.dst);
-                                m_of << "._0 = ";
-                                emit_param(ve.vals[0]);
+                                m_of << ".DATA.NICHE.v = " << niche_repr->get_niche_value(ve.variant_idx);
                             }
-                            else {
-                            }
-                            break;
                         }
                         else if( enm_p->is_value() )
                         {
@@ -2571,7 +2675,7 @@ namespace {
                             emit_lvalue(e.dst);
                             m_of << ".TAG = " << ve.variant_idx;
                         }
-                        if(ve.vals.size() > 0)
+                        if(ve.vals.size() > 0 && set_tag)
                             m_of << ";\n" << indent;
                     }
 
@@ -2607,7 +2711,8 @@ namespace {
                     )
                 )
                 m_of << ";";
-                m_of << "\t// " << e.dst << " = " << e.src;
+                if( !m_options.compact )
+                    m_of << "\t// " << e.dst << " = " << e.src;
                 m_of << "\n";
                 break; }
             }
@@ -2779,19 +2884,9 @@ namespace {
             MIR_ASSERT(mir_res, ty.m_data.as_Path().binding.is_Enum(), "Switch over non-enum");
             const auto* enm = ty.m_data.as_Path().binding.as_Enum();
 
-            auto it = m_enum_repr_cache.find( ty.m_data.as_Path().path.m_data.as_Generic() );
-            if( it != m_enum_repr_cache.end() )
+            if( const auto* niche_repr = get_niche_enum_repr(mir_res.sp, ty) )
             {
-                //MIR_ASSERT(mir_res, e.targets.size() == 2, "NonZero optimised representation for an enum without two variants");
-                MIR_ASSERT(mir_res, n_arms == 2, "NonZero optimised switch without two arms");
-                m_of << indent << "if("; emit_lvalue(val); emit_nonzero_path(it->second); m_of << ")\n";
-                m_of << indent;
-                cb(1);
-                m_of << "\n";
-                m_of << indent << "else\n";
-                m_of << indent;
-                cb(0);
-                m_of << "\n";
+                emit_niche_enum_switch(*niche_repr, n_arms, indent_level, [&](){ emit_lvalue(val); }, cb);
             }
             else if( enm->is_value() )
             {
@@ -2893,7 +2988,7 @@ namespace {
                         emit_lvalue(e.ret_val); m_of << " = ";
                     }
                 }
-                m_of << Trans_Mangle(e2);
+                m_of << mangle(e2);
                 ),
             (Intrinsic,
                 const auto& name = e.fcn.as_Intrinsic().name;
@@ -3083,13 +3178,28 @@ namespace {
         {
             ::HIR::TypeRef  tmp;
             const auto& ret_ty = monomorphise_fcn_return(tmp, item, params);
+            // Calls to diverging (panic) and `#[cold]` functions are moved out of the hot path
+            bool is_noreturn = ret_ty.m_data.is_Diverge();
+            switch(m_compiler)
+            {
+            case Compiler::Gcc:
+                if( is_noreturn )
+                    m_of << "__attribute__((cold,noreturn)) ";
+                else if( item.m_cold )
+                    m_of << "__attribute__((cold)) ";
+                break;
+            case Compiler::Msvc:
+                if( is_noreturn )
+                    m_of << "__declspec(noreturn) ";
+                break;
+            }
             emit_ctype( ret_ty, FMT_CB(ss,
                 // TODO: Cleaner ABI handling
                 if( item.m_abi == "system" && m_compiler == Compiler::Msvc )
                 {
                     ss << " __stdcall";
                 }
-                ss << " " << Trans_Mangle(p) << "(";
+                ss << " " << mangle(p) << "(";
                 if( item.m_args.size() == 0 )
                 {
                     ss << "void)";
@@ -3100,7 +3210,16 @@ namespace {
                     {
                         if( i != 0 )    m_of << ",";
                         ss << "\n\t\t";
-                        this->emit_ctype( params.monomorph(m_resolve, item.m_args[i].second), FMT_CB(os, os << "arg" << i;) );
+                        auto arg_ty = params.monomorph(m_resolve, item.m_args[i].second);
+                        if( is_noalias_ptr(arg_ty) )
+                        {
+                            const char* restrict_kw = (m_compiler == Compiler::Msvc ? "__restrict" : "restrict");
+                            this->emit_ctype( arg_ty, FMT_CB(os, os << restrict_kw << " arg" << i;) );
+                        }
+                        else
+                        {
+                            this->emit_ctype( arg_ty, FMT_CB(os, os << "arg" << i;) );
+                        }
                     }
 
                     if( item.m_variadic )
@@ -3111,6 +3230,21 @@ namespace {
                 ));
         }
 
+        /// Check if a pointer argument can be `restrict` (nothing else accesses the pointed-to data while the function runs)
+        /// - `&mut T`, and `&T` when `T` has no interior mutability (the data can't be written, so aliases don't matter)
+        bool is_noalias_ptr(const ::HIR::TypeRef& ty)
+        {
+            const auto* te = ty.m_data.opt_Borrow();
+            if( !te || te->type == ::HIR::BorrowType::Owned )
+                return false;
+            // Fat pointers are structs
+            if( metadata_type(*te->inner) != MetadataType::None )
+                return false;
+            if( te->type == ::HIR::BorrowType::Unique )
+                return true;
+            return m_resolve.type_is_freeze(sp, *te->inner);
+        }
+
         void emit_intrinsic_call(const ::std::string& name, const ::HIR::PathParams& params, const ::MIR::Terminator::Data_Call& e)
         {
             const auto& mir_res = *m_mir_res;
@@ -3246,11 +3380,23 @@ namespace {
                 }
                 };
             if( name == "size_of" ) {
-                emit_lvalue(e.ret_val); m_of << " = sizeof("; emit_ctype(params.m_types.at(0)); m_of << ")";
+                size_t  size;
+                if( Target_GetSizeOf(sp, m_resolve, params.m_types.at(0), size) ) {
+                    emit_lvalue(e.ret_val); m_of << " = " << size;
+                }
+                else {
+                    emit_lvalue(e.ret_val); m_of << " = sizeof("; emit_ctype(params.m_types.at(0)); m_of << ")";
+                }
             }
             else if( name == "min_align_of" ) {
-                //emit_lvalue(e.ret_val); m_of << " = alignof("; emit_ctype(params.m_types.at(0)); m_of << ")";
-                emit_lvalue(e.ret_val); m_of << " = ALIGNOF("; emit_ctype(params.m_types.at(0)); m_of << ")";
+                size_t  align;
+                if( Target_GetAlignOf(sp, m_resolve, params.m_types.at(0), align) ) {
+                    emit_lvalue(e.ret_val); m_of << " = " << align;
+                }
+                else {
+                    //emit_lvalue(e.ret_val); m_of << " = alignof("; emit_ctype(params.m_types.at(0)); m_of << ")";
+                    emit_lvalue(e.ret_val); m_of << " = ALIGNOF("; emit_ctype(params.m_types.at(0)); m_of << ")";
+                }
             }
             else if( name == "size_of_val" ) {
                 emit_lvalue(e.ret_val); m_of << " = ";
@@ -3356,7 +3502,7 @@ namespace {
             else if( name == "type_id" ) {
                 const auto& ty = params.m_types.at(0);
                 // NOTE: Would define the typeid here, but it has to be public
-                emit_lvalue(e.ret_val); m_of << " = (uintptr_t)&__typeid_" << Trans_Mangle(ty);
+                emit_lvalue(e.ret_val); m_of << " = (uintptr_t)&__typeid_" << mangle(ty);
             }
             else if( name == "type_name" ) {
                 auto s = FMT(params.m_types.at(0));
@@ -3500,10 +3646,17 @@ namespace {
                 const auto& ty = params.m_types.at(0);
                 emit_lvalue(e.ret_val); m_of << " = ";
                 if( ty.m_data.is_Path() && ty.m_data.as_Path().binding.is_Enum() ) {
-                    auto it = m_enum_repr_cache.find( ty.m_data.as_Path().path.m_data.as_Generic() );
-                    if( it != m_enum_repr_cache.end() )
+                    if( const auto* niche_repr = get_niche_enum_repr(mir_res.sp, ty) )
                     {
-                        emit_param(e.args.at(0)); emit_nonzero_path(it->second); m_of << " != 0";
+                        // Dataless variants by niche value, otherwise it's the variant with data
+                        const auto& enm = *ty.m_data.as_Path().binding.as_Enum();
+                        for(size_t var_idx = 0; var_idx < enm.m_variants.size(); var_idx ++)
+                        {
+                            if( var_idx == niche_repr->niche_variant )
+                                continue ;
+                            emit_param(e.args.at(0)); m_of << "->DATA.NICHE.v == " << niche_repr->get_niche_value(var_idx) << " ? " << var_idx << " : ";
+                        }
+                        m_of << niche_repr->niche_variant;
                     }
                     else
                     {
@@ -3881,12 +4034,256 @@ namespace {
             else if( name == "atomic_singlethreadfence" || name.compare(0, 7+18, "atomic_singlethreadfence_") == 0 ) {
                 // TODO: Does this matter?
             }
+            else if( name.compare(0, 5, "simd_") == 0 ) {
+                emit_simd_intrinsic_call(name, params, e);
+            }
+            else if( name.compare(0, 4, "x86_") == 0 ) {
+                emit_x86_intrinsic_call(name, e);
+            }
             else {
                 MIR_BUG(mir_res, "Unknown intrinsic '" << name << "'");
             }
             m_of << ";\n";
         }
 
+        /// Layout of a `#[repr(simd)]` type (one field per lane)
+        const TypeRepr& get_simd_repr(const ::HIR::TypeRef& ty)
+        {
+            const TypeRepr* repr = nullptr;
+            if( ty.m_data.is_Path() && ty.m_data.as_Path().binding.is_Struct() && ty.m_data.as_Path().binding.as_Struct()->m_repr == ::HIR::Struct::Repr::Simd )
+            {
+                repr = Target_GetTypeRepr(sp, m_resolve, ty);
+            }
+            MIR_ASSERT(*m_mir_res, repr, "Expected a #[repr(simd)] type, got " << ty);
+            return *repr;
+        }
+        /// `simd_*` (platform-intrinsic) - Lowered to GCC vector operations on the `.v` member of the SIMD types
+        void emit_simd_intrinsic_call(const ::std::string& name, const ::HIR::PathParams& params, const ::MIR::Terminator::Data_Call& e)
+        {
+            const auto& mir_res = *m_mir_res;
+            if( m_compiler != Compiler::Gcc )
+                MIR_TODO(mir_res, "SIMD intrinsic '" << name << "' without GCC vector extensions");
+            auto emit_vec = [&](const ::MIR::Param& p) {
+                emit_param(p); m_of << ".v";
+                };
+            static const ::std::pair<const char*, const char*> BIN_OPS[] = {
+                { "simd_add", "+" }, { "simd_sub", "-" }, { "simd_mul", "*" }, { "simd_div", "/" }, { "simd_rem", "%" },
+                { "simd_shl", "<<" }, { "simd_shr", ">>" }, { "simd_and", "&" }, { "simd_or", "|" }, { "simd_xor", "^" },
+                };
+            // Comparisons produce a mask vector (all bits set for true lanes), converted to the requested lane type
+            static const ::std::pair<const char*, const char*> CMP_OPS[] = {
+                { "simd_eq", "==" }, { "simd_ne", "!=" }, { "simd_lt", "<" }, { "simd_le", "<=" }, { "simd_gt", ">" }, { "simd_ge", ">=" },
+                };
+            for(const auto& op : BIN_OPS)
+            {
+                if( name == op.first ) {
+                    emit_lvalue(e.ret_val); m_of << ".v = "; emit_vec(e.args.at(0)); m_of << " " << op.second << " "; emit_vec(e.args.at(1));
+                    return ;
+                }
+            }
+            for(const auto& op : CMP_OPS)
+            {
+                if( name == op.first ) {
+                    emit_lvalue(e.ret_val); m_of << ".v = (__typeof__("; emit_lvalue(e.ret_val); m_of << ".v))(";
+                    emit_vec(e.args.at(0)); m_of << " " << op.second << " "; emit_vec(e.args.at(1));
+                    m_of << ")";
+                    return ;
+                }
+            }
+            if( name == "simd_extract" ) {
+                emit_lvalue(e.ret_val); m_of << " = "; emit_vec(e.args.at(0)); m_of << "["; emit_param(e.args.at(1)); m_of << "]";
+            }
+            else if( name == "simd_insert" ) {
+                emit_lvalue(e.ret_val); m_of << " = "; emit_param(e.args.at(0)); m_of << "; ";
+                emit_lvalue(e.ret_val); m_of << ".v["; emit_param(e.args.at(1)); m_of << "] = "; emit_param(e.args.at(2));
+            }
+            else if( name == "simd_cast" ) {
+                emit_lvalue(e.ret_val); m_of << ".v = __builtin_convertvector("; emit_vec(e.args.at(0)); m_of << ", __typeof__("; emit_lvalue(e.ret_val); m_of << ".v))";
+            }
+            else if( name.compare(0, 12, "simd_shuffle") == 0 ) {
+                // `simd_shuffleN(a, b, [u32; N])` - Indexes into the concatenation of `a` and `b`
+                const auto& in_repr = get_simd_repr(params.m_types.at(0));
+                size_t n_lanes = ::std::stoul(name.substr(12));
+                if( n_lanes != in_repr.fields.size() )
+                    MIR_TODO(mir_res, name << " with a different lane count to the input - " << params.m_types.at(0));
+                // - The indexes are either an array variable, or a named constant (emitted as its values)
+                const ::HIR::Literal*   idx_lit = nullptr;
+                if( const auto* c = e.args.at(2).opt_Constant() )
+                {
+                    MIR_ASSERT(mir_res, c->is_Const(), name << " indexes must be an array - " << *c);
+                    ::HIR::TypeRef  tmp;
+                    idx_lit = &get_literal_for_const(c->as_Const().p, tmp);
+                    MIR_ASSERT(mir_res, idx_lit->is_List() && idx_lit->as_List().size() == n_lanes, name << " indexes must be " << n_lanes << " integers - " << *idx_lit);
+                }
+                size_t lane_size = in_repr.size / n_lanes;
+                m_of << "{ int" << lane_size * 8 << "_t __attribute__((vector_size(" << in_repr.size << "))) mask = {";
+                for(size_t i = 0; i < n_lanes; i ++)
+                {
+                    if( i != 0 )    m_of << ",";
+                    m_of << " ";
+                    if( idx_lit )
+                    {
+                        const auto& v = idx_lit->as_List()[i];
+                        MIR_ASSERT(mir_res, v.is_Integer(), name << " index " << i << " isn't an integer - " << v);
+                        m_of << v.as_Integer();
+                    }
+                    else
+                    {
+                        emit_param(e.args.at(2)); m_of << ".DATA[" << i << "]";
+                    }
+                }
+                m_of << " }; ";
+                emit_lvalue(e.ret_val); m_of << ".v = __builtin_shuffle("; emit_vec(e.args.at(0)); m_of << ", "; emit_vec(e.args.at(1)); m_of << ", mask); }";
+            }
+            else {
+                MIR_TODO(mir_res, "Unsupported SIMD intrinsic '" << name << "'");
+            }
+        }
+        /// `x86_*` (platform-intrinsic) - Calls the matching `<immintrin.h>` function (e.g. `x86_mm_movemask_epi8` is `_mm_movemask_epi8`)
+        /// - SIMD arguments and return values are converted to/from the Intel vector type of the same size
+        /// - 256/512-bit intrinsics need AVX/AVX2/AVX-512 enabled (`--target-feature`), otherwise lane-wise operations are
+        ///   lowered to GCC vector operations (see `emit_x86_intrinsic_fallback`)
+        void emit_x86_intrinsic_call(const ::std::string& name, const ::MIR::Terminator::Data_Call& e)
+        {
+            const auto& mir_res = *m_mir_res;
+            const auto& arch = Target_GetCurSpec().m_arch.m_name;
+            if( m_compiler != Compiler::Gcc || (arch != "x86" && arch != "x86_64") )
+                MIR_TODO(mir_res, "x86 intrinsic '" << name << "' on " << arch);
+
+            // The vector width is part of the name (`_mm_`, `_mm256_`, `_mm512_`), and the lane type is the suffix
+            auto c_name = name.substr(3);
+            bool is_float = c_name.size() > 3 && (c_name.compare(c_name.size() - 3, 3, "_ps") == 0 || c_name.compare(c_name.size() - 3, 3, "_pd") == 0);
+            // - Each level implies the ones before it
+            static const char* AVX_LEVELS[] = { "avx", "avx2", "avx512f" };
+            int required_level = -1;
+            if( c_name.compare(0, 7, "_mm512_") == 0 )
+                required_level = 2;
+            else if( c_name.compare(0, 7, "_mm256_") == 0 )
+                required_level = is_float ? 0 : 1;
+            if( required_level >= 0 )
+            {
+                bool enabled = false;
+                for(int i = required_level; i < 3; i ++)
+                    enabled |= Target_HasFeature(AVX_LEVELS[i]);
+                if( !enabled )
+                {
+                    if( !emit_x86_intrinsic_fallback(c_name, e) )
+                        ERROR(mir_res.sp, E0000, mir_res << "x86 intrinsic `" << name << "` requires the `" << AVX_LEVELS[required_level] << "` target feature"
+                            << " (enable with `--target-feature +" << AVX_LEVELS[required_level] << "`)");
+                    return ;
+                }
+            }
+
+            auto is_simd = [](const ::HIR::TypeRef& ty) {
+                return ty.m_data.is_Path() && ty.m_data.as_Path().binding.is_Struct() && ty.m_data.as_Path().binding.as_Struct()->m_repr == ::HIR::Struct::Repr::Simd;
+                };
+            auto intel_type = [&](const ::HIR::TypeRef& ty)->::std::string {
+                const auto& repr = get_simd_repr(ty);
+                if( repr.size != 16 && repr.size != 32 && repr.size != 64 )
+                    MIR_TODO(mir_res, "x86 intrinsic '" << name << "' with a " << repr.size << " byte vector");
+                const char* suffix = "i";
+                if( repr.fields[0].ty == ::HIR::CoreType::F32 )
+                    suffix = "";
+                else if( repr.fields[0].ty == ::HIR::CoreType::F64 )
+                    suffix = "d";
+                return FMT("__m" << repr.size * 8 << suffix);
+                };
+
+            ::HIR::TypeRef  tmp;
+            const auto& ret_ty = mir_res.get_lvalue_type(tmp, e.ret_val);
+            if( is_simd(ret_ty) ) {
+                emit_lvalue(e.ret_val); m_of << ".v = (__typeof__("; emit_lvalue(e.ret_val); m_of << ".v))";
+            }
+            else if( ret_ty.m_data.is_Tuple() && ret_ty.m_data.as_Tuple().empty() ) {
+                // `void` function
+            }
+            else {
+                emit_lvalue(e.ret_val); m_of << " = ";
+            }
+            m_of << c_name << "(";
+            for(size_t i = 0; i < e.args.size(); i ++)
+            {
+                if( i != 0 )    m_of << ", ";
+                ::HIR::TypeRef  tmp_a;
+                const auto& ty = mir_res.get_param_type(tmp_a, e.args[i]);
+                if( is_simd(ty) ) {
+                    m_of << "(" << intel_type(ty) << ")"; emit_param(e.args[i]); m_of << ".v";
+                }
+                else {
+                    emit_param(e.args[i]);
+                }
+            }
+            m_of << ")";
+        }
+
+        /// Lowers a lane-wise `x86_*` intrinsic (add/sub/and/or/xor/cmpeq/cmpgt/min/max) to GCC vector operations
+        /// - Used when the instruction set isn't enabled, GCC then splits the operation into ones the target supports
+        /// - Returns false if the intrinsic isn't lane-wise
+        bool emit_x86_intrinsic_fallback(const ::std::string& c_name, const ::MIR::Terminator::Data_Call& e)
+        {
+            const auto& mir_res = *m_mir_res;
+            // `_mm256_<op>_<lanes>`
+            auto op_start = c_name.find('_', 1) + 1;
+            auto op_end = c_name.rfind('_');
+            if( op_end <= op_start )
+                return false;
+            auto op_name = c_name.substr(op_start, op_end - op_start);
+            auto lanes = c_name.substr(op_end + 1);
+
+            // Lane type, and the signed integer of the same size (the result of a comparison)
+            struct LaneType { const char* suffix; const char* ty; const char* mask_ty; };
+            static const LaneType LANE_TYPES[] = {
+                { "epi8", "int8_t", "int8_t" }, { "epi16", "int16_t", "int16_t" }, { "epi32", "int32_t", "int32_t" }, { "epi64", "int64_t", "int64_t" },
+                { "epu8", "uint8_t", "int8_t" }, { "epu16", "uint16_t", "int16_t" }, { "epu32", "uint32_t", "int32_t" }, { "epu64", "uint64_t", "int64_t" },
+                { "si256", "int64_t", "int64_t" }, { "si512", "int64_t", "int64_t" }, { "ps", "float", "int32_t" }, { "pd", "double", "int64_t" },
+                };
+            static const ::std::pair<const char*, const char*> OPS[] = {
+                { "add", "+" }, { "sub", "-" }, { "and", "&" }, { "or", "|" }, { "xor", "^" },
+                { "cmpeq", "==" }, { "cmpgt", ">" }, { "min", "<" }, { "max", ">" },
+                };
+            const LaneType* lane_ty = nullptr;
+            for(const auto& lt : LANE_TYPES)
+                if( lanes == lt.suffix )
+                    lane_ty = &lt;
+            const char* op = nullptr;
+            for(const auto& o : OPS)
+                if( op_name == o.first )
+                    op = o.second;
+            if( !lane_ty || !op || e.args.size() != 2 )
+                return false;
+
+            // All operands are SIMD types of the same size
+            ::HIR::TypeRef  tmp;
+            const auto& ret_ty = mir_res.get_lvalue_type(tmp, e.ret_val);
+            if( !ret_ty.m_data.is_Path() || !ret_ty.m_data.as_Path().binding.is_Struct() || ret_ty.m_data.as_Path().binding.as_Struct()->m_repr != ::HIR::Struct::Repr::Simd )
+                return false;
+            size_t size = get_simd_repr(ret_ty).size;
+            for(const auto& a : e.args)
+            {
+                ::HIR::TypeRef  tmp_a;
+                const auto& ty = mir_res.get_param_type(tmp_a, a);
+                if( !ty.m_data.is_Path() || !ty.m_data.as_Path().binding.is_Struct() || ty.m_data.as_Path().binding.as_Struct()->m_repr != ::HIR::Struct::Repr::Simd )
+                    return false;
+                if( get_simd_repr(ty).size != size )
+                    return false;
+            }
+
+            // Bitwise operations aren't defined on floating point vectors, and don't depend on the lane size
+            const char* ty = (op_name == "and" || op_name == "or" || op_name == "xor") ? lane_ty->mask_ty : lane_ty->ty;
+            m_of << "{ typedef " << ty << " V __attribute__((vector_size(" << size << ")));"
+                << " typedef " << lane_ty->mask_ty << " M __attribute__((vector_size(" << size << ")));";
+            m_of << " V a = (V)"; emit_param(e.args[0]); m_of << ".v, b = (V)"; emit_param(e.args[1]); m_of << ".v; ";
+            emit_lvalue(e.ret_val); m_of << ".v = (__typeof__("; emit_lvalue(e.ret_val); m_of << ".v))";
+            if( op_name == "min" || op_name == "max" ) {
+                m_of << "({ M m = (a " << op << " b); ((M)a & m) | ((M)b & ~m); })";
+            }
+            else {
+                m_of << "(a " << op << " b)";
+            }
+            m_of << "; }";
+            return true;
+        }
+
         void emit_destructor_call(const ::MIR::LValue& slot, const ::HIR::TypeRef& ty, bool unsized_valid, unsigned indent_level)
         {
             auto indent = RepeatLitStr { "\t", static_cast<int>(indent_level) };
@@ -3921,13 +4318,13 @@ namespace {
                 switch( metadata_type(ty) )
                 {
                 case MetadataType::None:
-                    m_of << indent << Trans_Mangle(p) << "(&"; emit_lvalue(slot); m_of << ");\n";
+                    m_of << indent << mangle(p) << "(&"; emit_lvalue(slot); m_of << ");\n";
                     break;
                 case MetadataType::Slice:
                     make_fcn = "make_sliceptr"; if(0)
                 case MetadataType::TraitObject:
                     make_fcn = "make_traitobjptr";
-                    m_of << indent << Trans_Mangle(p) << "( " << make_fcn << "(";
+                    m_of << indent << mangle(p) << "( " << make_fcn << "(";
                     if( slot.is_Deref() )
                     {
                         emit_lvalue(*slot.as_Deref().val);
@@ -4103,15 +4500,16 @@ namespace {
                 MIR_ASSERT(*m_mir_res, ty.m_data.is_Path(), "");
                 MIR_ASSERT(*m_mir_res, ty.m_data.as_Path().binding.is_Enum(), "");
                 const auto& enm = *ty.m_data.as_Path().binding.as_Enum();
-                auto it = m_enum_repr_cache.find(ty.m_data.as_Path().path.m_data.as_Generic());
-                if( it != m_enum_repr_cache.end() )
+                if( const auto* niche_repr = get_niche_enum_repr(m_mir_res->sp, ty) )
                 {
-                    if( e.idx == 0 ) {
-                        emit_nonzero_path(it->second);
-                        m_of << " = 0";
+                    if( e.idx != niche_repr->niche_variant ) {
+                        emit_dst(); m_of << ".DATA.NICHE.v = " << niche_repr->get_niche_value(e.idx);
                     }
                     else {
-                        assign_from_literal([&](){ emit_dst(); m_of << "._0"; }, get_inner_type(e.idx, 0), e.vals[0]);
+                        for(unsigned int i = 0; i < e.vals.size(); i ++) {
+                            if(i != 0)  m_of << ";\n\t";
+                            assign_from_literal([&](){ emit_dst(); m_of << ".DATA.var_" << e.idx << "._" << i; }, get_inner_type(e.idx, i), e.vals[i]);
+                        }
                     }
                 }
                 else if( enm.is_value() )
@@ -4139,7 +4537,7 @@ namespace {
             (BorrowPath,
                 if( ty.m_data.is_Function() )
                 {
-                    emit_dst(); m_of << " = " << Trans_Mangle(e);
+                    emit_dst(); m_of << " = " << mangle(e);
                 }
                 else if( ty.m_data.is_Borrow() )
                 {
@@ -4147,12 +4545,12 @@ namespace {
                     switch( metadata_type(ity) )
                     {
                     case MetadataType::None:
-                        emit_dst(); m_of << " = &" << Trans_Mangle(e);
+                        emit_dst(); m_of << " = &" << mangle(e);
                         break;
                     case MetadataType::Slice:
-                        emit_dst(); m_of << ".PTR = &" << Trans_Mangle(e) << ";\n\t";
+                        emit_dst(); m_of << ".PTR = &" << mangle(e) << ";\n\t";
                         // HACK: Since getting the size is hard, use two sizeofs
-                        emit_dst(); m_of << ".META = sizeof(" << Trans_Mangle(e) << ") / ";
+                        emit_dst(); m_of << ".META = sizeof(" << mangle(e) << ") / ";
                         if( ity.m_data.is_Slice() ) {
                             m_of << "sizeof("; emit_ctype(*ity.m_data.as_Slice().inner); m_of << ")";
                         }
@@ -4161,14 +4559,14 @@ namespace {
                         }
                         break;
                     case MetadataType::TraitObject:
-                        emit_dst(); m_of << ".PTR = &" << Trans_Mangle(e) << ";\n\t";
+                        emit_dst(); m_of << ".PTR = &" << mangle(e) << ";\n\t";
                         emit_dst(); m_of << ".META = /* TODO: Const VTable */";
                         break;
                     }
                 }
                 else
                 {
-                    emit_dst(); m_of << " = &" << Trans_Mangle(e);
+                    emit_dst(); m_of << " = &" << mangle(e);
                 }
                 ),
             (BorrowData,
@@ -4209,7 +4607,7 @@ namespace {
                     m_of << "var" << e;
                 ),
             (Static,
-                m_of << Trans_Mangle(e);
+                m_of << mangle(e);
                 ),
             (Field,
                 ::HIR::TypeRef  tmp;
@@ -4299,18 +4697,8 @@ namespace {
                 MIR_ASSERT(*m_mir_res, ty.m_data.is_Path(), "Downcast on non-Path type - " << ty);
                 if( ty.m_data.as_Path().binding.is_Enum() )
                 {
-                    auto it = m_enum_repr_cache.find(ty.m_data.as_Path().path.m_data.as_Generic());
-                    if( it != m_enum_repr_cache.end() )
-                    {
-                        MIR_ASSERT(*m_mir_res, e.variant_index == 1, "");
-                        // NOTE: Downcast returns a magic tuple
-                        //m_of << "._0";
-                        break ;
-                    }
-                    else
-                    {
-                        m_of << ".DATA";
-                    }
+                    // NOTE: Niche-filled enums store the variants in `DATA` too
+                    m_of << ".DATA";
                 }
                 m_of << ".var_" << e.variant_index;
                 )
@@ -4469,7 +4857,7 @@ namespace {
                     m_of << "&";
                     )
                 )
-                m_of << Trans_Mangle(c);
+                m_of << mangle(c);
                 )
             )
         }
@@ -4487,53 +4875,60 @@ namespace {
             emit_ctype(ty, FMT_CB(_,));
         }
         void emit_ctype(const ::HIR::TypeRef& ty, ::FmtLambda inner, bool is_extern_c=false) {
+            m_of << get_ctype(ty) << inner;
+        }
+        /// C spelling of a type, the declarator (if any) directly follows it
+        /// - Cached, the same types are used for many locals/arguments/casts
+        const ::std::string& get_ctype(const ::HIR::TypeRef& ty)
+        {
+            auto it = m_ctype_cache.find(ty);
+            if( it != m_ctype_cache.end() )
+                return it->second;
+
+            ::std::string   rv;
             TU_MATCHA( (ty.m_data), (te),
             (Infer,
-                m_of << "@" << ty << "@" << inner;
+                rv = FMT("@" << ty << "@");
                 ),
             (Diverge,
-                m_of << "tBANG " << inner;
+                rv = "tBANG ";
                 ),
             (Primitive,
                 switch(te)
                 {
-                case ::HIR::CoreType::Usize:    m_of << "uintptr_t";   break;
-                case ::HIR::CoreType::Isize:    m_of << "intptr_t";  break;
-                case ::HIR::CoreType::U8:  m_of << "uint8_t"; break;
-                case ::HIR::CoreType::I8:  m_of << "int8_t"; break;
-                case ::HIR::CoreType::U16: m_of << "uint16_t"; break;
-                case ::HIR::CoreType::I16: m_of << "int16_t"; break;
-                case ::HIR::CoreType::U32: m_of << "uint32_t"; break;
-                case ::HIR::CoreType::I32: m_of << "int32_t"; break;
-                case ::HIR::CoreType::U64: m_of << "uint64_t"; break;
-                case ::HIR::CoreType::I64: m_of << "int64_t"; break;
-                case ::HIR::CoreType::U128: m_of << "uint128_t"; break;
-                case ::HIR::CoreType::I128: m_of << "int128_t"; break;
-
-                case ::HIR::CoreType::F32: m_of << "float"; break;
-                case ::HIR::CoreType::F64: m_of << "double"; break;
-
-                case ::HIR::CoreType::Bool: m_of << "bool"; break;
-                case ::HIR::CoreType::Char: m_of << "RUST_CHAR";  break;
+                case ::HIR::CoreType::Usize:    rv = "uintptr_t";   break;
+                case ::HIR::CoreType::Isize:    rv = "intptr_t";  break;
+                case ::HIR::CoreType::U8:  rv = "uint8_t"; break;
+                case ::HIR::CoreType::I8:  rv = "int8_t"; break;
+                case ::HIR::CoreType::U16: rv = "uint16_t"; break;
+                case ::HIR::CoreType::I16: rv = "int16_t"; break;
+                case ::HIR::CoreType::U32: rv = "uint32_t"; break;
+                case ::HIR::CoreType::I32: rv = "int32_t"; break;
+                case ::HIR::CoreType::U64: rv = "uint64_t"; break;
+                case ::HIR::CoreType::I64: rv = "int64_t"; break;
+                case ::HIR::CoreType::U128: rv = "uint128_t"; break;
+                case ::HIR::CoreType::I128: rv = "int128_t"; break;
+
+                case ::HIR::CoreType::F32: rv = "float"; break;
+                case ::HIR::CoreType::F64: rv = "double"; break;
+
+                case ::HIR::CoreType::Bool: rv = "bool"; break;
+                case ::HIR::CoreType::Char: rv = "RUST_CHAR";  break;
                 case ::HIR::CoreType::Str:
                     MIR_BUG(*m_mir_res, "Raw str");
                 }
-                m_of << " " << inner;
+                rv += " ";
                 ),
             (Path,
-                //if( const auto* ity = m_resolve.is_type_owned_box(ty) ) {
-                //    emit_ctype_ptr(*ity, inner);
-                //    return ;
-                //}
                 TU_MATCHA( (te.binding), (tpb),
                 (Struct,
-                    m_of << "struct s_" << Trans_Mangle(te.path);
+                    rv = "struct s_" + mangle(te.path);
                     ),
                 (Union,
-                    m_of << "union u_" << Trans_Mangle(te.path);
+                    rv = "union u_" + mangle(te.path);
                     ),
                 (Enum,
-                    m_of << "struct e_" << Trans_Mangle(te.path);
+                    rv = "struct e_" + mangle(te.path);
                     ),
                 (Unbound,
                     MIR_BUG(*m_mir_res, "Unbound type path in trans - " << ty);
@@ -4542,7 +4937,7 @@ namespace {
                     MIR_BUG(*m_mir_res, "Opaque path in trans - " << ty);
                     )
                 )
-                m_of << " " << inner;
+                rv += " ";
                 ),
             (Generic,
                 MIR_BUG(*m_mir_res, "Generic in trans - " << ty);
@@ -4554,36 +4949,48 @@ namespace {
                 MIR_BUG(*m_mir_res, "ErasedType in trans - " << ty);
                 ),
             (Array,
-                m_of << "t_" << Trans_Mangle(ty) << " " << inner;
-                //emit_ctype(*te.inner, inner);
-                //m_of << "[" << te.size_val << "]";
+                rv = "t_" + mangle(ty) + " ";
                 ),
             (Slice,
                 MIR_BUG(*m_mir_res, "Raw slice object - " << ty);
                 ),
             (Tuple,
                 if( te.size() == 0 )
-                    m_of << "tUNIT";
+                    rv = "tUNIT";
                 else {
-                    m_of << "TUP_" << te.size();
+                    rv = FMT("TUP_" << te.size());
                     for(const auto& t : te)
-                        m_of << "_" << Trans_Mangle(t);
+                        rv += "_" + mangle(t);
                 }
-                m_of << " " << inner;
+                rv += " ";
                 ),
             (Borrow,
-                emit_ctype_ptr(*te.inner, inner);
+                rv = get_ctype_ptr(*te.inner);
                 ),
             (Pointer,
-                emit_ctype_ptr(*te.inner, inner);
+                rv = get_ctype_ptr(*te.inner);
                 ),
             (Function,
-                m_of << "t_" << Trans_Mangle(ty) << " " << inner;
+                rv = "t_" + mangle(ty) + " ";
                 ),
             (Closure,
                 MIR_BUG(*m_mir_res, "Closure during trans - " << ty);
                 )
             )
+            return m_ctype_cache.insert(::std::make_pair( ty.clone(), mv$(rv) )).first->second;
+        }
+        ::std::string get_ctype_ptr(const ::HIR::TypeRef& inner_ty)
+        {
+            switch( metadata_type(inner_ty) )
+            {
+            case MetadataType::None:
+                return get_ctype(inner_ty) + "*";
+            case MetadataType::Slice:
+                return "SLICE_PTR ";
+            case MetadataType::TraitObject:
+                return "TRAITOBJ_PTR ";
+            }
+            throw "";
         }
 
         ::HIR::TypeRef get_inner_unsized_type(const ::HIR::TypeRef& ty)
@@ -4698,25 +5105,25 @@ namespace {
             }
         }
 
-        void emit_ctype_ptr(const ::HIR::TypeRef& inner_ty, ::FmtLambda inner) {
-            //if( inner_ty.m_data.is_Array() ) {
-            //    emit_ctype(inner_ty, FMT_CB(ss, ss << "(*" << inner << ")";));
-            //}
-            //else
+        /// Cached `Trans_Mangle`
+        template<typename K>
+        const ::std::string& mangle_cached(::std::unordered_map<K, ::std::string, Trans_KeyHash, Trans_KeyEq>& cache, const K& key)
+        {
+            auto it = cache.find(key);
+            if( it == cache.end() )
             {
-                switch( metadata_type(inner_ty) )
-                {
-                case MetadataType::None:
-                    emit_ctype(inner_ty, FMT_CB(ss, ss << "*" << inner;));
-                    break;
-                case MetadataType::Slice:
-                    m_of << "SLICE_PTR " << inner;
-                    break;
-                case MetadataType::TraitObject:
-                    m_of << "TRAITOBJ_PTR " << inner;
-                    break;
-                }
+                it = cache.insert(::std::make_pair( key.clone(), FMT(Trans_Mangle(key)) )).first;
             }
+            return it->second;
+        }
+        const ::std::string& mangle(const ::HIR::Path& p) {
+            return mangle_cached(m_mangled_paths, p);
+        }
+        const ::std::string& mangle(const ::HIR::GenericPath& p) {
+            return mangle_cached(m_mangled_gpaths, p);
+        }
+        const ::std::string& mangle(const ::HIR::TypeRef& ty) {
+            return mangle_cached(m_mangled_types, ty);
         }
 
         bool is_dst(const ::HIR::TypeRef& ty) const
@@ -4727,7 +5134,7 @@ namespace {
     Span CodeGenerator_C::sp;
 }
 
-::std::unique_ptr<CodeGenerator> Trans_Codegen_GetGeneratorC(const ::HIR::Crate& crate, const ::std::string& outfile)
+::std::unique_ptr<CodeGenerator> Trans_Codegen_GetGeneratorC(const ::HIR::Crate& crate, const ::std::string& outfile, const TransOptions& opt)
 {
-    return ::std::unique_ptr<CodeGenerator>(new CodeGenerator_C(crate, outfile));
+    return ::std::unique_ptr<CodeGenerator>(new CodeGenerator_C(crate, outfile, opt));
 }
@@ -15,6 +15,7 @@
 #include <hir_typeck/static.hpp>    // StaticTraitResolve
 #include <hir/item_path.hpp>
 #include <deque>
+#include <unordered_set>
 #include <algorithm>
 
 namespace {
@@ -22,14 +23,68 @@ namespace {
     {
         const ::HIR::Crate& crate;
         TransList   rv;
+        /// Generate code for every function with MIR (instead of using the library objects)
+        bool    whole_program;
+        /// Enumerating for an executable (the only place that defines the items exported from MIR-only libraries)
+        bool    is_executable;
 
         // Queue of items to enumerate
         ::std::deque<TransList_Function*>  fcn_queue;
         ::std::vector<TransList_Function*> fcns_to_type_visit;
 
-        EnumState(const ::HIR::Crate& crate):
-            crate(crate)
-        {}
+        /// Functions from MIR-only libraries (which have no object file)
+        ::std::unordered_set<const ::HIR::Function*>    mir_only_fcns;
+
+        EnumState(const ::HIR::Crate& crate, bool is_executable, bool whole_program=false):
+            crate(crate),
+            whole_program(whole_program),
+            is_executable(is_executable)
+        {
+            for(const auto& ext : crate.m_ext_crates)
+            {
+                const auto& ext_crate = *ext.second.m_data;
+                if( !ext_crate.m_is_mir_only )
+                    continue ;
+                add_mir_only_fcns(ext_crate.m_root_module);
+                for(const auto& impl : ext_crate.m_trait_impls)
+                    for(const auto& m : impl.second.m_methods)
+                        mir_only_fcns.insert(&m.second.data);
+                for(const auto& impl : ext_crate.m_type_impls)
+                    for(const auto& m : impl.m_methods)
+                        mir_only_fcns.insert(&m.second.data);
+            }
+        }
+        void add_mir_only_fcns(const ::HIR::Module& mod)
+        {
+            for(const auto& vi : mod.m_value_items)
+                if( const auto* e = vi.second->ent.opt_Function() )
+                    mir_only_fcns.insert(e);
+            for(const auto& ti : mod.m_mod_items)
+                if( const auto* e = ti.second->ent.opt_Module() )
+                    add_mir_only_fcns(*e);
+        }
+
+        /// Determine if code for a function is generated here (instead of being linked from another crate's object)
+        bool needs_code(const ::HIR::Function& fcn, const Trans_Params& pp) const
+        {
+            if( !fcn.m_code.m_mir )
+                return false;
+            // Defined in this crate
+            if( fcn.m_code.has_body() )
+                return true;
+            if( whole_program )
+                return true;
+            // Monomorphised generics (and trait provided methods) only exist where they're used
+            if( pp.has_types() )
+                return true;
+            // MIR-only libraries: Symbols exported by name are only defined by the executable (libraries refer to them)
+            if( mir_only_fcns.count(&fcn) > 0 )
+                return is_executable || fcn.m_linkage.name == "";
+            // `#[inline]` functions get a local copy (so they can be inlined by the C compiler), unless the symbol name is fixed
+            if( fcn.m_inline != ::HIR::Function::InlineHint::Default && fcn.m_inline != ::HIR::Function::InlineHint::Never && fcn.m_linkage.name == "" )
+                return true;
+            return false;
+        }
 
         void enum_fcn(::HIR::Path p, const ::HIR::Function& fcn, Trans_Params pp)
         {
@@ -37,6 +92,7 @@ namespace {
             {
                 fcns_to_type_visit.push_back(e);
                 e->ptr = &fcn;
+                e->emit_code = needs_code(fcn, pp);
                 e->pp = mv$(pp);
                 fcn_queue.push_back(e);
             }
@@ -45,20 +101,57 @@ namespace {
 }
 
 TransList Trans_Enumerate_CommonPost(EnumState& state);
+void Trans_Enumerate_ReportCounts(const TransList& list);
 void Trans_Enumerate_Types(EnumState& state);
 void Trans_Enumerate_FillFrom_Path(EnumState& state, const ::HIR::Path& path, const Trans_Params& pp);
-void Trans_Enumerate_FillFrom(EnumState& state, const ::HIR::Function& function, const Trans_Params& pp);
+void Trans_Enumerate_FillFrom(EnumState& state, const TransList_Function& fcn_out);
+void Trans_Enumerate_SaveCode(::HIR::Crate& crate, bool all);
 void Trans_Enumerate_FillFrom(EnumState& state, const ::HIR::Static& stat, TransList_Static& stat_out, Trans_Params pp={});
 void Trans_Enumerate_FillFrom_VTable (EnumState& state, ::HIR::Path vtable_path, const Trans_Params& pp);
 void Trans_Enumerate_FillFrom_Literal(EnumState& state, const ::HIR::Literal& lit, const Trans_Params& pp);
 void Trans_Enumerate_FillFrom_MIR(EnumState& state, const ::MIR::Function& code, const Trans_Params& pp);
 
+namespace {
+    /// Enumerate items that only the executable defines for a MIR-only library
+    /// - Functions exported by symbol name (`#[no_mangle]`/`#[export_name]`)
+    /// - All statics (so there's only one copy, libraries using them only declare them)
+    void Trans_Enumerate_Exported_Mod(EnumState& state, const ::HIR::Module& mod, ::HIR::SimplePath mod_path)
+    {
+        for(const auto& vi : mod.m_value_items)
+        {
+            if( const auto* e = vi.second->ent.opt_Function() )
+            {
+                if( e->m_linkage.name != "" && e->m_code.m_mir && e->m_params.m_types.size() == 0 )
+                {
+                    state.enum_fcn(mod_path + vi.first, *e, {});
+                }
+            }
+            else if( const auto* e = vi.second->ent.opt_Static() )
+            {
+                if( !e->m_value_res.is_Invalid() && !e->m_type.m_data.is_Infer() )
+                {
+                    if( auto* ptr = state.rv.add_static(mod_path + vi.first) )
+                        Trans_Enumerate_FillFrom(state, *e, *ptr);
+                }
+            }
+        }
+        for(const auto& ti : mod.m_mod_items)
+        {
+            if( const auto* e = ti.second->ent.opt_Module() )
+            {
+                Trans_Enumerate_Exported_Mod(state, *e, mod_path + ti.first);
+            }
+        }
+    }
+}
+
 /// Enumerate trans items starting from `::main` (binary crate)
-TransList Trans_Enumerate_Main(const ::HIR::Crate& crate)
+/// - `whole_program`: Code for every function used is generated from MIR (the libraries' objects only provide statics)
+TransList Trans_Enumerate_Main(const ::HIR::Crate& crate, bool whole_program)
 {
     static Span sp;
 
-    EnumState   state { crate };
+    EnumState   state { crate, true, whole_program };
 
     auto c_start_path = crate.get_lang_item_path_opt("mrustc-start");
     if( c_start_path == ::HIR::SimplePath() )
@@ -87,7 +180,18 @@ TransList Trans_Enumerate_Main(const ::HIR::Crate& crate)
         state.enum_fcn( c_start_path, fcn, {} );
     }
 
-    return Trans_Enumerate_CommonPost(state);
+    // MIR-only libraries have no object file, so their exported functions and statics have to be generated here
+    for(const auto& ext : crate.m_ext_crates)
+    {
+        if( ext.second.m_data->m_is_mir_only )
+        {
+            Trans_Enumerate_Exported_Mod(state, ext.second.m_data->m_root_module, ::HIR::SimplePath(ext.first, {}));
+        }
+    }
+
+    auto rv = Trans_Enumerate_CommonPost(state);
+    Trans_Enumerate_ReportCounts(rv);
+    return rv;
 }
 
 namespace {
@@ -151,10 +255,11 @@ namespace {
 }
 
 /// Enumerate trans items for all public non-generic items (library crate)
-TransList Trans_Enumerate_Public(::HIR::Crate& crate)
+/// - `save_all_code`: Save MIR for every function (so `--whole-program` executables can generate code for them)
+TransList Trans_Enumerate_Public(::HIR::Crate& crate, bool save_all_code)
 {
     static Span sp;
-    EnumState   state { crate };
+    EnumState   state { crate, false };
 
     Trans_Enumerate_Public_Mod(state, crate.m_root_module,  ::HIR::SimplePath(crate.m_crate_name,{}), true);
 
@@ -254,6 +359,8 @@ TransList Trans_Enumerate_Public(::HIR::Crate& crate)
             }
         }
     }
+    // `#[inline]` functions are saved so users can emit a local copy (and everything if requested)
+    Trans_Enumerate_SaveCode(crate, save_all_code);
 
     auto rv = Trans_Enumerate_CommonPost(state);
 
@@ -318,10 +425,56 @@ TransList Trans_Enumerate_Public(::HIR::Crate& crate)
             ++ it;
         }
     }
+    Trans_Enumerate_ReportCounts(rv);
     return rv;
 }
 
 
+namespace {
+    void Trans_Enumerate_SaveCode_Fcn(::HIR::Function& fcn, bool all)
+    {
+        if( all || fcn.m_inline == ::HIR::Function::InlineHint::Hint || fcn.m_inline == ::HIR::Function::InlineHint::Always )
+            fcn.m_save_code = true;
+    }
+    void Trans_Enumerate_SaveCode_Mod(::HIR::Module& mod, bool all)
+    {
+        for(auto& vi : mod.m_value_items)
+        {
+            if( auto* e = vi.second->ent.opt_Function() )
+                Trans_Enumerate_SaveCode_Fcn(*e, all);
+        }
+        for(auto& ti : mod.m_mod_items)
+        {
+            if( auto* e = ti.second->ent.opt_Module() )
+                Trans_Enumerate_SaveCode_Mod(*e, all);
+        }
+    }
+}
+/// Flag function MIR to be saved
+/// - `all`: Every function (MIR-only libraries, and libraries used by whole-program executables)
+/// - Otherwise only `#[inline]` functions (crates using them emit a local copy)
+void Trans_Enumerate_SaveCode(::HIR::Crate& crate, bool all)
+{
+    Trans_Enumerate_SaveCode_Mod(crate.m_root_module, all);
+    for(auto& impl : crate.m_trait_impls)
+    {
+        for(auto& m : impl.second.m_methods)
+            Trans_Enumerate_SaveCode_Fcn(m.second.data, all);
+    }
+    for(auto& impl : crate.m_type_impls)
+    {
+        for(auto& m : impl.m_methods)
+            Trans_Enumerate_SaveCode_Fcn(m.second.data, all);
+    }
+}
+
+/// Mark a library crate as MIR-only (no codegen, every function's MIR is saved for the crates that use it)
+void Trans_SetMirOnly(::HIR::Crate& crate)
+{
+    Trans_Enumerate_SaveCode(crate, true);
+    crate.m_is_mir_only = true;
+}
+
 /// Common post-processing
 void Trans_Enumerate_CommonPost_Run(EnumState& state)
 {
@@ -333,7 +486,7 @@ void Trans_Enumerate_CommonPost_Run(EnumState& state)
 
         TRACE_FUNCTION_F("Function " << ::std::find_if(state.rv.m_functions.begin(), state.rv.m_functions.end(), [&](const auto&x){ return x.second.get() == &fcn_out; })->first);
 
-        Trans_Enumerate_FillFrom(state, *fcn_out.ptr, fcn_out.pp);
+        Trans_Enumerate_FillFrom(state, fcn_out);
     }
 }
 TransList Trans_Enumerate_CommonPost(EnumState& state)
@@ -343,6 +496,17 @@ TransList Trans_Enumerate_CommonPost(EnumState& state)
 
     return mv$(state.rv);
 }
+void Trans_Enumerate_ReportCounts(const TransList& list)
+{
+    ::std::cout << "Trans Enumerate: "
+        << list.m_functions.size() << " functions, "
+        << list.m_statics.size() << " statics, "
+        << list.m_vtables.size() << " vtables, "
+        << list.m_types.size() << " types, "
+        << list.m_typeids.size() << " type ids, "
+        << list.m_constructors.size() << " constructors"
+        << ::std::endl;
+}
 
 namespace {
     struct PtrComp
@@ -357,7 +521,7 @@ namespace {
         ::StaticTraitResolve    m_resolve;
         ::std::vector< ::std::pair< ::HIR::TypeRef, bool> >& out_list;
 
-        ::std::map< ::HIR::TypeRef, bool > visited;
+        ::std::unordered_map< ::HIR::TypeRef, bool, Trans_KeyHash, Trans_KeyEq > visited;
         ::std::set< const ::HIR::TypeRef*, PtrComp> active_set;
 
         TypeVisitor(const ::HIR::Crate& crate, ::std::vector< ::std::pair< ::HIR::TypeRef, bool > >& out_list):
@@ -636,7 +800,7 @@ void Trans_Enumerate_Types(EnumState& state)
             for(const auto& arg : fcn.m_args)
                 tv.visit_type( monomorph(arg.second) );
 
-            if( fcn.m_code.m_mir )
+            if( p->emit_code )
             {
                 const auto& mir = *fcn.m_code.m_mir;
                 for(const auto& ty : mir.locals)
@@ -972,8 +1136,9 @@ void Trans_Enumerate_Types(EnumState& state)
         }
         state.fcns_to_type_visit.clear();
         // TODO: Similarly restrict revisiting of statics.
-        for(const auto& ent : state.rv.m_statics)
+        for(const auto* ent_p : TransList::sorted(state.rv.m_statics))
         {
+            const auto& ent = *ent_p;
             TRACE_FUNCTION_F("Enumerate static " << ent.first);
             assert(ent.second->ptr);
             const auto& stat = *ent.second->ptr;
@@ -981,8 +1146,9 @@ void Trans_Enumerate_Types(EnumState& state)
 
             tv.visit_type( pp.monomorph(tv.m_resolve, stat.m_type) );
         }
-        for(const auto& ent : state.rv.m_vtables)
+        for(const auto* ent_p : TransList::sorted(state.rv.m_vtables))
         {
+            const auto& ent = *ent_p;
             TRACE_FUNCTION_F("vtable " << ent.first);
             const auto& gpath = ent.first.m_data.as_UfcsKnown().trait;
             const auto& trait = state.crate.get_trait_by_path(sp, gpath.m_path);
@@ -1611,13 +1777,19 @@ namespace {
     }
 }
 
-void Trans_Enumerate_FillFrom(EnumState& state, const ::HIR::Function& function, const Trans_Params& pp)
+void Trans_Enumerate_FillFrom(EnumState& state, const TransList_Function& fcn_out)
 {
+    const auto& function = *fcn_out.ptr;
+    const auto& pp = fcn_out.pp;
     TRACE_FUNCTION_F("Function pp=" << pp.pp_method<<"+"<<pp.pp_impl);
-    if( function.m_code.m_mir )
+    if( fcn_out.emit_code )
     {
         Trans_Enumerate_FillFrom_MIR(state, *function.m_code.m_mir, pp);
     }
+    else if( function.m_code.m_mir )
+    {
+        // Defined in another crate's object, which also has everything it uses
+    }
     else
     {
         if( function.m_linkage.name != "" )
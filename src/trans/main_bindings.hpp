@@ -17,14 +17,20 @@ struct TransOptions
 {
     unsigned int opt_level = 0;
     bool emit_debug_info = false;
+    /// Executables: Code for external functions is generated from their MIR (instead of using the library objects)
+    bool whole_program = false;
+    /// Generated C doesn't include the comments describing the source MIR/types
+    bool compact_c = false;
 
     ::std::vector< ::std::string>   library_search_dirs;
     ::std::vector< ::std::string>   libraries;
 };
 
-extern TransList Trans_Enumerate_Main(const ::HIR::Crate& crate);
+extern TransList Trans_Enumerate_Main(const ::HIR::Crate& crate, bool whole_program);
 extern TransList Trans_Enumerate_Test(const ::HIR::Crate& crate);
-// NOTE: This also sets the saveout flags
-extern TransList Trans_Enumerate_Public(::HIR::Crate& crate);
+// NOTE: This also sets the saveout flags (`save_all_code` saves MIR for every function, for whole-program executables)
+extern TransList Trans_Enumerate_Public(::HIR::Crate& crate, bool save_all_code);
+/// Set the saveout flags for a library that's only emitted as MIR (codegen is left to the executable)
+extern void Trans_SetMirOnly(::HIR::Crate& crate);
 
 extern void Trans_Codegen(const ::std::string& outfile, const TransOptions& opt, const ::HIR::Crate& crate, const TransList& list, bool is_executable);
@@ -9,16 +9,20 @@
 #include <algorithm>
 #include "../expand/cfg.hpp"
 #include <fstream>
+#include <hir_typeck/static.hpp>
+#include <hir_typeck/common.hpp>    // monomorphise_type
 
 TargetArch ARCH_X86_64 = {
     "x86_64",
     64, false,
-    { /*atomic(u8)=*/true, false, true, true,  true }
+    { /*atomic(u8)=*/true, false, true, true,  true },
+    { "fxsr", "sse", "sse2" }
     };
 TargetArch ARCH_X86 = {
     "x86",
     32, false,
-    { /*atomic(u8)=*/true, false, true, false,  true }
+    { /*atomic(u8)=*/true, false, true, false,  true },
+    { "fxsr", "sse", "sse2" }
 };
 TargetSpec  g_target;
 
@@ -103,11 +107,476 @@ void Target_SetCfg(const ::std::string& target_name)
         return false;
         });
     Cfg_SetValueCb("target_feature", [](const ::std::string& s) {
-        return false;
+        return Target_HasFeature(s);
         });
 }
+void Target_SetFeature(const ::std::string& feature_spec)
+{
+    if( feature_spec.size() < 2 || (feature_spec[0] != '+' && feature_spec[0] != '-') )
+    {
+        ::std::cerr << "Invalid target feature '" << feature_spec << "', expected `+feature` or `-feature`" << ::std::endl;
+        exit(1);
+    }
+    auto name = feature_spec.substr(1);
+    if( feature_spec[0] == '+' )
+        g_target.m_arch.m_features.insert(name);
+    else
+        g_target.m_arch.m_features.erase(name);
+}
+bool Target_HasFeature(const ::std::string& name)
+{
+    return g_target.m_arch.m_features.count(name) > 0;
+}
 
-bool Target_GetSizeAndAlignOf(const Span& sp, const ::HIR::TypeRef& ty, size_t& out_size, size_t& out_align)
+namespace
+{
+    size_t align_up(size_t v, size_t align)
+    {
+        return align > 1 ? (v + align - 1) / align * align : v;
+    }
+    size_t pointer_size()
+    {
+        return g_target.m_arch.m_pointer_bits / 8;
+    }
+    /// Largest alignment GCC gives a vector type (`BIGGEST_ALIGNMENT`, which depends on the enabled x86 features)
+    size_t max_vector_align()
+    {
+        if( Target_HasFeature("avx512f") )
+            return 64;
+        if( Target_HasFeature("avx") || Target_HasFeature("avx2") )
+            return 32;
+        return 16;
+    }
+    /// MSVC doesn't support empty structs, codegen adds a padding byte to them
+    size_t fix_empty_size(size_t size)
+    {
+        if( size == 0 && g_target.m_codegen_mode == CodegenMode::Msvc )
+            return 1;
+        return size;
+    }
+
+    /// Returns true if a field declared with this type could be unsized in some instantiation of the struct
+    /// - Such a field has to stay at the end, so the sized and unsized versions of a struct agree on its layout
+    ///   (e.g. `Rc<[T; N]>` being coerced to `Rc<[T]>`)
+    bool field_may_be_unsized(const Span& sp, const ::HIR::GenericParams& params, const ::HIR::TypeRef& ty)
+    {
+        TU_MATCH_DEF( ::HIR::TypeRef::Data, (ty.m_data), (te),
+        (
+            return false;
+            ),
+        (Generic,
+            if( te.binding == 0xFFFF )
+                return true;
+            if( (te.binding >> 8) != 0 || (te.binding & 0xFF) >= params.m_types.size() )
+                return true;
+            return !params.m_types[te.binding & 0xFF].m_is_sized;
+            ),
+        (Path,
+            // A struct is unsized if its tail is (checked with this struct's parameters substituted in)
+            if( !te.binding.is_Struct() || !te.path.m_data.is_Generic() || !monomorphise_type_needed(ty) )
+                return false;
+            const auto& str = *te.binding.as_Struct();
+            const ::HIR::TypeRef* tail_ty = nullptr;
+            TU_MATCHA( (str.m_data), (se),
+            (Unit,
+                ),
+            (Tuple,
+                if( !se.empty() )
+                    tail_ty = &se.back().ent;
+                ),
+            (Named,
+                if( !se.empty() )
+                    tail_ty = &se.back().second.ent;
+                )
+            )
+            if( !tail_ty || !field_may_be_unsized(sp, str.m_params, *tail_ty) )
+                return false;
+            return field_may_be_unsized(sp, params, monomorphise_type(sp, str.m_params, te.path.m_data.as_Generic().m_params, *tail_ty));
+            ),
+        (Primitive,
+            return te == ::HIR::CoreType::Str;
+            ),
+        (Slice,
+            return true;
+            ),
+        (TraitObject,
+            return true;
+            )
+        )
+    }
+
+    /// Lay out a list of fields (in a struct, tuple, or enum variant)
+    /// - `reorder`: Sort fields by decreasing alignment to minimise padding (`repr(Rust)`)
+    /// - `keep_last`: The last field has to stay at the end (it may be unsized)
+    /// - `start_ofs`: Offset of the first field (space used by a header)
+    bool make_fields_repr(const Span& sp, const StaticTraitResolve& resolve, TypeRepr& rv, ::std::vector< ::HIR::TypeRef> field_types, bool reorder, bool keep_last, bool packed, size_t start_ofs=0)
+    {
+        struct Ent {
+            unsigned int    field;
+            size_t  size;
+            size_t  align;
+        };
+        ::std::vector<Ent>  ents;
+        ents.reserve(field_types.size());
+        for(unsigned int i = 0; i < field_types.size(); i ++)
+        {
+            size_t  size, align;
+            if( !Target_GetSizeAndAlignOf(sp, resolve, field_types[i], size, align) )
+                return false;
+            if( size == SIZE_MAX ) {
+                ASSERT_BUG(sp, i == field_types.size() - 1, "Unsized field " << field_types[i] << " isn't the last field");
+                keep_last = true;
+            }
+            ents.push_back(Ent { i, size, packed ? 1 : align });
+        }
+
+        if( reorder && ents.size() > 1 )
+        {
+            auto end = (keep_last ? ents.end() - 1 : ents.end());
+            ::std::stable_sort(ents.begin(), end, [](const Ent& a, const Ent& b){ return a.align > b.align; });
+        }
+
+        rv.fields.resize(field_types.size());
+        rv.field_order.reserve(ents.size());
+        size_t  cur_ofs = start_ofs;
+        for(const auto& e : ents)
+        {
+            cur_ofs = align_up(cur_ofs, e.align);
+            rv.fields[e.field] = TypeRepr::Field { cur_ofs, mv$(field_types[e.field]) };
+            rv.field_order.push_back(e.field);
+            rv.align = ::std::max(rv.align, e.align);
+            if( e.size == SIZE_MAX ) {
+                cur_ofs = SIZE_MAX;
+            }
+            else {
+                cur_ofs += e.size;
+            }
+        }
+        rv.size = (cur_ofs == SIZE_MAX ? SIZE_MAX : fix_empty_size(align_up(cur_ofs, rv.align)));
+        return true;
+    }
+
+    TypeRepr::Niche make_niche(size_t offset, unsigned int size, uint64_t start, uint64_t count)
+    {
+        TypeRepr::Niche rv;
+        rv.offset = offset;
+        rv.size = size;
+        rv.start = start;
+        rv.count = count;
+        return rv;
+    }
+    /// Niche of an explicit enum tag (all values from `first_invalid` up)
+    TypeRepr::Niche make_tag_niche(size_t tag_size, uint64_t first_invalid)
+    {
+        uint64_t    tag_limit = uint64_t(1) << (8 * tag_size);
+        return make_niche(0, static_cast<unsigned int>(tag_size), first_invalid, tag_limit - first_invalid);
+    }
+    /// Find the largest niche in an already laid-out list of fields
+    void find_fields_niche(const Span& sp, const StaticTraitResolve& resolve, TypeRepr& rv)
+    {
+        for(const auto& fld : rv.fields)
+        {
+            TypeRepr::Niche n;
+            if( fld.offset == SIZE_MAX || !Target_GetTypeNiche(sp, resolve, fld.ty, n) )
+                continue ;
+            if( n.count > rv.niche.count )
+            {
+                n.offset += fld.offset;
+                rv.niche = n;
+            }
+        }
+    }
+
+    ::std::unique_ptr<TypeRepr> make_type_repr(const Span& sp, const StaticTraitResolve& resolve, const ::HIR::TypeRef& ty)
+    {
+        auto rv = ::std::unique_ptr<TypeRepr>(new TypeRepr);
+        if( const auto* te = ty.m_data.opt_Tuple() )
+        {
+            ::std::vector< ::HIR::TypeRef>  fields;
+            for(const auto& t : *te)
+                fields.push_back( t.clone() );
+            if( !make_fields_repr(sp, resolve, *rv, mv$(fields), /*reorder=*/true, /*keep_last=*/false, /*packed=*/false) )
+                return nullptr;
+            find_fields_niche(sp, resolve, *rv);
+            return rv;
+        }
+        else if( const auto* te = ty.m_data.opt_Path() )
+        {
+            ASSERT_BUG(sp, te->path.m_data.is_Generic(), "Non-generic path in type layout - " << ty);
+            const auto& pp = te->path.m_data.as_Generic().m_params;
+            auto monomorph = [&](const ::HIR::GenericParams& params_def, const ::HIR::TypeRef& fld_ty) {
+                auto rv = monomorphise_type(sp, params_def, pp, fld_ty);
+                resolve.expand_associated_types(sp, rv);
+                return rv;
+                };
+            TU_MATCHA( (te->binding), (tpb),
+            (Unbound,
+                BUG(sp, "Unbound type path in type layout - " << ty);
+                ),
+            (Opaque,
+                return nullptr;
+                ),
+            (Struct,
+                const auto& str = *tpb;
+                ::std::vector< ::HIR::TypeRef>  fields;
+                const ::HIR::TypeRef*   last_decl_ty = nullptr;
+                TU_MATCHA( (str.m_data), (se),
+                (Unit,
+                    ),
+                (Tuple,
+                    for(const auto& f : se) {
+                        fields.push_back( monomorph(str.m_params, f.ent) );
+                        last_decl_ty = &f.ent;
+                    }
+                    ),
+                (Named,
+                    for(const auto& f : se) {
+                        fields.push_back( monomorph(str.m_params, f.second.ent) );
+                        last_decl_ty = &f.second.ent;
+                    }
+                    )
+                )
+                // Vtables are initialised in declaration order (and start with a fixed header)
+                const auto& lc = te->path.m_data.as_Generic().m_path.m_components.back();
+                bool is_vtable = lc.size() > 7 && lc.compare(lc.size() - 7, 7, "#vtable") == 0;
+                bool reorder = str.m_repr == ::HIR::Struct::Repr::Rust && !is_vtable;
+                bool keep_last = last_decl_ty && field_may_be_unsized(sp, str.m_params, *last_decl_ty);
+                if( is_vtable ) {
+                    // Starts with a `VTABLE_HDR` (size, align, and drop glue pointer)
+                    rv->align = pointer_size();
+                    if( !make_fields_repr(sp, resolve, *rv, mv$(fields), false, false, false, 3 * pointer_size()) )
+                        return nullptr;
+                    return rv;
+                }
+                if( !make_fields_repr(sp, resolve, *rv, mv$(fields), reorder, keep_last, str.m_repr == ::HIR::Struct::Repr::Packed) )
+                    return nullptr;
+                if( str.m_repr == ::HIR::Struct::Repr::Simd )
+                {
+                    if( rv->fields.empty() || !rv->fields[0].ty.m_data.is_Primitive() )
+                        ERROR(sp, E0000, "#[repr(simd)] struct must contain primitives - " << ty);
+                    for(const auto& f : rv->fields)
+                    {
+                        if( f.ty != rv->fields[0].ty )
+                            ERROR(sp, E0000, "#[repr(simd)] struct fields must all have the same type - " << ty);
+                    }
+                    if( (rv->size & (rv->size - 1)) != 0 )
+                        ERROR(sp, E0000, "#[repr(simd)] struct size must be a power of two - " << ty);
+                    // GCC vector types are aligned to their size, up to the largest enabled vector register (MSVC gets a plain struct)
+                    if( Target_GetCurSpec().m_codegen_mode == CodegenMode::Gnu11 )
+                        rv->align = ::std::min(rv->size, max_vector_align());
+                    return rv;
+                }
+                // NOTE: Packed fields may be misaligned, so don't expose their niches
+                if( str.m_repr != ::HIR::Struct::Repr::Packed )
+                {
+                    find_fields_niche(sp, resolve, *rv);
+                    // `NonZero<T>` - The wrapped integer/pointer is never zero
+                    if( rv->niche.count == 0 && rv->fields.size() == 1 && te->path.m_data.as_Generic().m_path == resolve.m_crate.get_lang_item_path_opt("non_zero") )
+                    {
+                        const auto& inner = rv->fields[0].ty;
+                        size_t  size;
+                        if( inner.m_data.is_Pointer() ) {
+                            rv->niche = make_niche(0, pointer_size(), 0, 1);
+                        }
+                        else if( inner.m_data.is_Primitive() && inner.m_data.as_Primitive() != ::HIR::CoreType::F32 && inner.m_data.as_Primitive() != ::HIR::CoreType::F64
+                            && Target_GetSizeOf(sp, resolve, inner, size) && size <= 8 ) {
+                            rv->niche = make_niche(0, static_cast<unsigned int>(size), 0, 1);
+                        }
+                    }
+                }
+                return rv;
+                ),
+            (Union,
+                const auto& unn = *tpb;
+                for(const auto& var : unn.m_variants)
+                {
+                    auto fld_ty = monomorph(unn.m_params, var.second.ent);
+                    size_t  size, align;
+                    if( !Target_GetSizeAndAlignOf(sp, resolve, fld_ty, size, align) )
+                        return nullptr;
+                    rv->field_order.push_back(rv->fields.size());
+                    rv->fields.push_back(TypeRepr::Field { 0, mv$(fld_ty) });
+                    rv->size = ::std::max(rv->size, size);
+                    rv->align = ::std::max(rv->align, align);
+                }
+                rv->size = fix_empty_size(align_up(rv->size, rv->align));
+                return rv;
+                ),
+            (Enum,
+                // NOTE: `CodeGenerator_C::emit_enum` emits the representation chosen here
+                const auto& enm = *tpb;
+                size_t  tag_size = 4;
+                switch(enm.m_repr)
+                {
+                case ::HIR::Enum::Repr::Rust:
+                case ::HIR::Enum::Repr::C:
+                case ::HIR::Enum::Repr::U32:
+                    tag_size = 4;
+                    break;
+                case ::HIR::Enum::Repr::U8:
+                    tag_size = 1;
+                    break;
+                case ::HIR::Enum::Repr::U16:
+                    tag_size = 2;
+                    break;
+                }
+                // - Value-only enums (and non-Rust reprs) are just the tag
+                if( enm.m_repr != ::HIR::Enum::Repr::Rust || ::std::all_of(enm.m_variants.begin(), enm.m_variants.end(), [](const auto& x){return x.second.is_Unit() || x.second.is_Value();}) )
+                {
+                    rv->size = tag_size;
+                    rv->align = tag_size;
+                    if( enm.m_repr == ::HIR::Enum::Repr::Rust && !enm.m_variants.empty() )
+                    {
+                        // Values past the largest discriminant are invalid
+                        uint64_t    max_val = 0;
+                        for(size_t i = 0; i < enm.m_variants.size(); i ++)
+                            max_val = ::std::max<uint64_t>(max_val, enm.get_value(i));
+                        rv->niche = make_tag_niche(tag_size, max_val + 1);
+                    }
+                    return rv;
+                }
+                // - Lay out each variant as a struct of its fields
+                ::std::vector<TypeRepr> var_reprs( enm.m_variants.size() );
+                unsigned int    dataful_variant = ~0u;
+                bool    multiple_dataful = false;
+                for(unsigned int var_idx = 0; var_idx < enm.m_variants.size(); var_idx ++)
+                {
+                    const auto& var = enm.m_variants[var_idx];
+                    ::std::vector< ::HIR::TypeRef>  fields;
+                    TU_MATCHA( (var.second), (ve),
+                    (Unit,
+                        continue ;
+                        ),
+                    (Value,
+                        continue ;
+                        ),
+                    (Tuple,
+                        for(const auto& f : ve)
+                            fields.push_back( monomorph(enm.m_params, f.ent) );
+                        ),
+                    (Struct,
+                        for(const auto& f : ve)
+                            fields.push_back( monomorph(enm.m_params, f.second.ent) );
+                        )
+                    )
+                    auto& var_repr = var_reprs[var_idx];
+                    if( !make_fields_repr(sp, resolve, var_repr, mv$(fields), false, false, false) )
+                        return nullptr;
+                    if( var_repr.size > 0 )
+                    {
+                        multiple_dataful |= (dataful_variant != ~0u);
+                        dataful_variant = var_idx;
+                    }
+                }
+                // - Niche filling: If only one variant has data, store the others as invalid values within that data
+                //   (e.g. `Option<&T>` uses the null pointer, `Option<bool>` uses 2)
+                if( dataful_variant != ~0u && !multiple_dataful )
+                {
+                    auto& var_repr = var_reprs[dataful_variant];
+                    uint64_t    n_dataless = enm.m_variants.size() - 1;
+                    find_fields_niche(sp, resolve, var_repr);
+                    if( var_repr.niche.count >= n_dataless )
+                    {
+                        rv->size = var_repr.size;
+                        rv->align = var_repr.align;
+                        rv->niche_variant = dataful_variant;
+                        rv->enum_niche = var_repr.niche;
+                        rv->enum_niche.count = n_dataless;
+                        // Any unused invalid values are available to an enclosing enum
+                        rv->niche = var_repr.niche;
+                        rv->niche.start += n_dataless;
+                        rv->niche.count -= n_dataless;
+                        return rv;
+                    }
+                }
+                // - Otherwise, a tag followed by a union of the variants
+                size_t  data_size = 0, data_align = 1;
+                for(const auto& var_repr : var_reprs)
+                {
+                    data_size = ::std::max(data_size, var_repr.size);
+                    data_align = ::std::max(data_align, var_repr.align);
+                }
+                rv->align = ::std::max(tag_size, data_align);
+                rv->size = align_up(align_up(tag_size, data_align) + data_size, rv->align);
+                rv->niche = make_tag_niche(tag_size, enm.m_variants.size());
+                return rv;
+                )
+            )
+        }
+        return nullptr;
+    }
+}
+
+const TypeRepr* Target_GetTypeRepr(const Span& sp, const StaticTraitResolve& resolve, const ::HIR::TypeRef& ty)
+{
+    if( !(ty.m_data.is_Tuple() || ty.m_data.is_Path()) )
+        return nullptr;
+    // Generic types have no fixed layout, and the meaning of the generics depends on the context (so can't be cached)
+    if( monomorphise_type_needed(ty) )
+        return nullptr;
+
+    auto it = resolve.m_type_repr_cache.find(ty);
+    if( it != resolve.m_type_repr_cache.end() )
+        return it->second.get();
+
+    auto repr = make_type_repr(sp, resolve, ty);
+    // Failures aren't cached (the type may be known later, e.g. once an opaque type is resolved)
+    if( !repr )
+        return nullptr;
+    // NOTE: Inserted after the layout is built, as that recursively fills the cache
+    auto rv = repr.get();
+    resolve.m_type_repr_cache.insert(::std::make_pair( ty.clone(), mv$(repr) ));
+    return rv;
+}
+
+bool Target_GetTypeNiche(const Span& sp, const StaticTraitResolve& resolve, const ::HIR::TypeRef& ty, TypeRepr::Niche& out_niche)
+{
+    TU_MATCH_DEF( ::HIR::TypeRef::Data, (ty.m_data), (te),
+    (
+        ),
+    (Primitive,
+        switch(te)
+        {
+        case ::HIR::CoreType::Bool:
+            out_niche = make_niche(0, 1, 2, 0x100 - 2);
+            return true;
+        case ::HIR::CoreType::Char:
+            out_niche = make_niche(0, 4, 0x110000, 0x100000000 - 0x110000);
+            return true;
+        default:
+            break;
+        }
+        ),
+    (Borrow,
+        // Never null (for fat pointers, the data pointer is first)
+        out_niche = make_niche(0, pointer_size(), 0, 1);
+        return true;
+        ),
+    (Function,
+        out_niche = make_niche(0, pointer_size(), 0, 1);
+        return true;
+        ),
+    (Path,
+        const auto* repr = Target_GetTypeRepr(sp, resolve, ty);
+        if( repr && repr->niche.count > 0 )
+        {
+            out_niche = repr->niche;
+            return true;
+        }
+        ),
+    (Tuple,
+        const auto* repr = Target_GetTypeRepr(sp, resolve, ty);
+        if( repr && repr->niche.count > 0 )
+        {
+            out_niche = repr->niche;
+            return true;
+        }
+        )
+    )
+    return false;
+}
+
+bool Target_GetSizeAndAlignOf(const Span& sp, const StaticTraitResolve& resolve, const ::HIR::TypeRef& ty, size_t& out_size, size_t& out_align)
 {
     TU_MATCHA( (ty.m_data), (te),
     (Infer,
@@ -115,7 +584,7 @@ bool Target_GetSizeAndAlignOf(const Span& sp, const ::HIR::TypeRef& ty, size_t&
         ),
     (Diverge,
         out_size = 0;
-        out_align = 0;
+        out_align = 1;
         return true;
         ),
     (Primitive,
@@ -146,13 +615,13 @@ bool Target_GetSizeAndAlignOf(const Span& sp, const ::HIR::TypeRef& ty, size_t&
         case ::HIR::CoreType::U128:
         case ::HIR::CoreType::I128:
             out_size = 16;
-            // TODO: If i128 is emulated, this can be 8
-            out_align = 16;
+            // i128 is emulated (as a pair of u64s) when not generating gcc-compatible C
+            out_align = (g_target.m_codegen_mode == CodegenMode::Msvc ? 8 : 16);
             return true;
         case ::HIR::CoreType::Usize:
         case ::HIR::CoreType::Isize:
-            out_size = g_target.m_arch.m_pointer_bits / 8;
-            out_align = g_target.m_arch.m_pointer_bits / 8;
+            out_size = pointer_size();
+            out_align = pointer_size();
             return true;
         case ::HIR::CoreType::F32:
             out_size = 4;
@@ -163,11 +632,18 @@ bool Target_GetSizeAndAlignOf(const Span& sp, const ::HIR::TypeRef& ty, size_t&
             out_align = 8;
             return true;
         case ::HIR::CoreType::Str:
-            BUG(sp, "sizeof on a `str` - unsized");
+            out_size = SIZE_MAX;
+            out_align = 1;
+            return true;
         }
         ),
     (Path,
-        // TODO:
+        if( const auto* repr = Target_GetTypeRepr(sp, resolve, ty) )
+        {
+            out_size = repr->size;
+            out_align = repr->align;
+            return true;
+        }
         return false;
         ),
     (Generic,
@@ -175,65 +651,79 @@ bool Target_GetSizeAndAlignOf(const Span& sp, const ::HIR::TypeRef& ty, size_t&
         return false;
         ),
     (TraitObject,
-        BUG(sp, "sizeof on a trait object - unsized");
+        // Size and alignment come from the vtable
+        out_size = SIZE_MAX;
+        out_align = 0;
+        return true;
         ),
     (ErasedType,
         BUG(sp, "sizeof on an erased type - shouldn't exist");
         ),
     (Array,
-        // TODO: 
         size_t  size;
-        if( !Target_GetSizeAndAlignOf(sp, *te.inner, size,out_align) )
+        if( !Target_GetSizeAndAlignOf(sp, resolve, *te.inner, size,out_align) )
             return false;
-        size *= te.size_val;
+        ASSERT_BUG(sp, size != SIZE_MAX, "Array of unsized type - " << ty);
+        out_size = size * te.size_val;
+        return true;
         ),
     (Slice,
-        BUG(sp, "sizeof on a slice - unsized");
+        if( !Target_GetAlignOf(sp, resolve, *te.inner, out_align) )
+            return false;
+        out_size = SIZE_MAX;
+        return true;
         ),
     (Tuple,
-        out_size = 0;
-        out_align = 0;
-
-        // TODO: Struct reordering
-        for(const auto& t : te)
+        if( te.empty() )
         {
-            size_t  size, align;
-            if( !Target_GetSizeAndAlignOf(sp, t, size,align) )
-                return false;
-            if( out_size % align != 0 )
-            {
-                out_size += align;
-                out_size %= align;
-            }
-            out_size += size;
-            out_align = ::std::max(out_align, align);
+            // `()` is emitted as `tUNIT`
+            out_size = fix_empty_size(0);
+            out_align = 1;
+            return true;
+        }
+        if( const auto* repr = Target_GetTypeRepr(sp, resolve, ty) )
+        {
+            out_size = repr->size;
+            out_align = repr->align;
+            return true;
         }
+        return false;
         ),
     (Borrow,
-        // TODO
+        // Pointers to unsized types carry metadata (a length or a vtable)
+        if( monomorphise_type_needed(*te.inner) )
+            return false;
+        out_size = pointer_size() * (resolve.type_is_sized(sp, *te.inner) ? 1 : 2);
+        out_align = pointer_size();
+        return true;
         ),
     (Pointer,
-        // TODO
+        if( monomorphise_type_needed(*te.inner) )
+            return false;
+        out_size = pointer_size() * (resolve.type_is_sized(sp, *te.inner) ? 1 : 2);
+        out_align = pointer_size();
+        return true;
         ),
     (Function,
         // Pointer size
-        out_size = g_target.m_arch.m_pointer_bits / 8;
-        out_align = g_target.m_arch.m_pointer_bits / 8;
+        out_size = pointer_size();
+        out_align = pointer_size();
         return true;
         ),
     (Closure,
-        // TODO.
+        // Closures are replaced by structs before codegen
+        return false;
         )
     )
     return false;
 }
-bool Target_GetSizeOf(const Span& sp, const ::HIR::TypeRef& ty, size_t& out_size)
+bool Target_GetSizeOf(const Span& sp, const StaticTraitResolve& resolve, const ::HIR::TypeRef& ty, size_t& out_size)
 {
     size_t  ignore_align;
-    return Target_GetSizeAndAlignOf(sp, ty, out_size, ignore_align);
+    return Target_GetSizeAndAlignOf(sp, resolve, ty, out_size, ignore_align);
 }
-bool Target_GetAlignOf(const Span& sp, const ::HIR::TypeRef& ty, size_t& out_align)
+bool Target_GetAlignOf(const Span& sp, const StaticTraitResolve& resolve, const ::HIR::TypeRef& ty, size_t& out_align)
 {
     size_t  ignore_size;
-    return Target_GetSizeAndAlignOf(sp, ty, ignore_size, out_align);
+    return Target_GetSizeAndAlignOf(sp, resolve, ty, ignore_size, out_align);
 }
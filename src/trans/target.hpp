@@ -8,6 +8,8 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>  // SIZE_MAX
+#include <set>
 #include <hir/type.hpp>
 
 enum class CodegenMode
@@ -29,6 +31,9 @@ struct TargetArch
         bool u64;
         bool ptr;
     } m_atomics;
+
+    /// Enabled target features (`cfg(target_feature)`, and `-m<feature>` for the C compiler)
+    ::std::set< ::std::string>  m_features;
 };
 struct TargetSpec
 {
@@ -41,8 +46,60 @@ struct TargetSpec
 };
 
 
+class StaticTraitResolve;
+
+/// Memory layout of a monomorphised composite type (struct, tuple, union, or enum)
+/// - Matches the C emitted by codegen (so `sizeof`/`ALIGNOF` in the output agree with it)
+struct TypeRepr
+{
+    size_t  size = 0;   // `SIZE_MAX` if the type is unsized (ends with a DST)
+    size_t  align = 1;
+
+    struct Field {
+        size_t  offset; // Offset of an unsized tail is the minimum (a trait object tail depends on the vtable's alignment)
+        ::HIR::TypeRef  ty;
+    };
+    /// Fields in declaration order (union variants, empty for enums)
+    ::std::vector<Field>    fields;
+    /// Field indexes in memory order (the order they're emitted in)
+    ::std::vector<unsigned int> field_order;
+
+    /// A range of values an (unsigned integer) part of the type can never hold, usable to store an enclosing enum's tag
+    struct Niche {
+        size_t  offset = 0;
+        unsigned int    size = 0;   // Size of the integer, in bytes
+        uint64_t    start = 0;  // First invalid value
+        uint64_t    count = 0;  // Number of invalid values (zero if there's no niche)
+    };
+    /// Largest niche in the type (still available to an enclosing enum)
+    Niche   niche;
+
+    /// Niche-filled enums: The only variant with a non-zero size (`~0u` if the enum has an explicit tag)
+    /// - The other variants are stored as consecutive invalid values of `enum_niche`
+    unsigned int    niche_variant = ~0u;
+    Niche   enum_niche;
+
+    bool is_niche_enum() const {
+        return niche_variant != ~0u;
+    }
+    /// Value stored in the niche for a dataless variant of a niche-filled enum
+    uint64_t get_niche_value(unsigned int var_idx) const {
+        return enum_niche.start + (var_idx < niche_variant ? var_idx : var_idx - 1);
+    }
+};
+
 extern const TargetSpec& Target_GetCurSpec();
 extern void Target_SetCfg(const ::std::string& target_name);
-extern bool Target_GetSizeOf(const Span& sp, const ::HIR::TypeRef& ty, size_t& out_size);
-extern bool Target_GetAlignOf(const Span& sp, const ::HIR::TypeRef& ty, size_t& out_align);
+/// Enable (`+feature`) or disable (`-feature`) a target feature, after `Target_SetCfg`
+extern void Target_SetFeature(const ::std::string& feature_spec);
+extern bool Target_HasFeature(const ::std::string& name);
+/// Obtain the layout of a tuple or ADT (cached in `resolve`), returns nullptr if it can't be known (e.g. the type is generic)
+extern const TypeRepr* Target_GetTypeRepr(const Span& sp, const StaticTraitResolve& resolve, const ::HIR::TypeRef& ty);
+/// Obtain the largest niche in a type, returns false if it has none (or the type isn't known)
+extern bool Target_GetTypeNiche(const Span& sp, const StaticTraitResolve& resolve, const ::HIR::TypeRef& ty, TypeRepr::Niche& out_niche);
+/// Obtain the size and alignment of a type, returns false if it can't be known
+/// - Unsized types have a size of `SIZE_MAX` (and an alignment of zero if that's not known until runtime)
+extern bool Target_GetSizeAndAlignOf(const Span& sp, const StaticTraitResolve& resolve, const ::HIR::TypeRef& ty, size_t& out_size, size_t& out_align);
+extern bool Target_GetSizeOf(const Span& sp, const StaticTraitResolve& resolve, const ::HIR::TypeRef& ty, size_t& out_size);
+extern bool Target_GetAlignOf(const Span& sp, const StaticTraitResolve& resolve, const ::HIR::TypeRef& ty, size_t& out_align);
 
@@ -8,6 +8,113 @@
 #include "trans_list.hpp"
 #include <hir_typeck/static.hpp>    // StaticTraitResolve
 
+namespace {
+    void hash_combine(size_t& h, size_t v)
+    {
+        h ^= v + 0x9e3779b9 + (h << 6) + (h >> 2);
+    }
+    void hash_params(size_t& h, const ::HIR::PathParams& pp)
+    {
+        hash_combine(h, pp.m_types.size());
+        for(const auto& ty : pp.m_types)
+            hash_combine(h, Trans_KeyHash()(ty));
+    }
+}
+
+size_t Trans_KeyHash::operator()(const ::HIR::GenericPath& x) const
+{
+    size_t  h = ::std::hash< ::std::string>()(x.m_path.m_crate_name);
+    for(const auto& c : x.m_path.m_components)
+        hash_combine(h, ::std::hash< ::std::string>()(c));
+    hash_params(h, x.m_params);
+    return h;
+}
+size_t Trans_KeyHash::operator()(const ::HIR::Path& x) const
+{
+    size_t  h = static_cast<size_t>(x.m_data.tag());
+    TU_MATCHA( (x.m_data), (pe),
+    (Generic,
+        hash_combine(h, (*this)(pe));
+        ),
+    (UfcsInherent,
+        hash_combine(h, (*this)(*pe.type));
+        hash_combine(h, ::std::hash< ::std::string>()(pe.item));
+        hash_params(h, pe.params);
+        ),
+    (UfcsKnown,
+        hash_combine(h, (*this)(*pe.type));
+        hash_combine(h, (*this)(pe.trait));
+        hash_combine(h, ::std::hash< ::std::string>()(pe.item));
+        hash_params(h, pe.params);
+        ),
+    (UfcsUnknown,
+        hash_combine(h, (*this)(*pe.type));
+        hash_combine(h, ::std::hash< ::std::string>()(pe.item));
+        hash_params(h, pe.params);
+        )
+    )
+    return h;
+}
+// NOTE: Only hashes (a subset of) the fields that `TypeRef::ord` compares
+size_t Trans_KeyHash::operator()(const ::HIR::TypeRef& x) const
+{
+    size_t  h = static_cast<size_t>(x.m_data.tag());
+    TU_MATCHA( (x.m_data), (te),
+    (Infer,
+        hash_combine(h, te.index);
+        ),
+    (Diverge,
+        ),
+    (Primitive,
+        hash_combine(h, static_cast<size_t>(te));
+        ),
+    (Path,
+        hash_combine(h, (*this)(te.path));
+        ),
+    (Generic,
+        hash_combine(h, te.binding);
+        ),
+    (TraitObject,
+        hash_combine(h, (*this)(te.m_trait.m_path));
+        hash_combine(h, te.m_markers.size());
+        ),
+    (ErasedType,
+        hash_combine(h, (*this)(te.m_origin));
+        ),
+    (Array,
+        hash_combine(h, (*this)(*te.inner));
+        hash_combine(h, te.size_val);
+        ),
+    (Slice,
+        hash_combine(h, (*this)(*te.inner));
+        ),
+    (Tuple,
+        hash_combine(h, te.size());
+        for(const auto& ty : te)
+            hash_combine(h, (*this)(ty));
+        ),
+    (Borrow,
+        hash_combine(h, static_cast<size_t>(te.type));
+        hash_combine(h, (*this)(*te.inner));
+        ),
+    (Pointer,
+        hash_combine(h, static_cast<size_t>(te.type));
+        hash_combine(h, (*this)(*te.inner));
+        ),
+    (Function,
+        hash_combine(h, te.is_unsafe);
+        hash_combine(h, ::std::hash< ::std::string>()(te.m_abi));
+        for(const auto& ty : te.m_arg_types)
+            hash_combine(h, (*this)(ty));
+        hash_combine(h, (*this)(*te.m_rettype));
+        ),
+    (Closure,
+        hash_combine(h, reinterpret_cast< ::std::uintptr_t>(te.node));
+        )
+    )
+    return h;
+}
+
 TransList_Function* TransList::add_function(::HIR::Path p)
 {
     auto rv = m_functions.insert( ::std::make_pair(mv$(p), nullptr) );
@@ -39,14 +146,14 @@ TransList_Static* TransList::add_static(::HIR::Path p)
     }
 }
 
-t_cb_generic Trans_Params::get_cb() const
+::std::function<const ::HIR::TypeRef&(const ::HIR::TypeRef&)> Trans_Params::get_cb() const
 {
     return monomorphise_type_get_cb(sp, &self_type, &pp_impl, &pp_method);
 }
 ::HIR::Path Trans_Params::monomorph(const ::StaticTraitResolve& resolve, const ::HIR::Path& p) const
 {
     TRACE_FUNCTION_F(p);
-    auto rv = monomorphise_path_with(sp, p, this->get_cb(), false);
+    auto rv = monomorphise_path_needed(p) ? monomorphise_path_with(sp, p, this->get_cb(), false) : p.clone();
 
     TU_MATCH(::HIR::Path::Data, (rv.m_data), (e2),
     (Generic,
@@ -90,7 +197,7 @@ t_cb_generic Trans_Params::get_cb() const
 
 ::HIR::TypeRef Trans_Params::monomorph(const ::StaticTraitResolve& resolve, const ::HIR::TypeRef& ty) const
 {
-    auto rv = monomorphise_type_with(sp, ty, this->get_cb(), false);
+    auto rv = monomorphise_type_needed(ty) ? monomorphise_type_with(sp, ty, this->get_cb(), false) : ty.clone();
     resolve.expand_associated_types(sp, rv);
     return rv;
 }
@@ -10,6 +10,9 @@
 #include <hir/type.hpp>
 #include <hir/path.hpp>
 #include <hir_typeck/common.hpp>
+#include <unordered_map>
+#include <unordered_set>
+#include <algorithm>
 
 class StaticTraitResolve;
 namespace HIR {
@@ -30,7 +33,7 @@ struct Trans_Params
         sp(sp)
     {}
 
-    t_cb_generic get_cb() const;
+    ::std::function<const ::HIR::TypeRef&(const ::HIR::TypeRef&)> get_cb() const;
     ::HIR::TypeRef monomorph(const ::StaticTraitResolve& resolve, const ::HIR::TypeRef& p) const;
     ::HIR::Path monomorph(const ::StaticTraitResolve& resolve, const ::HIR::Path& p) const;
     ::HIR::GenericPath monomorph(const ::StaticTraitResolve& resolve, const ::HIR::GenericPath& p) const;
@@ -41,10 +44,26 @@ struct Trans_Params
     }
 };
 
+/// Hashing for the keys of the trans item tables (monomorphised paths and types)
+/// - Consistent with `ord`, i.e. keys that compare equal have the same hash
+struct Trans_KeyHash
+{
+    size_t operator()(const ::HIR::TypeRef& x) const;
+    size_t operator()(const ::HIR::GenericPath& x) const;
+    size_t operator()(const ::HIR::Path& x) const;
+};
+struct Trans_KeyEq
+{
+    template<typename T>
+    bool operator()(const T& a, const T& b) const { return a.ord(b) == OrdEqual; }
+};
+
 struct TransList_Function
 {
     const ::HIR::Function*  ptr;
     Trans_Params    pp;
+    /// Code is generated from the MIR (otherwise the definition is in another object, e.g. a library's)
+    bool    emit_code = false;
 };
 struct TransList_Static
 {
@@ -54,14 +73,24 @@ struct TransList_Static
 
 class TransList
 {
+    template<typename K, typename V>
+    using t_map = ::std::unordered_map<K, V, Trans_KeyHash, Trans_KeyEq>;
+    template<typename K>
+    using t_set = ::std::unordered_set<K, Trans_KeyHash, Trans_KeyEq>;
+
+    template<typename K, typename V>
+    static const K& get_key(const ::std::pair<const K, V>& e) { return e.first; }
+    template<typename K>
+    static const K& get_key(const K& e) { return e; }
 public:
-    ::std::map< ::HIR::Path, ::std::unique_ptr<TransList_Function> > m_functions;
-    ::std::map< ::HIR::Path, ::std::unique_ptr<TransList_Static> > m_statics;
-    ::std::map< ::HIR::Path, Trans_Params> m_vtables;
+    // NOTE: These are hashed for fast lookup during enumeration, use `sorted` to iterate in a deterministic order
+    t_map< ::HIR::Path, ::std::unique_ptr<TransList_Function> > m_functions;
+    t_map< ::HIR::Path, ::std::unique_ptr<TransList_Static> > m_statics;
+    t_map< ::HIR::Path, Trans_Params> m_vtables;
     /// Required type_id values
-    ::std::set< ::HIR::TypeRef> m_typeids;
+    t_set< ::HIR::TypeRef> m_typeids;
     /// Required struct/enum constructor impls
-    ::std::set< ::HIR::GenericPath> m_constructors;
+    t_set< ::HIR::GenericPath> m_constructors;
 
     // .second is `true` if this is a from a reference to the type
     ::std::vector< ::std::pair<::HIR::TypeRef, bool> >  m_types;
@@ -71,5 +100,16 @@ public:
     bool add_vtable(::HIR::Path p, Trans_Params pp) {
         return m_vtables.insert( ::std::make_pair( mv$(p), mv$(pp) ) ).second;
     }
+
+    /// Returns pointers to the entries of one of the above tables, sorted by key
+    template<typename C>
+    static ::std::vector<const typename C::value_type*> sorted(const C& c) {
+        ::std::vector<const typename C::value_type*>    rv;
+        rv.reserve(c.size());
+        for(const auto& e : c)
+            rv.push_back(&e);
+        ::std::sort(rv.begin(), rv.end(), [](const auto* a, const auto* b){ return get_key(*a) < get_key(*b); });
+        return rv;
+    }
 };
 